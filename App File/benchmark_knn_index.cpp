@@ -0,0 +1,73 @@
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+#include <opencv2/opencv.hpp>
+
+#include "imgs/statistics/data_readers/DataReaders.h"
+#include "imgs/statistics/classifiers/Classifiers.h"
+
+int main() {
+  statistics::PackedDataset training_images = statistics::ReadMnistDataset(
+      "../data/images/misc/final/train-images-28-ubyte",
+      "../data/images/misc/final/train-labels-28-ubyte");
+  std::cout << training_images.size() << " our training images read"
+            << std::endl;
+
+  statistics::PackedDataset test_images = statistics::ReadMnistDataset(
+      "../data/images/misc/final/test-images-28-ubyte",
+      "../data/images/misc/final/test-labels-28-ubyte");
+  std::cout << test_images.size() << " our test images read" << std::endl;
+
+  int k = 3;
+  using Clock = std::chrono::steady_clock;
+  auto seconds = [](Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+  };
+
+  for (double p : {1.0, 2.0, 3.0}) {
+    auto start = Clock::now();
+    auto linear_labels = statistics::Knn(test_images, training_images, k, p);
+    double linear_time = seconds(start);
+
+    // The same scan over cache-sized tiles of the training set, one block
+    // of test images at a time
+    statistics::KnnOptions tiled_options;
+    tiled_options.tiled = true;
+    start = Clock::now();
+    auto tiled_labels =
+        statistics::Knn(test_images, training_images, k, p, tiled_options);
+    double tiled_time = seconds(start);
+
+    start = Clock::now();
+    statistics::VpTree index(training_images, p);
+    double build_time = seconds(start);
+
+    statistics::KnnStatistics knn_statistics;
+    statistics::KnnOptions options;
+    options.statistics = &knn_statistics;
+    start = Clock::now();
+    auto index_labels = statistics::Knn(test_images, index, k, options);
+    double index_time = seconds(start);
+
+    std::cout << std::endl;
+    std::cout << "Minkowski distance of order " << p << ", k = " << k
+              << std::endl;
+    std::cout << "  linear scan:       " << linear_time << " s" << std::endl;
+    std::cout << "  tiled scan:        " << tiled_time << " s ("
+              << linear_time / tiled_time << "x speedup, labels "
+              << (tiled_labels == linear_labels ? "identical" : "DIFFER")
+              << ")" << std::endl;
+    std::cout << "  index build:       " << build_time << " s, "
+              << index.MemoryBytes() / 1024.0 << " KiB" << std::endl;
+    std::cout << "  index queries:     " << index_time << " s ("
+              << linear_time / index_time << "x speedup)" << std::endl;
+    std::cout << "  distances skipped: "
+              << 100.0 * knn_statistics.skipped / knn_statistics.candidates
+              << "%" << std::endl;
+    std::cout << "  labels identical:  "
+              << (index_labels == linear_labels ? "yes" : "NO") << std::endl;
+  }
+
+  exit(EXIT_SUCCESS);
+}
@@ -0,0 +1,79 @@
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <opencv2/opencv.hpp>
+
+#include "imgs/statistics/data_readers/DataReaders.h"
+#include "imgs/statistics/classifiers/Classifiers.h"
+
+// Build a k-NN model file from IDX training files, so that classifiers
+// map it at startup instead of parsing and packing the training set (and
+// building the indexes) on every run.
+//
+// Usage: build_knn_model [model [train-images train-labels [index...]]]
+// where each index is one of "vptree", "hnsw" or "pca" (none by default;
+// defaults to our plate character set)
+int main(int argc, char* argv[]) {
+  std::string directory = "../data/images/misc/final/";
+  std::string model_filename = directory + "knn-model.bin";
+  std::string train_images_filename = directory + "train-images-28-ubyte";
+  std::string train_labels_filename = directory + "train-labels-28-ubyte";
+  if (argc == 3) {
+    std::cerr << "Usage: " << argv[0]
+              << " [model [train-images train-labels [vptree|hnsw|pca]...]]"
+              << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  if (argc >= 2) {
+    model_filename = argv[1];
+  }
+  if (argc >= 4) {
+    train_images_filename = argv[2];
+    train_labels_filename = argv[3];
+  }
+
+  using Clock = std::chrono::steady_clock;
+  auto seconds = [](Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+  };
+
+  auto start = Clock::now();
+  statistics::KnnModel model;
+  model.training_images = statistics::ReadMnistDataset(train_images_filename,
+                                                       train_labels_filename);
+  std::cout << model.training_images.size() << " training images read in "
+            << seconds(start) << " s" << std::endl;
+
+  double p = 2;
+  for (int arg = 4; arg < argc; ++arg) {
+    const std::string index = argv[arg];
+    start = Clock::now();
+    if (index == "vptree") {
+      model.vp_tree = statistics::VpTree(model.training_images, p);
+    } else if (index == "hnsw") {
+      model.hnsw = statistics::HnswIndex(model.training_images, p);
+    } else if (index == "pca") {
+      model.projection = statistics::PcaProjection(model.training_images);
+    } else {
+      std::cerr << "Unknown index: " << index << std::endl;
+      exit(EXIT_FAILURE);
+    }
+    std::cout << index << " built in " << seconds(start) << " s"
+              << std::endl;
+  }
+
+  if (!statistics::WriteKnnModel(model_filename, model)) {
+    exit(EXIT_FAILURE);
+  }
+  std::cout << "Model written to " << model_filename << std::endl;
+
+  start = Clock::now();
+  statistics::KnnModel mapped = statistics::ReadKnnModel(model_filename);
+  std::cout << "Model mapped back in " << seconds(start) << " s"
+            << std::endl;
+
+  exit(EXIT_SUCCESS);
+}
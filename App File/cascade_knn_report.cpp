@@ -0,0 +1,108 @@
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <opencv2/opencv.hpp>
+
+#include "imgs/statistics/data_readers/DataReaders.h"
+#include "imgs/statistics/classifiers/Classifiers.h"
+
+// Speedup and agreement of the coarse-to-fine cascade (7 x 7 and 14 x 14
+// shortlists re-ranked at full resolution) against the exact packed
+// classifier, for a few shortlist lengths.
+//
+// Usage: cascade_knn_report [k p [train-images train-labels test-images
+//                           test-labels]]
+// (defaults to k = 2, p = 3 on our plate character set)
+int main(int argc, char* argv[]) {
+  std::string directory = "../data/images/misc/final/";
+  std::string train_images_filename = directory + "train-images-28-ubyte";
+  std::string train_labels_filename = directory + "train-labels-28-ubyte";
+  std::string test_images_filename = directory + "test-images-28-ubyte";
+  std::string test_labels_filename = directory + "test-labels-28-ubyte";
+  int k = 2;
+  double p = 3;
+  if (argc == 3 || argc == 7) {
+    k = std::atoi(argv[1]);
+    p = std::atof(argv[2]);
+  }
+  if (argc == 7) {
+    train_images_filename = argv[3];
+    train_labels_filename = argv[4];
+    test_images_filename = argv[5];
+    test_labels_filename = argv[6];
+  } else if (argc != 1 && argc != 3) {
+    std::cerr << "Usage: " << argv[0]
+              << " [k p [train-images train-labels test-images test-labels]]"
+              << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  statistics::PackedDataset training_images = statistics::ReadMnistDataset(
+      train_images_filename, train_labels_filename);
+  std::cout << training_images.size() << " training images read"
+            << std::endl;
+  statistics::PackedDataset test_images = statistics::ReadMnistDataset(
+      test_images_filename, test_labels_filename);
+  std::cout << test_images.size() << " test images read" << std::endl;
+
+  using Clock = std::chrono::steady_clock;
+  auto seconds = [](Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+  };
+  auto accuracy = [&](const std::vector<unsigned char>& labels) {
+    std::size_t correct = 0;
+    for (std::size_t t = 0; t < labels.size(); ++t) {
+      correct += (labels[t] == test_images.label(t));
+    }
+    return 100.0 * correct / labels.size();
+  };
+  std::cout << std::endl
+            << "k = " << k << ", Minkowski distance of order " << p
+            << std::endl;
+
+  // The exact baseline, with the pruned search
+  statistics::KnnOptions options;
+  options.prune = true;
+  auto start = Clock::now();
+  auto exact_labels = statistics::Knn(test_images, training_images, k, p,
+                                      options);
+  double exact_time = seconds(start);
+  std::cout << "  exact (pruned): " << accuracy(exact_labels) << "% accuracy, "
+            << exact_labels.size() / exact_time << " images/s" << std::endl;
+
+  for (int factor : {4, 2}) {
+    statistics::CascadeParameters parameters;
+    parameters.factor = factor;
+    start = Clock::now();
+    statistics::CascadeIndex index(training_images, p, parameters);
+    std::cout << "  " << index.coarse_rows() << " x " << index.coarse_cols()
+              << " coarse characters (built in " << seconds(start) << " s, "
+              << index.MemoryBytes() / 1024 << " KiB)" << std::endl;
+
+    for (std::size_t shortlist : {10, 25, 50, 100, 200}) {
+      index.set_shortlist(shortlist);
+      statistics::KnnStatistics counts;
+      statistics::KnnOptions cascade_options;
+      cascade_options.statistics = &counts;
+      start = Clock::now();
+      auto labels = statistics::Knn(test_images, index, k, cascade_options);
+      double cascade_time = seconds(start);
+
+      std::size_t agreement = 0;
+      for (std::size_t t = 0; t < labels.size(); ++t) {
+        agreement += (labels[t] == exact_labels[t]);
+      }
+      std::cout << "    shortlist " << shortlist << ": " << accuracy(labels)
+                << "% accuracy, " << 100.0 * agreement / labels.size()
+                << "% agreement with exact, " << labels.size() / cascade_time
+                << " images/s (" << exact_time / cascade_time << "x), "
+                << static_cast<double>(counts.completed) / labels.size()
+                << " full-resolution distances per image" << std::endl;
+    }
+  }
+
+  exit(EXIT_SUCCESS);
+}
@@ -1,3 +1,4 @@
+#include <fstream>
 #include <iostream>
 #include <vector>
 
@@ -8,34 +9,47 @@
 #include "imgs/statistics/evaluators/Evaluators.h"
 
 int main() {
-  std::vector<unsigned char> training_labels = statistics::ReadMnistLabels(
-      "../data/images/misc/final/train-labels-28-ubyte");
-  std::cout << training_labels.size() << " our training labels read"
-            << std::endl;
-
-  std::vector<cv::Mat> training_images = statistics::ReadMnistImages(
-      "../data/images/misc/final/train-images-28-ubyte");
-  std::cout << training_images.size() << " our training images read"
-            << std::endl;
+  // Map the prebuilt model (see build_knn_model) when there is one, and
+  // otherwise read the training set
+  const std::string model_filename = "../data/images/misc/final/knn-model.bin";
+  statistics::PackedDataset training_images;
+  if (std::ifstream(model_filename).good()) {
+    training_images = statistics::ReadKnnModel(model_filename).training_images;
+    std::cout << training_images.size() << " our training images mapped"
+              << std::endl;
+  } else {
+    training_images = statistics::ReadMnistDataset(
+        "../data/images/misc/final/train-images-28-ubyte",
+        "../data/images/misc/final/train-labels-28-ubyte");
+    std::cout << training_images.size() << " our training images read"
+              << std::endl;
+  }
 
-  std::vector<unsigned char> test_labels = statistics::ReadMnistLabels(
+  statistics::PackedDataset test_images = statistics::ReadMnistDataset(
+      "../data/images/misc/final/test-images-28-ubyte",
       "../data/images/misc/final/test-labels-28-ubyte");
-  std::cout << test_labels.size() << " our test labels read" << std::endl;
-
-  std::vector<cv::Mat> test_images = statistics::ReadMnistImages(
-      "../data/images/misc/final/test-images-28-ubyte");
+  std::vector<unsigned char> test_labels = test_images.LabelVector();
   std::cout << test_images.size() << " our test images read" << std::endl;
 
   int k = 3;
   double p = 2;
   unsigned char ascii_offset_for_labels = 48;
+  statistics::KnnStatistics knn_statistics;
+  statistics::KnnOptions options;
+  options.prune = true;
+  options.statistics = &knn_statistics;
   auto predicted_test_labels =
-      statistics::Knn(test_images, training_images, training_labels, k, p);
+      statistics::Knn(test_images, training_images, k, p, options);
 
   if (predicted_test_labels.size()) {
     std::cout << std::endl;
     std::cout << "For a k-NN classifier using " << k << " neighbors ";
     std::cout << "and a Minkowski distance of order " << p << std::endl;
+    std::cout << "(" << 100 * knn_statistics.PruningRate() << "% of the "
+              << knn_statistics.candidates << " distances pruned: "
+              << knn_statistics.skipped << " skipped, "
+              << knn_statistics.rejected << " rejected by bounds, "
+              << knn_statistics.abandoned << " abandoned early)" << std::endl;
     statistics::ConfusionMatrix(test_labels, predicted_test_labels,
                                 ascii_offset_for_labels);
   }
@@ -0,0 +1,118 @@
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include <opencv2/opencv.hpp>
+
+#include "imgs/statistics/data_readers/DataReaders.h"
+
+// Writes an IDX image and label file pair as run-length compressed
+// containers, and compares the file sizes and the load throughput of the
+// compressed files against the raw files, read with a stream and through
+// a memory mapping.
+//
+// Usage: compressed_idx_report [images labels [chunk-images]]
+// (defaults to our plate character training set in chunks of 1024 images;
+// the containers are written next to the files, with a .rle suffix)
+int main(int argc, char* argv[]) {
+  std::string directory = "../data/images/misc/final/";
+  std::string images_filename = directory + "train-images-28-ubyte";
+  std::string labels_filename = directory + "train-labels-28-ubyte";
+  std::size_t chunk_images = statistics::kCompressedChunkItems;
+  if (argc == 3 || argc == 4) {
+    images_filename = argv[1];
+    labels_filename = argv[2];
+  }
+  if (argc == 4) {
+    chunk_images = std::strtoul(argv[3], nullptr, 10);
+  } else if (argc != 1 && argc != 3) {
+    std::cerr << "Usage: " << argv[0] << " [images labels [chunk-images]]"
+              << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  const std::string compressed_images_filename = images_filename + ".rle";
+  const std::string compressed_labels_filename = labels_filename + ".rle";
+
+  statistics::PackedDataset dataset =
+      statistics::ReadMnistDataset(images_filename, labels_filename);
+  if (!statistics::WriteCompressedMnistDataset(
+          compressed_images_filename, compressed_labels_filename, dataset,
+          chunk_images)) {
+    exit(EXIT_FAILURE);
+  }
+
+  using Clock = std::chrono::steady_clock;
+  auto seconds = [](Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+  };
+  auto file_bytes = [](const std::string& filename) {
+    std::ifstream file(filename, std::ios::binary | std::ios::ate);
+    return static_cast<double>(file.tellg());
+  };
+  const double raw_bytes =
+      file_bytes(images_filename) + file_bytes(labels_filename);
+  const double compressed_bytes = file_bytes(compressed_images_filename) +
+                                  file_bytes(compressed_labels_filename);
+  const double pixel_bytes =
+      static_cast<double>(dataset.size()) * dataset.dimension();
+  std::cout << dataset.size() << " images: " << raw_bytes / 1e6
+            << " MB raw, " << compressed_bytes / 1e6 << " MB compressed ("
+            << raw_bytes / compressed_bytes << "x)" << std::endl;
+
+  // Throughput in MB of decoded pixels per second, best of a few loads
+  auto report = [&](const std::string& name, auto load) {
+    double best = 0;
+    for (int repeat = 0; repeat < 5; ++repeat) {
+      auto start = Clock::now();
+      load();
+      const double elapsed = seconds(start);
+      best = (repeat == 0) ? elapsed : std::min(best, elapsed);
+    }
+    std::cout << "  " << name << ": " << 1e3 * best << " ms, "
+              << pixel_bytes / best / 1e6 << " MB/s" << std::endl;
+  };
+
+  std::cout << "Load into a packed data set (with its statistics):"
+            << std::endl;
+  report("raw, stream", [&] {
+    std::ifstream file(images_filename, std::ios::binary);
+    file.seekg(16);
+    statistics::PackedDataset packed(dataset.size(), dataset.rows(),
+                                     dataset.cols());
+    for (std::size_t i = 0; i < packed.size(); ++i) {
+      file.read(reinterpret_cast<char*>(packed.ptr(i)), packed.dimension());
+    }
+    std::ifstream labels(labels_filename, std::ios::binary);
+    labels.seekg(8);
+    labels.read(reinterpret_cast<char*>(packed.labels()), packed.size());
+    packed.ComputeStatistics();
+  });
+  report("raw, mapped", [&] {
+    statistics::ReadMnistDataset(images_filename, labels_filename);
+  });
+  report("compressed", [&] {
+    statistics::ReadMnistDataset(compressed_images_filename,
+                                 compressed_labels_filename);
+  });
+
+  std::cout << "Pixels only:" << std::endl;
+  report("raw, mapped and touched", [&] {
+    statistics::MappedIdxFile images(images_filename, 3);
+    std::size_t sum = 0;
+    for (std::size_t offset = 0; offset < pixel_bytes; offset += 4096) {
+      sum += images.data()[offset];
+    }
+    volatile std::size_t keep = sum;
+    (void)keep;
+  });
+  report("compressed, decoded", [&] {
+    statistics::CompressedIdxFile images(compressed_images_filename, 3);
+    std::vector<unsigned char> pixels(images.size() * images.item_bytes());
+    images.Decode(pixels.data(), images.item_bytes());
+  });
+
+  exit(EXIT_SUCCESS);
+}
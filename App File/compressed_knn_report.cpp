@@ -0,0 +1,95 @@
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <opencv2/opencv.hpp>
+
+#include "imgs/statistics/data_readers/DataReaders.h"
+#include "imgs/statistics/classifiers/Classifiers.h"
+
+// Memory, accuracy and throughput of the compressed training stores (4-bit
+// nibbles and product quantization) against the uint8 packed baseline.
+//
+// Usage: compressed_knn_report [train-images train-labels test-images
+//                               test-labels]
+// (defaults to our plate character set)
+int main(int argc, char* argv[]) {
+  std::string directory = "../data/images/misc/final/";
+  std::string train_images_filename = directory + "train-images-28-ubyte";
+  std::string train_labels_filename = directory + "train-labels-28-ubyte";
+  std::string test_images_filename = directory + "test-images-28-ubyte";
+  std::string test_labels_filename = directory + "test-labels-28-ubyte";
+  if (argc == 5) {
+    train_images_filename = argv[1];
+    train_labels_filename = argv[2];
+    test_images_filename = argv[3];
+    test_labels_filename = argv[4];
+  } else if (argc != 1) {
+    std::cerr << "Usage: " << argv[0]
+              << " [train-images train-labels test-images test-labels]"
+              << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  statistics::PackedDataset training_images = statistics::ReadMnistDataset(
+      train_images_filename, train_labels_filename);
+  std::cout << training_images.size() << " training images read"
+            << std::endl;
+  statistics::PackedDataset test_images = statistics::ReadMnistDataset(
+      test_images_filename, test_labels_filename);
+  std::cout << test_images.size() << " test images read" << std::endl;
+
+  int k = 3;
+  double p = 2;
+  using Clock = std::chrono::steady_clock;
+  auto seconds = [](Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+  };
+  auto report = [&](const std::string& name, std::size_t bytes,
+                    double build_time, double classify_time,
+                    const std::vector<unsigned char>& labels) {
+    std::size_t correct = 0;
+    for (std::size_t t = 0; t < labels.size(); ++t) {
+      correct += (labels[t] == test_images.label(t));
+    }
+    std::cout << name << bytes / (1024.0 * 1024.0) << " MiB, built in "
+              << build_time << " s, " << 100.0 * correct / labels.size()
+              << "% accuracy, " << labels.size() / classify_time
+              << " images/s" << std::endl;
+  };
+  std::cout << std::endl
+            << "k = " << k << ", Minkowski distance of order " << p
+            << std::endl;
+
+  auto start = Clock::now();
+  auto baseline_labels = statistics::Knn(test_images, training_images, k, p);
+  report("  uint8 packed:          ",
+         training_images.size() * training_images.stride(), 0,
+         seconds(start), baseline_labels);
+
+  start = Clock::now();
+  statistics::NibbleDataset training_nibbles =
+      statistics::PackNibbles(training_images);
+  statistics::NibbleDataset test_nibbles = statistics::PackNibbles(test_images);
+  double build_time = seconds(start);
+  start = Clock::now();
+  auto nibble_labels = statistics::Knn(test_nibbles, training_nibbles, k, p);
+  report("  4-bit nibbles:         ", training_nibbles.MemoryBytes(),
+         build_time, seconds(start), nibble_labels);
+
+  for (int subspaces : {196, 98, 49}) {
+    statistics::PqParameters parameters;
+    parameters.subspaces = subspaces;
+    start = Clock::now();
+    statistics::ProductQuantizer quantizer(training_images, parameters);
+    build_time = seconds(start);
+    start = Clock::now();
+    auto pq_labels = statistics::Knn(test_images, quantizer, k, p);
+    report("  product quantized (" + std::to_string(subspaces) + "): ",
+           quantizer.MemoryBytes(), build_time, seconds(start), pq_labels);
+  }
+
+  exit(EXIT_SUCCESS);
+}
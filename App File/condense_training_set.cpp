@@ -0,0 +1,120 @@
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <opencv2/opencv.hpp>
+
+#include "imgs/statistics/data_readers/DataReaders.h"
+#include "imgs/statistics/classifiers/Classifiers.h"
+#include "imgs/statistics/evaluators/Evaluators.h"
+
+// Reduce a labeled training set to fewer prototypes (Wilson editing, then
+// Hart's condensed nearest neighbor, then an optional cap on the images of
+// any one class), write the prototypes as IDX image and label files, and
+// report the shrink ratio and the test accuracy before and after.
+//
+// Usage: condense_training_set [class-cap [train-images train-labels
+//                               test-images test-labels output-images
+//                               output-labels]]
+// (a class cap of 0 keeps every condensed image; defaults to our plate
+// character set)
+int main(int argc, char* argv[]) {
+  std::string directory = "../data/images/misc/final/";
+  std::string train_images_filename = directory + "train-images-28-ubyte";
+  std::string train_labels_filename = directory + "train-labels-28-ubyte";
+  std::string test_images_filename = directory + "test-images-28-ubyte";
+  std::string test_labels_filename = directory + "test-labels-28-ubyte";
+  std::string output_images_filename =
+      directory + "condensed-train-images-28-ubyte";
+  std::string output_labels_filename =
+      directory + "condensed-train-labels-28-ubyte";
+  std::size_t class_cap = 0;
+  if (argc == 2 || argc == 8) {
+    class_cap = std::strtoul(argv[1], nullptr, 10);
+  }
+  if (argc == 8) {
+    train_images_filename = argv[2];
+    train_labels_filename = argv[3];
+    test_images_filename = argv[4];
+    test_labels_filename = argv[5];
+    output_images_filename = argv[6];
+    output_labels_filename = argv[7];
+  } else if (argc != 1 && argc != 2) {
+    std::cerr << "Usage: " << argv[0]
+              << " [class-cap [train-images train-labels test-images"
+              << " test-labels output-images output-labels]]" << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  statistics::PackedDataset training_images = statistics::ReadMnistDataset(
+      train_images_filename, train_labels_filename);
+  std::cout << training_images.size() << " training images read"
+            << std::endl;
+  statistics::PackedDataset test_images = statistics::ReadMnistDataset(
+      test_images_filename, test_labels_filename);
+  std::vector<unsigned char> test_labels = test_images.LabelVector();
+  std::cout << test_images.size() << " test images read" << std::endl;
+
+  int k = 3;
+  double p = 2;
+  unsigned char ascii_offset_for_labels = 48;
+  using Clock = std::chrono::steady_clock;
+  auto seconds = [](Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+  };
+
+  // Condense
+  auto start = Clock::now();
+  std::vector<std::size_t> edited =
+      statistics::WilsonEdit(training_images, k, p);
+  std::cout << std::endl
+            << "Wilson editing (k = " << k << "): " << edited.size()
+            << " images kept" << std::endl;
+  std::vector<std::size_t> condensed =
+      statistics::HartCondense(training_images, edited, p);
+  std::cout << "Hart condensing: " << condensed.size() << " images kept"
+            << std::endl;
+  std::vector<std::size_t> prototypes =
+      statistics::CapPerClass(training_images, condensed, class_cap);
+  if (class_cap > 0) {
+    std::cout << "Cap of " << class_cap << " per class: "
+              << prototypes.size() << " images kept" << std::endl;
+  }
+  std::cout << "Shrink ratio " << static_cast<double>(training_images.size()) /
+                                      prototypes.size()
+            << " (" << seconds(start) << " s)" << std::endl;
+
+  statistics::PackedDataset prototype_images =
+      statistics::SelectImages(training_images, prototypes);
+  if (!statistics::WriteMnistDataset(output_images_filename,
+                                     output_labels_filename,
+                                     prototype_images)) {
+    exit(EXIT_FAILURE);
+  }
+  std::cout << "Prototypes written to " << output_images_filename << " and "
+            << output_labels_filename << std::endl;
+
+  // Classify with the full and with the condensed training set
+  statistics::KnnOptions options;
+  options.prune = true;
+  for (const auto* training : {&training_images, &prototype_images}) {
+    start = Clock::now();
+    auto predicted_test_labels =
+        statistics::Knn(test_images, *training, k, p, options);
+    double classify_time = seconds(start);
+    if (predicted_test_labels.empty()) {
+      continue;
+    }
+    std::cout << std::endl
+              << "For a k-NN classifier using " << k << " neighbors and "
+              << training->size() << " training images ("
+              << predicted_test_labels.size() / classify_time
+              << " images/s)" << std::endl;
+    statistics::ConfusionMatrix(test_labels, predicted_test_labels,
+                                ascii_offset_for_labels);
+  }
+
+  exit(EXIT_SUCCESS);
+}
@@ -0,0 +1,72 @@
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include <opencv2/opencv.hpp>
+
+#include "imgs/statistics/data_readers/DataReaders.h"
+#include "imgs/statistics/classifiers/Classifiers.h"
+#include "imgs/statistics/evaluators/Evaluators.h"
+
+// Stratified k-fold cross-validation of the k-NN classifier over one
+// labeled IDX data set, with the folds classified in parallel: the
+// accuracy of every fold, their mean and standard deviation, and the
+// confusion matrix merged over all of the folds.
+//
+// Usage: cross_validate_knn [folds k p [images labels]]
+// (defaults to 10 folds of k = 2, p = 3 over our plate character training
+// set)
+int main(int argc, char* argv[]) {
+  std::string directory = "../data/images/misc/final/";
+  std::string images_filename = directory + "train-images-28-ubyte";
+  std::string labels_filename = directory + "train-labels-28-ubyte";
+  int number_folds = 10;
+  int k = 2;
+  double p = 3;
+  if (argc == 4 || argc == 6) {
+    number_folds = std::atoi(argv[1]);
+    k = std::atoi(argv[2]);
+    p = std::atof(argv[3]);
+  }
+  if (argc == 6) {
+    images_filename = argv[4];
+    labels_filename = argv[5];
+  } else if (argc != 1 && argc != 4) {
+    std::cerr << "Usage: " << argv[0] << " [folds k p [images labels]]"
+              << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  statistics::PackedDataset dataset =
+      statistics::ReadMnistDataset(images_filename, labels_filename);
+  std::cout << dataset.size() << " images read" << std::endl;
+
+  statistics::KnnOptions options;
+  options.number_threads = 0;
+  options.prune = true;
+  statistics::CrossValidationResult result =
+      statistics::CrossValidateKnn(dataset, number_folds, k, p, options);
+  if (result.empty()) {
+    exit(EXIT_FAILURE);
+  }
+
+  std::cout << std::endl
+            << number_folds << "-fold cross-validation, k = " << k
+            << ", Minkowski distance of order " << p << std::endl;
+  for (std::size_t f = 0; f < result.fold_accuracies.size(); ++f) {
+    std::cout << "  fold " << f << ": " << 100 * result.fold_accuracies[f]
+              << "%" << std::endl;
+  }
+  std::cout << "Accuracy = " << 100 * result.mean_accuracy << "% +/- "
+            << 100 * std::sqrt(result.accuracy_variance)
+            << "% (folds packed in " << result.pack_seconds
+            << " s, classified in " << result.classify_seconds << " s)"
+            << std::endl
+            << std::endl;
+
+  // Our character labels are enumerated from '0'
+  statistics::PrintConfusionMatrix(result.confusion, 48);
+
+  exit(EXIT_SUCCESS);
+}
@@ -0,0 +1,118 @@
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <opencv2/opencv.hpp>
+
+#include "imgs/statistics/data_readers/DataReaders.h"
+#include "imgs/statistics/classifiers/Classifiers.h"
+#include "imgs/statistics/classifiers/MinkowskiKernels.h"
+#include "imgs/statistics/classifiers/TopK.h"
+
+// Recall of the approximate HNSW search against the exact brute-force k-NN.
+//
+// Usage: hnsw_recall [train-images train-labels test-images test-labels]
+// (defaults to our plate character set; pass the MNIST files to report on
+// MNIST instead)
+int main(int argc, char* argv[]) {
+  std::string directory = "../data/images/misc/final/";
+  std::string train_images_filename = directory + "train-images-28-ubyte";
+  std::string train_labels_filename = directory + "train-labels-28-ubyte";
+  std::string test_images_filename = directory + "test-images-28-ubyte";
+  std::string test_labels_filename = directory + "test-labels-28-ubyte";
+  if (argc == 5) {
+    train_images_filename = argv[1];
+    train_labels_filename = argv[2];
+    test_images_filename = argv[3];
+    test_labels_filename = argv[4];
+  } else if (argc != 1) {
+    std::cerr << "Usage: " << argv[0]
+              << " [train-images train-labels test-images test-labels]"
+              << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  statistics::PackedDataset training_images = statistics::ReadMnistDataset(
+      train_images_filename, train_labels_filename);
+  std::cout << training_images.size() << " training images read"
+            << std::endl;
+  statistics::PackedDataset test_images = statistics::ReadMnistDataset(
+      test_images_filename, test_labels_filename);
+  std::cout << test_images.size() << " test images read" << std::endl;
+
+  int k = 3;
+  double p = 2;
+  using Clock = std::chrono::steady_clock;
+  auto seconds = [](Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+  };
+
+  // Exact neighbors and labels from the linear scan
+  auto start = Clock::now();
+  auto exact_labels = statistics::Knn(test_images, training_images, k, p);
+  double exact_time = seconds(start);
+
+  statistics::MinkowskiKernel kernel(p, training_images.rows(),
+                                     training_images.cols());
+  std::vector<statistics::TopK> exact_neighbors(test_images.size(),
+                                                statistics::TopK(k));
+  for (std::size_t t = 0; t < test_images.size(); ++t) {
+    for (std::size_t i = 0; i < training_images.size(); ++i) {
+      exact_neighbors[t].Push(
+          kernel.PowerSum(test_images.ptr(t), training_images.ptr(i),
+                          training_images.dimension()),
+          i);
+    }
+  }
+
+  for (int m : {8, 16, 32}) {
+    statistics::HnswParameters parameters;
+    parameters.m = m;
+    start = Clock::now();
+    statistics::HnswIndex index(training_images, p, parameters);
+    double build_time = seconds(start);
+
+    std::cout << std::endl;
+    std::cout << "M = " << m << ", efConstruction = "
+              << parameters.ef_construction << ": built in " << build_time
+              << " s, " << index.MemoryBytes() / 1024.0 << " KiB"
+              << std::endl;
+    std::cout << "  efSearch   recall@" << k
+              << "   label agreement   accuracy   speedup" << std::endl;
+
+    for (int ef_search : {8, 16, 32, 64, 128, 256}) {
+      index.set_ef_search(ef_search);
+      start = Clock::now();
+      auto labels = statistics::Knn(test_images, index, k);
+      double search_time = seconds(start);
+
+      std::size_t found = 0;
+      std::size_t agreeing = 0;
+      std::size_t correct = 0;
+      statistics::TopK neighbors(k);
+      statistics::KnnStatistics knn_statistics;
+      for (std::size_t t = 0; t < test_images.size(); ++t) {
+        neighbors.Clear();
+        index.Nearest(test_images.ptr(t), neighbors, knn_statistics);
+        for (const auto& neighbor : neighbors) {
+          for (const auto& exact : exact_neighbors[t]) {
+            found += (neighbor.index == exact.index);
+          }
+        }
+        agreeing += (labels[t] == exact_labels[t]);
+        correct += (labels[t] == test_images.label(t));
+      }
+
+      double number_tests = static_cast<double>(test_images.size());
+      std::cout << "  " << ef_search << "\t     "
+                << found / (k * number_tests) << "\t  "
+                << agreeing / number_tests << "\t\t    "
+                << correct / number_tests << "\t"
+                << exact_time / search_time << "x" << std::endl;
+    }
+  }
+
+  exit(EXIT_SUCCESS);
+}
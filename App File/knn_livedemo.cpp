@@ -16,6 +16,7 @@
 
 
 #include "knn_functions.h"
+#include "imgs/statistics/data_readers/ImageDirectoryLoader.h"
 #include <filesystem>
 #include <iostream>
 #include <vector>
@@ -34,49 +35,31 @@ int main() {
   string licensePlatesPath     = "../imgs/statistics/labeling/license_plates";
   string labeledCharactersPath = "../imgs/statistics/labeling/labeled_characters";
 
-    // #######################################
-    // %% Read in RGB Images from Directory %%
-    // #######################################
+    // ######################################
+    // %% Stream RGB Images from Directory %%
+    // ######################################
 
+    // Each file is decoded once, in parallel, and the gray plate derived
+    // from its color image
     string plate_directory = "../imgs/statistics/labeling/carl_plate";
-    std::vector<cv::Mat> license_plates;
-    std::vector<cv::Mat> color_plates;
-    std::vector<std::string> image_filenames;
-
-    // Iterate through all files in the folder
-    for (const auto& entry : fs::directory_iterator(plate_directory)) {
-        if (entry.is_regular_file()) {
-            std::string file_path = entry.path().string();
-
-            // Attempt to load the image
-            cv::Mat img = cv::imread(file_path, cv::IMREAD_GRAYSCALE);
-            cv::Mat img_color = cv::imread(file_path, cv::IMREAD_COLOR);
-
-            if (!img.empty()) {
-                license_plates.push_back(img);
-                color_plates.push_back(img_color);
-                image_filenames.push_back(file_path);
-                std::cout << "Loaded: " << file_path << std::endl;
-            } else {
-                std::cerr << "Failed to load: " << file_path << std::endl;
-            }
-        }
-    }
+    statistics::ImageDirectoryLoader loader(plate_directory, true);
+    statistics::LoadedImage loaded;
 
 
     // ########################
     // %% Show auto contours %%
     // ########################
 
-    for (size_t i = 0; i < license_plates.size(); ++i) {
-        cout << "Current plate #: " << i << endl;
+    while (loader.Next(loaded)) {
+        std::cout << "Loaded: " << loaded.filename << std::endl;
+        cout << "Current plate #: " << loaded.index << endl;
 
         // Rectangles to draw bounding boxes
         vector<cv::Rect> rectangles;
 
         // Segment out characters to labeled
-        cv::Mat plate = license_plates[i];
-        cv::Mat plate_color = color_plates[i];
+        cv::Mat plate = loaded.gray;
+        cv::Mat plate_color = loaded.color;
         vector<cv::Mat> segmented_characters = AutoExtractCharacters(plate, rectangles);
 
         // Display the character image
@@ -0,0 +1,120 @@
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <opencv2/opencv.hpp>
+
+#include "imgs/statistics/data_readers/DataReaders.h"
+#include "imgs/statistics/classifiers/Classifiers.h"
+
+namespace fs = std::filesystem;
+
+// Grows a fitted k-NN classifier with the characters labeled by
+// label_plates (PlateLabel<c>_<i><j>.png), one Insert() at a time, and
+// compares the test accuracy and the cost of an insertion against fitting
+// the grown training set from scratch.
+//
+// Usage: knn_online_update [k p [labeled-directory]]
+// (defaults to k = 2, p = 3 with our plate character set and the
+// characters labeled so far)
+int main(int argc, char* argv[]) {
+  std::string directory = "../data/images/misc/final/";
+  std::string labeled_directory =
+      "../imgs/statistics/labeling/labeled_characters";
+  int k = 2;
+  double p = 3;
+  if (argc == 3 || argc == 4) {
+    k = std::atoi(argv[1]);
+    p = std::atof(argv[2]);
+  }
+  if (argc == 4) {
+    labeled_directory = argv[3];
+  } else if (argc != 1 && argc != 3) {
+    std::cerr << "Usage: " << argv[0] << " [k p [labeled-directory]]"
+              << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  statistics::PackedDataset training_images = statistics::ReadMnistDataset(
+      directory + "train-images-28-ubyte", directory + "train-labels-28-ubyte");
+  std::cout << training_images.size() << " training images read"
+            << std::endl;
+  statistics::PackedDataset test_images = statistics::ReadMnistDataset(
+      directory + "test-images-28-ubyte", directory + "test-labels-28-ubyte");
+  std::cout << test_images.size() << " test images read" << std::endl;
+
+  using Clock = std::chrono::steady_clock;
+  auto seconds = [](Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+  };
+  auto accuracy = [&](const std::vector<unsigned char>& labels) {
+    std::size_t correct = 0;
+    for (std::size_t t = 0; t < labels.size(); ++t) {
+      correct += (labels[t] == test_images.label(t));
+    }
+    return 100.0 * correct / labels.size();
+  };
+
+  statistics::KnnOptions options;
+  options.number_threads = 0;
+  options.prune = true;
+  statistics::KnnClassifier classifier(k, p, options);
+  auto start = Clock::now();
+  if (!classifier.Fit(training_images)) {
+    exit(EXIT_FAILURE);
+  }
+  const double fit_seconds = seconds(start);
+  std::cout << "Fitted in " << 1e3 * fit_seconds << " ms, accuracy = "
+            << accuracy(classifier.PredictBatch(test_images)) << "%"
+            << std::endl;
+
+  // Resize every labeled character to the training geometry and add it
+  std::size_t number_inserted = 0;
+  double insert_seconds = 0;
+  for (const auto& entry : fs::directory_iterator(labeled_directory)) {
+    const std::string filename = entry.path().filename().string();
+    if (!entry.is_regular_file() || filename.rfind("PlateLabel", 0) != 0 ||
+        filename.size() <= 10) {
+      continue;
+    }
+    const int label = statistics::CharacterLabel(filename[10]);
+    cv::Mat character =
+        cv::imread(entry.path().string(), cv::IMREAD_GRAYSCALE);
+    if (label < 0 || character.empty()) {
+      std::cerr << "Skipping " << filename << std::endl;
+      continue;
+    }
+    cv::resize(character, character,
+               cv::Size(training_images.cols(), training_images.rows()), 0,
+               0, cv::INTER_AREA);
+
+    start = Clock::now();
+    if (classifier.Insert(character, static_cast<unsigned char>(label))) {
+      ++number_inserted;
+    }
+    insert_seconds += seconds(start);
+  }
+  if (number_inserted == 0) {
+    std::cout << "No labeled characters found in " << labeled_directory
+              << std::endl;
+    exit(EXIT_SUCCESS);
+  }
+  std::cout << number_inserted << " labeled characters inserted, "
+            << 1e6 * insert_seconds / number_inserted
+            << " us per insertion, accuracy = "
+            << accuracy(classifier.PredictBatch(test_images)) << "%"
+            << std::endl;
+
+  // The same training set fitted from scratch
+  statistics::KnnClassifier refitted(k, p, options);
+  start = Clock::now();
+  refitted.Fit(classifier.training_images());
+  std::cout << "Refitting the " << classifier.training_images().size()
+            << " images takes " << 1e3 * seconds(start) << " ms"
+            << std::endl;
+
+  exit(EXIT_SUCCESS);
+}
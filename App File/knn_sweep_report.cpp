@@ -0,0 +1,91 @@
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <opencv2/opencv.hpp>
+
+#include "imgs/statistics/data_readers/DataReaders.h"
+#include "imgs/statistics/classifiers/Classifiers.h"
+
+// Accuracy and runtime of k-NN for every k up to k_max and a range of
+// Minkowski orders, from one shared distance pass over the test set (see
+// KnnSweep.h), and the best (k, p) pair found.
+//
+// Usage: knn_sweep_report [k-max [train-images train-labels test-images
+//                         test-labels]]
+// (defaults to k up to 10 on our plate character set)
+int main(int argc, char* argv[]) {
+  std::string directory = "../data/images/misc/final/";
+  std::string train_images_filename = directory + "train-images-28-ubyte";
+  std::string train_labels_filename = directory + "train-labels-28-ubyte";
+  std::string test_images_filename = directory + "test-images-28-ubyte";
+  std::string test_labels_filename = directory + "test-labels-28-ubyte";
+  int k_max = 10;
+  if (argc >= 2) {
+    k_max = std::atoi(argv[1]);
+  }
+  if (argc == 6) {
+    train_images_filename = argv[2];
+    train_labels_filename = argv[3];
+    test_images_filename = argv[4];
+    test_labels_filename = argv[5];
+  } else if (argc != 1 && argc != 2) {
+    std::cerr << "Usage: " << argv[0]
+              << " [k-max [train-images train-labels test-images "
+              << "test-labels]]" << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  statistics::PackedDataset training_images = statistics::ReadMnistDataset(
+      train_images_filename, train_labels_filename);
+  std::cout << training_images.size() << " training images read"
+            << std::endl;
+  statistics::PackedDataset test_images = statistics::ReadMnistDataset(
+      test_images_filename, test_labels_filename);
+  std::cout << test_images.size() << " test images read" << std::endl;
+
+  std::vector<double> orders = {1, 1.5, 2, 2.5, 3, 4, 5};
+  statistics::KnnSweep sweep =
+      statistics::SweepKnn(test_images, training_images, k_max, orders);
+  if (sweep.empty()) {
+    exit(EXIT_FAILURE);
+  }
+
+  auto print_grid = [&](const std::string& title,
+                        const std::vector<std::vector<double>>& grid,
+                        const double scale) {
+    std::cout << std::endl << title << std::endl << "     p";
+    for (const int k : sweep.ks) {
+      std::cout << std::setw(9) << ("k=" + std::to_string(k));
+    }
+    std::cout << std::endl;
+    for (std::size_t o = 0; o < sweep.orders.size(); ++o) {
+      std::cout << std::setw(6) << sweep.orders[o];
+      for (const double value : grid[o]) {
+        std::cout << std::setw(9) << std::fixed << std::setprecision(2)
+                  << scale * value;
+      }
+      std::cout << std::defaultfloat << std::endl;
+    }
+  };
+  print_grid("Accuracy (%)", sweep.accuracy, 100);
+  print_grid("Runtime (s)", sweep.seconds, 1);
+
+  std::size_t best_order = 0;
+  std::size_t best_k = 0;
+  sweep.Best(best_order, best_k);
+  std::cout << std::endl
+            << "Best: k = " << sweep.ks[best_k]
+            << ", p = " << sweep.orders[best_order] << " ("
+            << 100 * sweep.accuracy[best_order][best_k] << "% accuracy)"
+            << std::endl;
+  std::cout << "Sweep of " << sweep.orders.size() * sweep.ks.size()
+            << " (k, p) pairs: " << sweep.distance_seconds
+            << " s of distances, " << sweep.vote_seconds << " s of votes, "
+            << 100.0 * sweep.abandoned / sweep.pairs
+            << "% of image pairs abandoned early" << std::endl;
+
+  exit(EXIT_SUCCESS);
+}
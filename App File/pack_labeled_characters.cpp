@@ -0,0 +1,117 @@
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <opencv2/opencv.hpp>
+
+#include "imgs/statistics/data_readers/DataReaders.h"
+
+// Rebuilds our plate character training and test sets from the characters
+// labeled with label_plates (PlateLabel<c>_<i><j>.png): decodes them in
+// parallel into 28 x 28 images, enumerates their characters the way the
+// confusion matrix prints them (from '0'), splits every character's
+// images between the training and test sets in the same proportion, and
+// writes the four IDX files that classify_final_with_knn reads.
+//
+// Usage: pack_labeled_characters [--force] output-directory
+//                                [labeled-directory [test-fraction]]
+// (defaults to the characters labeled so far, with a fifth of each
+// character held out for testing; existing IDX files in the output
+// directory, e.g. our committed plate character set, are only replaced
+// with --force)
+int main(int argc, char* argv[]) {
+  bool force = false;
+  std::vector<std::string> arguments;
+  for (int i = 1; i < argc; ++i) {
+    if (std::string(argv[i]) == "--force") {
+      force = true;
+    } else {
+      arguments.push_back(argv[i]);
+    }
+  }
+  if (arguments.empty() || arguments.size() > 3) {
+    std::cerr << "Usage: " << argv[0]
+              << " [--force] output-directory [labeled-directory "
+              << "[test-fraction]]" << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  const std::string directory = arguments[0] + "/";
+  std::string labeled_directory =
+      "../imgs/statistics/labeling/labeled_characters";
+  double test_fraction = 0.2;
+  if (arguments.size() > 1) {
+    labeled_directory = arguments[1];
+  }
+  if (arguments.size() > 2) {
+    test_fraction = std::atof(arguments[2].c_str());
+  }
+
+  const std::string filenames[] = {
+      directory + "train-images-28-ubyte", directory + "train-labels-28-ubyte",
+      directory + "test-images-28-ubyte", directory + "test-labels-28-ubyte"};
+  if (!force) {
+    for (const auto& filename : filenames) {
+      if (std::filesystem::exists(filename)) {
+        std::cerr << filename << " already exists (use --force to replace it)"
+                  << std::endl;
+        exit(EXIT_FAILURE);
+      }
+    }
+  }
+
+  using Clock = std::chrono::steady_clock;
+  auto seconds = [](Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+  };
+
+  auto start = Clock::now();
+  statistics::PackedDataset characters =
+      statistics::ReadLabeledCharacters(labeled_directory);
+  if (characters.empty()) {
+    std::cerr << "No labeled characters found in " << labeled_directory
+              << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  std::cout << characters.size() << " labeled characters decoded in "
+            << seconds(start) << " s" << std::endl;
+
+  statistics::PackedDataset training_images;
+  statistics::PackedDataset test_images;
+  if (!statistics::StratifiedSplit(characters, test_fraction, training_images,
+                                   test_images)) {
+    exit(EXIT_FAILURE);
+  }
+
+  // The number of images of every character in each set
+  int training_counts[256] = {0};
+  int test_counts[256] = {0};
+  for (std::size_t i = 0; i < training_images.size(); ++i) {
+    ++training_counts[training_images.label(i)];
+  }
+  for (std::size_t i = 0; i < test_images.size(); ++i) {
+    ++test_counts[test_images.label(i)];
+  }
+  for (int label = 0; label < 36; ++label) {
+    if (training_counts[label] + test_counts[label] > 0) {
+      std::cout << "  " << statistics::LabelCharacter(label) << ": "
+                << training_counts[label] << " training, "
+                << test_counts[label] << " test" << std::endl;
+    }
+  }
+
+  start = Clock::now();
+  if (!statistics::WriteMnistDataset(filenames[0], filenames[1],
+                                     training_images) ||
+      !statistics::WriteMnistDataset(filenames[2], filenames[3],
+                                     test_images)) {
+    exit(EXIT_FAILURE);
+  }
+  std::cout << training_images.size() << " training and "
+            << test_images.size() << " test images written to " << directory
+            << " in " << seconds(start) << " s" << std::endl;
+
+  exit(EXIT_SUCCESS);
+}
@@ -0,0 +1,113 @@
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <opencv2/opencv.hpp>
+
+#include "imgs/statistics/data_readers/DataReaders.h"
+#include "imgs/statistics/classifiers/Classifiers.h"
+
+// Accuracy and throughput of k-NN in principal component spaces of a few
+// sizes, with and without the exact pixel-space re-rank, against the packed
+// pixel-space baseline.  The projection is written next to the model and
+// read back before classifying, as a deployed classifier would.
+//
+// Usage: pca_knn_report [train-images train-labels test-images
+//                        test-labels]
+// (defaults to our plate character set)
+int main(int argc, char* argv[]) {
+  std::string directory = "../data/images/misc/final/";
+  std::string train_images_filename = directory + "train-images-28-ubyte";
+  std::string train_labels_filename = directory + "train-labels-28-ubyte";
+  std::string test_images_filename = directory + "test-images-28-ubyte";
+  std::string test_labels_filename = directory + "test-labels-28-ubyte";
+  if (argc == 5) {
+    train_images_filename = argv[1];
+    train_labels_filename = argv[2];
+    test_images_filename = argv[3];
+    test_labels_filename = argv[4];
+  } else if (argc != 1) {
+    std::cerr << "Usage: " << argv[0]
+              << " [train-images train-labels test-images test-labels]"
+              << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  statistics::PackedDataset training_images = statistics::ReadMnistDataset(
+      train_images_filename, train_labels_filename);
+  std::cout << training_images.size() << " training images read"
+            << std::endl;
+  statistics::PackedDataset test_images = statistics::ReadMnistDataset(
+      test_images_filename, test_labels_filename);
+  std::cout << test_images.size() << " test images read" << std::endl;
+
+  int k = 3;
+  double p = 2;
+  using Clock = std::chrono::steady_clock;
+  auto seconds = [](Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+  };
+  auto accuracy = [&](const std::vector<unsigned char>& labels) {
+    std::size_t correct = 0;
+    for (std::size_t t = 0; t < labels.size(); ++t) {
+      correct += (labels[t] == test_images.label(t));
+    }
+    return 100.0 * correct / labels.size();
+  };
+  std::cout << std::endl
+            << "k = " << k << ", Minkowski distance of order " << p
+            << std::endl;
+
+  auto start = Clock::now();
+  auto baseline_labels = statistics::Knn(test_images, training_images, k, p);
+  double baseline_time = seconds(start);
+  std::cout << "  pixels (" << training_images.dimension()
+            << " dimensions): " << accuracy(baseline_labels)
+            << "% accuracy, " << baseline_labels.size() / baseline_time
+            << " images/s" << std::endl;
+
+  std::string projection_filename = "pca_projection.bin";
+  for (int components : {16, 32, 50, 78}) {
+    statistics::PcaParameters parameters;
+    parameters.components = components;
+    start = Clock::now();
+    statistics::PcaProjection learned(training_images, parameters);
+    double fit_time = seconds(start);
+    if (!statistics::WritePcaProjection(projection_filename, learned)) {
+      exit(EXIT_FAILURE);
+    }
+    statistics::PcaProjection projection =
+        statistics::ReadPcaProjection(projection_filename);
+    std::cout << "  PCA " << projection.components() << " components ("
+              << 100 * projection.ExplainedVariance()
+              << "% of the variance, fit in " << fit_time << " s, "
+              << static_cast<double>(training_images.dimension()) /
+                     projection.components()
+              << "x fewer products per distance)" << std::endl;
+
+    for (std::size_t rerank : {0, 10, 50}) {
+      statistics::PcaIndex index(training_images, projection, p, rerank);
+      statistics::KnnStatistics counts;
+      statistics::KnnOptions options;
+      options.statistics = &counts;
+      start = Clock::now();
+      auto labels = statistics::Knn(test_images, index, k, options);
+      double classify_time = seconds(start);
+
+      std::size_t agreement = 0;
+      for (std::size_t t = 0; t < labels.size(); ++t) {
+        agreement += (labels[t] == baseline_labels[t]);
+      }
+      std::cout << "    re-rank " << rerank << ": " << accuracy(labels)
+                << "% accuracy, " << 100.0 * agreement / labels.size()
+                << "% agreement with pixels, " << labels.size() / classify_time
+                << " images/s (" << baseline_time / classify_time << "x), "
+                << static_cast<double>(counts.completed) / labels.size()
+                << " pixel-space distances per image" << std::endl;
+    }
+  }
+
+  exit(EXIT_SUCCESS);
+}
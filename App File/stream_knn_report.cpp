@@ -0,0 +1,97 @@
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <opencv2/opencv.hpp>
+
+#include "imgs/statistics/data_readers/DataReaders.h"
+#include "imgs/statistics/classifiers/Classifiers.h"
+
+// Classifies the test set against a training set streamed from disk in
+// fixed-size blocks (as on a box without the memory to hold it), and
+// checks the result against the in-memory classifier.
+//
+// Usage: stream_knn_report [k p chunk-images [train-images train-labels
+//                          test-images test-labels]]
+// (defaults to k = 2, p = 3 and blocks of 4096 images on our plate
+// character set)
+int main(int argc, char* argv[]) {
+  std::string directory = "../data/images/misc/final/";
+  std::string train_images_filename = directory + "train-images-28-ubyte";
+  std::string train_labels_filename = directory + "train-labels-28-ubyte";
+  std::string test_images_filename = directory + "test-images-28-ubyte";
+  std::string test_labels_filename = directory + "test-labels-28-ubyte";
+  int k = 2;
+  double p = 3;
+  std::size_t chunk_images = 4096;
+  if (argc == 4 || argc == 8) {
+    k = std::atoi(argv[1]);
+    p = std::atof(argv[2]);
+    chunk_images = std::strtoul(argv[3], nullptr, 10);
+  }
+  if (argc == 8) {
+    train_images_filename = argv[4];
+    train_labels_filename = argv[5];
+    test_images_filename = argv[6];
+    test_labels_filename = argv[7];
+  } else if (argc != 1 && argc != 4) {
+    std::cerr << "Usage: " << argv[0]
+              << " [k p chunk-images [train-images train-labels test-images "
+              << "test-labels]]" << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  statistics::PackedDataset test_images = statistics::ReadMnistDataset(
+      test_images_filename, test_labels_filename);
+  std::cout << test_images.size() << " test images read" << std::endl;
+  statistics::IdxChunkReader training_chunks(
+      train_images_filename, train_labels_filename, chunk_images);
+  if (training_chunks.empty()) {
+    exit(EXIT_FAILURE);
+  }
+
+  using Clock = std::chrono::steady_clock;
+  auto seconds = [](Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+  };
+  auto accuracy = [&](const std::vector<unsigned char>& labels) {
+    std::size_t correct = 0;
+    for (std::size_t t = 0; t < labels.size(); ++t) {
+      correct += (labels[t] == test_images.label(t));
+    }
+    return 100.0 * correct / labels.size();
+  };
+
+  statistics::KnnOptions options;
+  options.number_threads = 0;
+  auto start = Clock::now();
+  std::vector<unsigned char> streamed =
+      statistics::StreamKnn(test_images, training_chunks, k, p, options);
+  if (streamed.empty()) {
+    exit(EXIT_FAILURE);
+  }
+  const double stream_seconds = seconds(start);
+  const std::size_t chunk_bytes =
+      2 * training_chunks.MakeChunk().stride() * chunk_images;
+  std::cout << training_chunks.size() << " training images streamed in "
+            << stream_seconds << " s through " << chunk_bytes / 1024
+            << " KiB of blocks, accuracy = " << accuracy(streamed) << "%"
+            << std::endl;
+
+  // The same classification with the whole training set in memory
+  start = Clock::now();
+  statistics::PackedDataset training_images = statistics::ReadMnistDataset(
+      train_images_filename, train_labels_filename);
+  options.tiled = true;
+  std::vector<unsigned char> in_memory =
+      statistics::Knn(test_images, training_images, k, p, options);
+  std::cout << "In memory (" << training_images.size() *
+                                    training_images.stride() / 1024
+            << " KiB): " << seconds(start) << " s, "
+            << (in_memory == streamed ? "identical" : "DIFFERENT")
+            << " classifications" << std::endl;
+
+  exit(EXIT_SUCCESS);
+}
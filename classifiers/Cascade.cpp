@@ -0,0 +1,127 @@
+/** Implementation file for the coarse-to-fine nearest-neighbor index.
+ *
+ *  \file statistics/classifiers/Cascade.cpp
+ *  \date 17 Oct 2026
+ */
+
+#include "imgs/statistics/classifiers/Cascade.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+namespace statistics {
+
+namespace {
+
+// Largest coarse query kept on the stack (the coarse 28 x 28 characters
+// take one or two cache lines, and even 1 x 1 blocks fit)
+constexpr std::size_t kStackQueryBytes = 1024;
+
+}  // namespace
+
+CascadeIndex::CascadeIndex(const PackedDataset& training_images,
+                           const double p,
+                           const CascadeParameters& parameters)
+    : training_images_(training_images),
+      kernel_(p, training_images.rows(), training_images.cols()),
+      factor_(parameters.factor),
+      shortlist_(parameters.shortlist) {
+  if (factor_ < 1 ||
+      factor_ > std::max(training_images_.rows(), training_images_.cols())) {
+    std::cerr << "The cascade block size must be between 1 and the image "
+              << "size!" << std::endl;
+    training_images_ = PackedDataset();
+    return;
+  }
+
+  // Partial blocks along the bottom and right edges are averaged over the
+  // pixels they have
+  coarse_rows_ = (training_images_.rows() + factor_ - 1) / factor_;
+  coarse_cols_ = (training_images_.cols() + factor_ - 1) / factor_;
+  coarse_kernel_ = MinkowskiKernel(p, coarse_rows_, coarse_cols_);
+
+  coarse_images_ =
+      PackedDataset(training_images_.size(), coarse_rows_, coarse_cols_);
+  for (std::size_t i = 0; i < training_images_.size(); ++i) {
+    Downsample(training_images_.ptr(i), coarse_images_.ptr(i));
+  }
+}
+
+std::size_t CascadeIndex::MemoryBytes() const {
+  return coarse_images_.size() * coarse_images_.stride();
+}
+
+void CascadeIndex::Downsample(const unsigned char* image,
+                              unsigned char* coarse) const {
+  // Each block summed in place, so no buffer is needed per image
+  const int rows = training_images_.rows();
+  const int cols = training_images_.cols();
+  for (int r = 0; r < coarse_rows_; ++r) {
+    const int row_end = std::min(rows, (r + 1) * factor_);
+    for (int c = 0; c < coarse_cols_; ++c) {
+      const int col_end = std::min(cols, (c + 1) * factor_);
+      std::uint32_t sum = 0;
+      for (int y = r * factor_; y < row_end; ++y) {
+        const unsigned char* row = image + y * cols;
+        for (int x = c * factor_; x < col_end; ++x) {
+          sum += row[x];
+        }
+      }
+      const std::uint32_t count =
+          static_cast<std::uint32_t>((row_end - r * factor_) *
+                                     (col_end - c * factor_));
+      coarse[r * coarse_cols_ + c] =
+          static_cast<unsigned char>((sum + count / 2) / count);
+    }
+  }
+  std::fill(coarse + coarse_rows_ * coarse_cols_,
+            coarse + coarse_images_.stride(), 0);
+}
+
+void CascadeIndex::Nearest(const unsigned char* image, TopK& neighbors,
+                           KnnStatistics& statistics) const {
+  const std::size_t number_training = size();
+  statistics.candidates += number_training;
+
+  // The coarse images are compared over their whole zero-padded rows, which
+  // keeps the kernels on full vectors without changing any power sum
+  // (on the stack, unless the blocks are so small that the coarse images
+  // outgrow it)
+  const std::size_t stride = coarse_images_.stride();
+  alignas(kPackedAlignment) unsigned char stack_query[kStackQueryBytes];
+  thread_local std::vector<unsigned char> heap_query;
+  unsigned char* query = stack_query;
+  if (stride > kStackQueryBytes) {
+    heap_query.resize(stride);
+    query = heap_query.data();
+  }
+  Downsample(image, query);
+
+  // The shortlist by the coarse power sum, in one selection per thread kept
+  // across queries
+  thread_local TopK candidates;
+  candidates.Reset(static_cast<int>(std::max(shortlist_, neighbors.k())));
+  for (std::size_t i = 0; i < number_training; ++i) {
+    candidates.Push(
+        coarse_kernel_.PowerSum(query, coarse_images_.ptr(i), stride), i);
+  }
+
+  // Then at full resolution, nearest first so that the k-th nearest bound
+  // tightens early
+  const std::size_t number_pixels = training_images_.dimension();
+  for (const auto& candidate : candidates) {
+    const double bound = neighbors.Bound();
+    const double power_sum = kernel_.PowerSumBounded(
+        image, training_images_.ptr(candidate.index), number_pixels, bound);
+    if (power_sum > bound) {
+      ++statistics.abandoned;
+      continue;
+    }
+    ++statistics.completed;
+    neighbors.Push(power_sum, candidate.index);
+  }
+  statistics.skipped += number_training - candidates.size();
+}
+}
@@ -0,0 +1,117 @@
+/** Interface file for a coarse-to-fine nearest-neighbor index over packed
+ *  images.
+ *
+ *  Every training image is reduced once to the (rounded) means of its
+ *  factor x factor pixel blocks, a 7 x 7 character for factor 4 on 28 x 28
+ *  characters or 14 x 14 for factor 2, packed into a data set of its own.
+ *  A query is reduced the same way, the whole training set is ranked by
+ *  the Minkowski power sum of the coarse images (with the same vectorized
+ *  kernels, over 49 or 196 pixels instead of 784), and only the shortlist
+ *  of the nearest by that coarse distance is compared at full resolution
+ *  with the configured order.  The fine pass visits the shortlist nearest
+ *  first and abandons a power sum as soon as it exceeds the current k-th
+ *  nearest.
+ *
+ *  Images far apart at low resolution are far apart at full resolution
+ *  (up to the rounding of the means, the coarse power sum is a scaled
+ *  lower bound of the full one by the power mean inequality over each
+ *  block), so a true neighbor is missed only when many images are nearer
+ *  to the query at low resolution; a longer shortlist makes that rarer.
+ *
+ *  \file statistics/classifiers/Cascade.h
+ *  \date 17 Oct 2026
+ */
+
+#pragma once
+
+#include <cstddef>
+
+#include "imgs/statistics/classifiers/MinkowskiKernels.h"
+#include "imgs/statistics/classifiers/PrunedSearch.h"
+#include "imgs/statistics/classifiers/TopK.h"
+#include "imgs/statistics/data_readers/PackedDataset.h"
+
+namespace statistics {
+
+/** Parameters of a coarse-to-fine index
+ */
+struct CascadeParameters {
+  /// Side of the square pixel blocks averaged into one coarse pixel (4 gives
+  /// 7 x 7 coarse characters, 2 gives 14 x 14)
+  int factor = 4;
+
+  /// Number of coarse candidates compared at full resolution (at least k
+  /// are used)
+  std::size_t shortlist = 100;
+};
+
+class CascadeIndex {
+ public:
+  /** Construct an empty index
+   */
+  CascadeIndex() = default;
+
+  /** Downsample a training set to build the index over
+   *
+   *  \param[in] training_images  packed training images (and labels); the
+   *                              pixels are shared with, not copied from,
+   *                              the data set
+   *  \param[in] p                the order of the Minkowski distance of
+   *                              both passes (at least 1) [default is 2]
+   *  \param[in] parameters       block size and shortlist length [default
+   *                              is 4 x 4 blocks and 100 candidates]
+   */
+  explicit CascadeIndex(const PackedDataset& training_images,
+                        const double p = 2,
+                        const CascadeParameters& parameters =
+                            CascadeParameters());
+
+  const PackedDataset& training_images() const { return training_images_; }
+  double order() const { return kernel_.order(); }
+  std::size_t size() const { return training_images_.size(); }
+  bool empty() const { return training_images_.empty(); }
+  int factor() const { return factor_; }
+  int coarse_rows() const { return coarse_rows_; }
+  int coarse_cols() const { return coarse_cols_; }
+  std::size_t shortlist() const { return shortlist_; }
+
+  /// Change the number of candidates compared at full resolution
+  void set_shortlist(const std::size_t shortlist) { shortlist_ = shortlist; }
+
+  /// The downsampled training images
+  const PackedDataset& coarse_images() const { return coarse_images_; }
+
+  /// Bytes held by the downsampled training images
+  std::size_t MemoryBytes() const;
+
+  /** Block means of one image
+   *
+   *  \param[in]  image   the image (training geometry)
+   *  \param[out] coarse  its coarse_rows() x coarse_cols() block means,
+   *                      followed by zeros up to the coarse images' stride
+   */
+  void Downsample(const unsigned char* image, unsigned char* coarse) const;
+
+  /** Offer the nearest training images of an image's shortlist to its
+   *  selection, by their full-resolution power sums
+   *
+   *  \param[in]     image       the image to search for
+   *  \param[in,out] neighbors   the k nearest so far
+   *  \param[in,out] statistics  counts to add this search's to (skipped
+   *                             are the training images only compared at
+   *                             low resolution)
+   */
+  void Nearest(const unsigned char* image, TopK& neighbors,
+               KnnStatistics& statistics) const;
+
+ private:
+  PackedDataset training_images_;
+  MinkowskiKernel kernel_{2};
+  MinkowskiKernel coarse_kernel_{2};
+  int factor_ = 4;
+  int coarse_rows_ = 0;
+  int coarse_cols_ = 0;
+  std::size_t shortlist_ = 100;
+  PackedDataset coarse_images_;
+};
+}
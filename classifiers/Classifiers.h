@@ -7,4 +7,9 @@
 
 #pragma once
 
+#include "imgs/statistics/classifiers/Condensation.h"
 #include "imgs/statistics/classifiers/Knn.h"
+#include "imgs/statistics/classifiers/KnnClassifier.h"
+#include "imgs/statistics/classifiers/KnnModel.h"
+#include "imgs/statistics/classifiers/KnnSweep.h"
+#include "imgs/statistics/classifiers/StreamingKnn.h"
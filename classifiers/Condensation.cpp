@@ -0,0 +1,180 @@
+/** Implementation file for the training set editing and condensation.
+ *
+ *  \file statistics/classifiers/Condensation.cpp
+ *  \date 17 Oct 2026
+ */
+
+#include "imgs/statistics/classifiers/Condensation.h"
+
+#include <algorithm>
+#include <array>
+
+#include "imgs/statistics/classifiers/MinkowskiKernels.h"
+#include "imgs/statistics/classifiers/PrunedSearch.h"
+#include "imgs/statistics/classifiers/TopK.h"
+#include "imgs/statistics/parallel/ThreadPool.h"
+
+namespace statistics {
+
+namespace {
+
+// Candidates checked against one state of the store in HartCondense (a
+// fixed number, so that the result does not depend on the threads; small
+// enough that few redundant images of one block are absorbed together)
+constexpr std::size_t kHartBlock = 256;
+
+}  // namespace
+
+std::vector<std::size_t> WilsonEdit(const PackedDataset& training_images,
+                                    const int k, const double p,
+                                    const unsigned int number_threads) {
+  const std::size_t number_images = training_images.size();
+  if (k < 1 || number_images < 2 || !training_images.has_labels()) {
+    std::vector<std::size_t> all(number_images);
+    for (std::size_t i = 0; i < number_images; ++i) {
+      all[i] = i;
+    }
+    return all;
+  }
+
+  // Leave-one-out vote: the image itself is among its k + 1 nearest (at
+  // distance 0), and is left out of them
+  const MinkowskiKernel kernel(p, training_images.rows(),
+                               training_images.cols());
+  const PrunedSearch search(training_images, kernel);
+  std::vector<unsigned char> keep(number_images, 0);
+
+  ThreadPool pool(number_threads);
+  pool.ParallelFor(
+      0, number_images, 64,
+      [&](std::size_t begin, std::size_t end, unsigned int) {
+        TopK neighbors(k + 1);
+        KnnStatistics statistics;
+        for (std::size_t i = begin; i < end; ++i) {
+          neighbors.Clear();
+          search.Nearest(training_images, i, neighbors, statistics);
+          LabelHistogram histogram;
+          int votes = 0;
+          for (const auto& neighbor : neighbors) {
+            if (neighbor.index == i || votes == k) {
+              continue;
+            }
+            histogram.Add(training_images.label(neighbor.index));
+            ++votes;
+          }
+          keep[i] = (histogram.MostCommon() == training_images.label(i));
+        }
+      });
+
+  std::vector<std::size_t> kept;
+  for (std::size_t i = 0; i < number_images; ++i) {
+    if (keep[i]) {
+      kept.push_back(i);
+    }
+  }
+  return kept;
+}
+
+std::vector<std::size_t> HartCondense(
+    const PackedDataset& training_images,
+    const std::vector<std::size_t>& candidates, const double p,
+    const unsigned int number_threads) {
+  if (!training_images.has_labels()) {
+    return candidates;
+  }
+  const MinkowskiKernel kernel(p, training_images.rows(),
+                               training_images.cols());
+  const std::size_t number_pixels = training_images.dimension();
+
+  // Seed with the first candidate of each class
+  std::vector<std::size_t> store;
+  std::vector<unsigned char> stored(training_images.size(), 0);
+  std::array<bool, 256> seeded{};
+  for (const std::size_t idx : candidates) {
+    const unsigned char label = training_images.label(idx);
+    if (!seeded[label]) {
+      seeded[label] = true;
+      store.push_back(idx);
+      stored[idx] = 1;
+    }
+  }
+
+  // Absorb every candidate the store misclassifies, until a pass absorbs
+  // none (every pass but the last grows the store, so this terminates).
+  // Each block of candidates is checked in parallel against the store as
+  // it stands, and its misclassified candidates are then absorbed in
+  // order, so the result does not depend on the number of threads
+  ThreadPool pool(number_threads);
+  std::vector<unsigned char> misclassified(kHartBlock);
+  for (bool absorbed = true; absorbed;) {
+    absorbed = false;
+    for (std::size_t block = 0; block < candidates.size();
+         block += kHartBlock) {
+      const std::size_t block_end =
+          std::min(block + kHartBlock, candidates.size());
+      pool.ParallelFor(
+          block, block_end, 8,
+          [&](std::size_t begin, std::size_t end, unsigned int) {
+            for (std::size_t c = begin; c < end; ++c) {
+              const std::size_t idx = candidates[c];
+              misclassified[c - block] = 0;
+              if (stored[idx]) {
+                continue;
+              }
+              const unsigned char* image = training_images.ptr(idx);
+              TopK nearest(1);
+              for (const std::size_t prototype : store) {
+                const double bound = nearest.Bound();
+                const double power_sum = kernel.PowerSumBounded(
+                    image, training_images.ptr(prototype), number_pixels,
+                    bound);
+                if (power_sum <= bound) {
+                  nearest.Push(power_sum, prototype);
+                }
+              }
+              misclassified[c - block] =
+                  (training_images.label(nearest[0].index) !=
+                   training_images.label(idx));
+            }
+          });
+
+      for (std::size_t c = block; c < block_end; ++c) {
+        const std::size_t idx = candidates[c];
+        if (misclassified[c - block] && !stored[idx]) {
+          store.push_back(idx);
+          stored[idx] = 1;
+          absorbed = true;
+        }
+      }
+    }
+  }
+
+  std::sort(store.begin(), store.end());
+  return store;
+}
+
+std::vector<std::size_t> CapPerClass(const PackedDataset& training_images,
+                                     const std::vector<std::size_t>& indices,
+                                     const std::size_t cap) {
+  if (cap == 0 || !training_images.has_labels()) {
+    return indices;
+  }
+
+  std::array<std::vector<std::size_t>, 256> classes;
+  for (const std::size_t idx : indices) {
+    classes[training_images.label(idx)].push_back(idx);
+  }
+  std::vector<std::size_t> kept;
+  for (const auto& members : classes) {
+    if (members.size() <= cap) {
+      kept.insert(kept.end(), members.begin(), members.end());
+      continue;
+    }
+    for (std::size_t j = 0; j < cap; ++j) {
+      kept.push_back(members[j * members.size() / cap]);
+    }
+  }
+  std::sort(kept.begin(), kept.end());
+  return kept;
+}
+}
@@ -0,0 +1,86 @@
+/** Interface file for reducing a labeled training set to fewer prototypes
+ *  before k-NN classification, since every training image costs query
+ *  time for as long as the model is used.
+ *
+ *    - Wilson editing removes every image that the majority of its own k
+ *      nearest neighbors (leaving itself out) would misclassify, i.e. the
+ *      noisy and mislabeled images and those deep in another class.
+ *    - Hart's condensed nearest neighbor keeps only a consistent subset:
+ *      images are added, pass after pass, as long as the 1-NN rule on the
+ *      images kept so far misclassifies them, so that in the end the kept
+ *      subset classifies all of the input correctly.  Redundant images in
+ *      the interior of a class (e.g. near-identical characters of one font)
+ *      are dropped.
+ *    - A per-class cap then bounds the prototypes of any one class.
+ *
+ *  Editing first and condensing the edited set (as Wilson then Hart) gives
+ *  a small set of prototypes along clean class boundaries.  Every step is
+ *  deterministic and returns sorted indices into the original data set, so
+ *  the steps can be chained and the result copied with SelectImages().
+ *
+ *  \file statistics/classifiers/Condensation.h
+ *  \date 17 Oct 2026
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "imgs/statistics/data_readers/PackedDataset.h"
+
+namespace statistics {
+
+/** Wilson editing: keep the images classified correctly by their k nearest
+ *  other images
+ *
+ *  \param[in] training_images  packed labeled images with their statistics
+ *                              computed
+ *  \param[in] k                number of neighbors in the vote [default
+ *                              is 3]
+ *  \param[in] p                order of the Minkowski distance [default
+ *                              is 2]
+ *  \param[in] number_threads   threads to search with (0 uses one per
+ *                              hardware thread) [default is 0]
+ *  \return                     sorted indices of the images kept
+ */
+std::vector<std::size_t> WilsonEdit(const PackedDataset& training_images,
+                                    const int k = 3, const double p = 2,
+                                    const unsigned int number_threads = 0);
+
+/** Hart's condensed nearest neighbor: a subset of the candidates that
+ *  classifies every candidate correctly with the 1-NN rule
+ *
+ *  The first candidate of each class seeds the subset, and the candidates
+ *  are then visited in order, pass after pass, until one pass adds none.
+ *  Blocks of 256 candidates are checked in parallel against the subset as
+ *  it stands before the block, and the block's misclassified candidates
+ *  are added in order, so the result is the same for any number of threads.
+ *
+ *  \param[in] training_images  packed labeled images
+ *  \param[in] candidates       indices of the images to condense (e.g. the
+ *                              result of WilsonEdit())
+ *  \param[in] p                order of the Minkowski distance [default
+ *                              is 2]
+ *  \param[in] number_threads   threads to search with (0 uses one per
+ *                              hardware thread) [default is 0]
+ *  \return                     sorted indices of the images kept
+ */
+std::vector<std::size_t> HartCondense(
+    const PackedDataset& training_images,
+    const std::vector<std::size_t>& candidates, const double p = 2,
+    const unsigned int number_threads = 0);
+
+/** Keep at most a given number of images of each class, evenly spaced
+ *  through the class's images
+ *
+ *  \param[in] training_images  packed labeled images
+ *  \param[in] indices          sorted indices of the images to cap
+ *  \param[in] cap              largest number of images kept per class
+ *                              (0 keeps them all)
+ *  \return                     sorted indices of the images kept
+ */
+std::vector<std::size_t> CapPerClass(const PackedDataset& training_images,
+                                     const std::vector<std::size_t>& indices,
+                                     const std::size_t cap);
+}
@@ -0,0 +1,114 @@
+/** Interface file for the compile-time specialized Minkowski distance
+ *  family.  Distance<P, Rows, Cols> fixes both the order of the Lp-norm and
+ *  the image geometry at compile time, so the power of each absolute
+ *  difference comes from a constexpr table (or a couple of integer
+ *  multiplies) and the loop over the Rows x Cols pixels has a constant
+ *  trip count the compiler can unroll or vectorize.  The characters
+ *  produced by AutoExtractCharacters() are always 28 x 28, so that
+ *  geometry is the one instantiated by the k-NN classifier.
+ *
+ *  \file statistics/classifiers/Distance.h
+ *  \date 17 Oct 2026
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace statistics {
+
+/// Geometry of the characters produced by AutoExtractCharacters()
+constexpr int kCharacterRows = 28;
+constexpr int kCharacterCols = 28;
+
+/// Order tag for a non-integer p, whose |d|^p values are supplied at run
+/// time through a 256-entry table
+constexpr int kRealOrder = 0;
+
+/** |d|^P for every 8-bit absolute difference d, built at compile time
+ */
+template <int P>
+constexpr std::array<std::uint64_t, 256> MakePowerTable() {
+  std::array<std::uint64_t, 256> table{};
+  for (std::uint64_t d = 0; d < 256; ++d) {
+    std::uint64_t power = 1;
+    for (int e = 0; e < P; ++e) {
+      power *= d;
+    }
+    table[d] = power;
+  }
+  return table;
+}
+
+template <int P>
+inline constexpr std::array<std::uint64_t, 256> kPowerTable =
+    MakePowerTable<P>();
+
+/** Whether a sum of |d|^p over n pixels (d up to 255, integer p from 1 to
+ *  6) always fits in 64 bits
+ */
+constexpr bool FitsIntegerPowerSum(const int p, const std::size_t n) {
+  std::uint64_t largest = 1;
+  for (int e = 0; e < p; ++e) {
+    largest *= 255;
+  }
+  return n <= UINT64_MAX / largest;
+}
+
+/** Minkowski distance of order P between two Rows x Cols 8-bit images
+ */
+template <int P, int Rows, int Cols>
+struct Distance {
+  static_assert(P == kRealOrder || (P >= 1 && P <= 6),
+                "integer orders above 6 overflow 64-bit power sums");
+
+  static constexpr std::size_t kPixels =
+      static_cast<std::size_t>(Rows) * Cols;
+  static_assert(P == kRealOrder || FitsIntegerPowerSum(P, kPixels),
+                "power sums of this geometry overflow 64 bits");
+
+  /** sum(|a - b|^P) over the Rows x Cols pixels (exact for integer P)
+   *
+   *  \param[in] a           first image, kPixels contiguous pixels
+   *  \param[in] b           second image, kPixels contiguous pixels
+   *  \param[in] real_table  |d|^p for d = 0..255 (used only when P is
+   *                         kRealOrder) [default is nullptr]
+   */
+  static double PowerSum(const unsigned char* a, const unsigned char* b,
+                         const double* real_table = nullptr) {
+    // A plain loop over the constant bound (rather than a fold over every
+    // pixel, which exceeds clang's expression nesting limit) still lets
+    // the compiler unroll or vectorize it
+    if constexpr (P == kRealOrder) {
+      double sum = 0;
+      for (std::size_t i = 0; i < kPixels; ++i) {
+        sum += real_table[(a[i] > b[i]) ? a[i] - b[i] : b[i] - a[i]];
+      }
+      return sum;
+    } else {
+      std::uint64_t sum = 0;
+      for (std::size_t i = 0; i < kPixels; ++i) {
+        sum += Power(a[i], b[i]);
+      }
+      return static_cast<double>(sum);
+    }
+  }
+
+ private:
+  static constexpr std::uint64_t Power(const unsigned char a,
+                                       const unsigned char b) {
+    std::uint64_t d = (a > b) ? a - b : b - a;
+    if constexpr (P == 1) {
+      return d;
+    } else if constexpr (P == 2) {
+      return d * d;
+    } else if constexpr (P == 3) {
+      return d * d * d;
+    } else {
+      return kPowerTable<P>[d];
+    }
+  }
+};
+}
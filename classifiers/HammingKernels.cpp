@@ -0,0 +1,76 @@
+/** Implementation file for the Hamming distance kernels.
+ *
+ *  \file statistics/classifiers/HammingKernels.cpp
+ *  \date 17 Oct 2026
+ */
+
+#include "imgs/statistics/classifiers/HammingKernels.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define STATISTICS_X86_KERNELS 1
+#endif
+
+namespace statistics {
+
+namespace {
+
+// Words in a bit-packed 28 x 28 character
+constexpr std::size_t kCharacterWords = 13;
+
+// Portable kernel (the compiler's popcount emulation)
+std::uint32_t ScalarHamming(const std::uint64_t* a, const std::uint64_t* b,
+                            const std::size_t words) {
+  std::uint32_t distance = 0;
+  for (std::size_t w = 0; w < words; ++w) {
+    distance += static_cast<std::uint32_t>(__builtin_popcountll(a[w] ^ b[w]));
+  }
+  return distance;
+}
+
+#ifdef STATISTICS_X86_KERNELS
+
+__attribute__((target("popcnt"))) std::uint32_t PopcountHamming(
+    const std::uint64_t* a, const std::uint64_t* b, const std::size_t words) {
+  std::uint32_t distance = 0;
+  for (std::size_t w = 0; w < words; ++w) {
+    distance += static_cast<std::uint32_t>(__builtin_popcountll(a[w] ^ b[w]));
+  }
+  return distance;
+}
+
+__attribute__((target("popcnt"))) std::uint32_t CharacterHamming(
+    const std::uint64_t* a, const std::uint64_t* b, const std::size_t) {
+  std::uint32_t distance = 0;
+#pragma GCC unroll 13
+  for (std::size_t w = 0; w < kCharacterWords; ++w) {
+    distance += static_cast<std::uint32_t>(__builtin_popcountll(a[w] ^ b[w]));
+  }
+  return distance;
+}
+
+#endif  // STATISTICS_X86_KERNELS
+
+}  // namespace
+
+bool HasPopcount() {
+#ifdef STATISTICS_X86_KERNELS
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("popcnt");
+#else
+  return false;
+#endif
+}
+
+HammingKernel::HammingKernel(const std::size_t words, const bool use_popcount)
+    : words_(words), uses_popcount_(false), distance_(ScalarHamming) {
+#ifdef STATISTICS_X86_KERNELS
+  if (use_popcount) {
+    uses_popcount_ = true;
+    distance_ = (words == kCharacterWords) ? CharacterHamming
+                                           : PopcountHamming;
+  }
+#else
+  (void)use_popcount;
+#endif
+}
+}
@@ -0,0 +1,53 @@
+/** Interface file for the Hamming distance kernels used by the binary k-NN
+ *  classifier.  The distance between two bit-packed images is the number
+ *  of set bits in the XOR of their words, counted with the hardware
+ *  popcount instruction when the CPU has one (chosen at run time, with a
+ *  portable fallback), and with the word loop fully unrolled for the
+ *  13-word 28 x 28 characters.
+ *
+ *  \file statistics/classifiers/HammingKernels.h
+ *  \date 17 Oct 2026
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace statistics {
+
+/** Whether the running CPU has the popcount instruction
+ */
+bool HasPopcount();
+
+class HammingKernel {
+ public:
+  using DistanceFunction = std::uint32_t (*)(const std::uint64_t* a,
+                                             const std::uint64_t* b,
+                                             const std::size_t words);
+
+  /** Select the kernel for images of a given number of words
+   *
+   *  \param[in] words         number of uint64 words per image
+   *  \param[in] use_popcount  use the popcount instruction [default is
+   *                           whether the CPU has it]
+   */
+  explicit HammingKernel(const std::size_t words,
+                         const bool use_popcount = HasPopcount());
+
+  /// Whether the hardware popcount instruction is used
+  bool uses_popcount() const { return uses_popcount_; }
+
+  /** Number of differing bits between two images
+   */
+  std::uint32_t Distance(const std::uint64_t* a,
+                         const std::uint64_t* b) const {
+    return distance_(a, b, words_);
+  }
+
+ private:
+  std::size_t words_;
+  bool uses_popcount_;
+  DistanceFunction distance_;
+};
+}
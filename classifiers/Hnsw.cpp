@@ -0,0 +1,362 @@
+/** Implementation file for the approximate nearest-neighbor HNSW index.
+ *
+ *  \file statistics/classifiers/Hnsw.cpp
+ *  \date 17 Oct 2026
+ */
+
+#include "imgs/statistics/classifiers/Hnsw.h"
+
+#include <algorithm>
+#include <cmath>
+#include <queue>
+#include <random>
+#include <utility>
+
+#include "imgs/statistics/classifiers/Serialization.h"
+
+namespace statistics {
+
+namespace {
+
+// Highest layer a node can be drawn for (never reached in practice)
+constexpr int kMaximumLevel = 16;
+
+// Most links per node on the upper layers, far above any useful M, so
+// that the link counts of a loaded graph cannot overflow
+constexpr int kMaximumM = 1 << 15;
+
+// Heap orders on neighbors: nearest on top, and farthest on top
+struct NearestOnTop {
+  bool operator()(const Neighbor& a, const Neighbor& b) const {
+    return NearerThan(b, a);
+  }
+};
+
+struct FarthestOnTop {
+  bool operator()(const Neighbor& a, const Neighbor& b) const {
+    return NearerThan(a, b);
+  }
+};
+
+}  // namespace
+
+HnswIndex::HnswIndex(const PackedDataset& training_images, const double p,
+                     const HnswParameters& parameters)
+    : training_images_(training_images),
+      kernel_(p, training_images.rows(), training_images.cols()),
+      parameters_(parameters) {
+  parameters_.m = std::min(std::max(parameters_.m, 2), kMaximumM);
+  parameters_.ef_construction =
+      std::max(parameters_.ef_construction, parameters_.m);
+  const std::size_t number_training = training_images.size();
+
+  // Layer of every node: floor(-ln(U) / ln(M)), from the raw generator
+  // output so that the graph is the same on every platform
+  std::mt19937 generator(parameters_.seed);
+  const double level_scale = 1 / std::log(static_cast<double>(parameters_.m));
+  levels_.resize(number_training);
+  upper_links_.resize(number_training);
+  for (std::size_t i = 0; i < number_training; ++i) {
+    double uniform = (generator() + 0.5) / 4294967296.0;
+    levels_[i] = std::min(
+        static_cast<int>(std::floor(-std::log(uniform) * level_scale)),
+        kMaximumLevel);
+    upper_links_[i].assign(levels_[i] * (MaximumLinks(1) + 1), 0);
+  }
+  base_links_.assign(number_training * (MaximumLinks(0) + 1), 0);
+
+  Visited visited;
+  for (std::size_t i = 0; i < number_training; ++i) {
+    Insert(static_cast<std::uint32_t>(i), visited);
+  }
+}
+
+std::size_t HnswIndex::MemoryBytes() const {
+  std::size_t bytes = levels_.capacity() * sizeof(int) +
+                      base_links_.capacity() * sizeof(std::uint32_t) +
+                      upper_links_.capacity() * sizeof(upper_links_[0]);
+  for (const auto& links : upper_links_) {
+    bytes += links.capacity() * sizeof(std::uint32_t);
+  }
+  return bytes;
+}
+
+void HnswIndex::Save(std::ostream& stream) const {
+  WriteValue(stream, order());
+  WriteValue(stream, parameters_);
+  WriteValue(stream, top_level_);
+  WriteValue(stream, entry_);
+  WriteVector(stream, levels_);
+  WriteVector(stream, base_links_);
+  for (const auto& links : upper_links_) {
+    WriteVector(stream, links);
+  }
+}
+
+bool HnswIndex::Load(std::istream& stream,
+                     const PackedDataset& training_images) {
+  *this = HnswIndex();
+  double p = 2;
+  if (!ReadValue(stream, p) || !ReadValue(stream, parameters_) ||
+      !ReadValue(stream, top_level_) || !ReadValue(stream, entry_) ||
+      !ReadVector(stream, levels_) || !ReadVector(stream, base_links_) ||
+      levels_.size() != training_images.size() || parameters_.m < 2 ||
+      parameters_.m > kMaximumM || top_level_ > kMaximumLevel ||
+      base_links_.size() != levels_.size() * (MaximumLinks(0) + 1) ||
+      (!levels_.empty() &&
+       (entry_ >= levels_.size() || levels_[entry_] != top_level_))) {
+    *this = HnswIndex();
+    return false;
+  }
+  upper_links_.resize(levels_.size());
+  for (std::size_t i = 0; i < levels_.size(); ++i) {
+    if (levels_[i] < 0 || levels_[i] > top_level_ ||
+        !ReadVector(stream, upper_links_[i]) ||
+        upper_links_[i].size() !=
+            static_cast<std::size_t>(levels_[i]) * (MaximumLinks(1) + 1)) {
+      *this = HnswIndex();
+      return false;
+    }
+  }
+
+  // Every link must name a node that is on the link's layer (as the entry
+  // node is on the top layer), so that a corrupt file cannot send a search
+  // out of bounds
+  for (std::size_t i = 0; i < levels_.size(); ++i) {
+    for (int level = 0; level <= levels_[i]; ++level) {
+      const std::uint32_t* links =
+          Links(static_cast<std::uint32_t>(i), level);
+      bool is_valid = links[0] <= static_cast<std::uint32_t>(
+                                      MaximumLinks(level));
+      for (std::uint32_t l = 1; is_valid && l <= links[0]; ++l) {
+        is_valid = links[l] < levels_.size() && levels_[links[l]] >= level;
+      }
+      if (!is_valid) {
+        *this = HnswIndex();
+        return false;
+      }
+    }
+  }
+
+  training_images_ = training_images;
+  kernel_ = MinkowskiKernel(p, training_images.rows(), training_images.cols());
+  return true;
+}
+
+double HnswIndex::PowerSum(const unsigned char* image,
+                           const std::uint32_t node) const {
+  return kernel_.PowerSum(image, training_images_.ptr(node),
+                          training_images_.dimension());
+}
+
+int HnswIndex::MaximumLinks(const int level) const {
+  return (level == 0) ? 2 * parameters_.m : parameters_.m;
+}
+
+std::uint32_t* HnswIndex::Links(const std::uint32_t node, const int level) {
+  if (level == 0) {
+    return base_links_.data() + node * (MaximumLinks(0) + 1);
+  }
+  return upper_links_[node].data() + (level - 1) * (MaximumLinks(1) + 1);
+}
+
+const std::uint32_t* HnswIndex::Links(const std::uint32_t node,
+                                      const int level) const {
+  return const_cast<HnswIndex*>(this)->Links(node, level);
+}
+
+std::uint32_t HnswIndex::Greedy(const unsigned char* image,
+                                std::uint32_t entry, const int level,
+                                std::size_t& evaluations) const {
+  Neighbor nearest{PowerSum(image, entry), entry};
+  ++evaluations;
+  for (bool moved = true; moved;) {
+    moved = false;
+    const std::uint32_t* links = Links(entry, level);
+    for (std::uint32_t i = 1; i <= links[0]; ++i) {
+      Neighbor candidate{PowerSum(image, links[i]), links[i]};
+      ++evaluations;
+      if (NearerThan(candidate, nearest)) {
+        nearest = candidate;
+        moved = true;
+      }
+    }
+    entry = static_cast<std::uint32_t>(nearest.index);
+  }
+  return entry;
+}
+
+std::vector<Neighbor> HnswIndex::SearchLayer(
+    const unsigned char* image, const std::vector<Neighbor>& entries,
+    const std::size_t ef, const int level, Visited& visited,
+    std::size_t& evaluations) const {
+  // A new generation of marks, so they need clearing only on wrap around
+  if (visited.marks.size() < size() || ++visited.generation == 0) {
+    visited.marks.assign(size(), 0);
+    visited.generation = 1;
+  }
+
+  std::priority_queue<Neighbor, std::vector<Neighbor>, NearestOnTop>
+      candidates;
+  std::priority_queue<Neighbor, std::vector<Neighbor>, FarthestOnTop> results;
+  for (const auto& entry : entries) {
+    visited.marks[entry.index] = visited.generation;
+    candidates.push(entry);
+    results.push(entry);
+  }
+  while (results.size() > ef) {
+    results.pop();
+  }
+
+  while (!candidates.empty()) {
+    const Neighbor nearest = candidates.top();
+    if (results.size() >= ef && NearerThan(results.top(), nearest)) {
+      break;
+    }
+    candidates.pop();
+
+    const std::uint32_t* links =
+        Links(static_cast<std::uint32_t>(nearest.index), level);
+    for (std::uint32_t i = 1; i <= links[0]; ++i) {
+      const std::uint32_t node = links[i];
+      if (visited.marks[node] == visited.generation) {
+        continue;
+      }
+      visited.marks[node] = visited.generation;
+      const Neighbor candidate{PowerSum(image, node), node};
+      ++evaluations;
+      if (results.size() < ef || NearerThan(candidate, results.top())) {
+        candidates.push(candidate);
+        results.push(candidate);
+        if (results.size() > ef) {
+          results.pop();
+        }
+      }
+    }
+  }
+
+  // Nearest first
+  std::vector<Neighbor> nearest(results.size());
+  for (std::size_t i = nearest.size(); i > 0; --i) {
+    nearest[i - 1] = results.top();
+    results.pop();
+  }
+  return nearest;
+}
+
+std::vector<Neighbor> HnswIndex::SelectNeighbors(
+    std::vector<Neighbor> candidates, const int maximum) const {
+  // Keep a candidate only if it is nearer to the new node than to every
+  // neighbor kept so far, which spreads the links out in all directions
+  std::sort(candidates.begin(), candidates.end(), NearerThan);
+  std::vector<Neighbor> selected;
+  for (const auto& candidate : candidates) {
+    if (selected.size() >= static_cast<std::size_t>(maximum)) {
+      break;
+    }
+    const unsigned char* candidate_ptr = training_images_.ptr(candidate.index);
+    bool is_diverse = true;
+    for (const auto& kept : selected) {
+      if (PowerSum(candidate_ptr, static_cast<std::uint32_t>(kept.index)) <
+          candidate.distance) {
+        is_diverse = false;
+        break;
+      }
+    }
+    if (is_diverse) {
+      selected.push_back(candidate);
+    }
+  }
+  return selected;
+}
+
+void HnswIndex::Connect(const std::uint32_t node, const std::uint32_t neighbor,
+                        const int level) {
+  std::uint32_t* links = Links(node, level);
+  const int maximum = MaximumLinks(level);
+  if (links[0] < static_cast<std::uint32_t>(maximum)) {
+    links[++links[0]] = neighbor;
+    return;
+  }
+
+  // Full: reselect among the old links and the new one
+  const unsigned char* node_ptr = training_images_.ptr(node);
+  std::vector<Neighbor> candidates;
+  for (std::uint32_t i = 1; i <= links[0]; ++i) {
+    candidates.push_back(Neighbor{PowerSum(node_ptr, links[i]), links[i]});
+  }
+  candidates.push_back(Neighbor{PowerSum(node_ptr, neighbor), neighbor});
+  std::vector<Neighbor> selected = SelectNeighbors(candidates, maximum);
+  links[0] = static_cast<std::uint32_t>(selected.size());
+  for (std::size_t i = 0; i < selected.size(); ++i) {
+    links[i + 1] = static_cast<std::uint32_t>(selected[i].index);
+  }
+}
+
+void HnswIndex::Insert(const std::uint32_t node, Visited& visited) {
+  const int level = levels_[node];
+  if (top_level_ < 0) {
+    entry_ = node;
+    top_level_ = level;
+    return;
+  }
+
+  // Descend greedily to the new node's own top layer, then link it on
+  // every layer from there down
+  const unsigned char* image = training_images_.ptr(node);
+  std::size_t evaluations = 0;
+  std::uint32_t entry = entry_;
+  for (int layer = top_level_; layer > level; --layer) {
+    entry = Greedy(image, entry, layer, evaluations);
+  }
+
+  std::vector<Neighbor> entries{Neighbor{PowerSum(image, entry), entry}};
+  for (int layer = std::min(level, top_level_); layer >= 0; --layer) {
+    entries = SearchLayer(image, entries, parameters_.ef_construction, layer,
+                          visited, evaluations);
+    std::vector<Neighbor> selected =
+        SelectNeighbors(entries, parameters_.m);
+    std::uint32_t* links = Links(node, layer);
+    links[0] = static_cast<std::uint32_t>(selected.size());
+    for (std::size_t i = 0; i < selected.size(); ++i) {
+      links[i + 1] = static_cast<std::uint32_t>(selected[i].index);
+      Connect(links[i + 1], node, layer);
+    }
+  }
+
+  if (level > top_level_) {
+    entry_ = node;
+    top_level_ = level;
+  }
+}
+
+void HnswIndex::Nearest(const unsigned char* image, TopK& neighbors,
+                        KnnStatistics& statistics) const {
+  statistics.candidates += size();
+  if (empty()) {
+    return;
+  }
+
+  std::size_t evaluations = 0;
+  std::uint32_t entry = entry_;
+  for (int layer = top_level_; layer > 0; --layer) {
+    entry = Greedy(image, entry, layer, evaluations);
+  }
+
+  // One set of marks per thread, kept across queries: a new generation
+  // replaces clearing them, so they are only reset when it wraps around
+  thread_local Visited visited;
+  const std::size_t ef = std::max<std::size_t>(
+      static_cast<std::size_t>(std::max(parameters_.ef_search, 1)),
+      neighbors.k());
+  std::vector<Neighbor> entries{Neighbor{PowerSum(image, entry), entry}};
+  for (const auto& neighbor :
+       SearchLayer(image, entries, ef, 0, visited, evaluations)) {
+    neighbors.Push(neighbor.distance, neighbor.index);
+  }
+
+  evaluations = std::min(evaluations, size());
+  statistics.completed += evaluations;
+  statistics.skipped += size() - evaluations;
+}
+}
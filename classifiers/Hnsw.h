@@ -0,0 +1,155 @@
+/** Interface file for an approximate nearest-neighbor index over a packed
+ *  training set: a hierarchical navigable small world (HNSW) graph.  Every
+ *  training image is a node linked to (about) M of its near neighbors on
+ *  layer 0, and a geometrically shrinking random subset of the nodes is
+ *  linked again on each higher layer.  A query descends greedily from the
+ *  single node on the top layer and finishes with a best-first search of
+ *  width efSearch on layer 0, so it compares against only a small part of
+ *  the training set at the price of occasionally missing a true neighbor.
+ *
+ *  The graph ranks images by the same power sums as the linear scan, so
+ *  any Minkowski order the classifier supports can be used.  Construction
+ *  inserts the images in order from a fixed seed, so the same training
+ *  set and parameters always give the same graph (and the same answers).
+ *
+ *  \file statistics/classifiers/Hnsw.h
+ *  \date 17 Oct 2026
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <vector>
+
+#include "imgs/statistics/classifiers/MinkowskiKernels.h"
+#include "imgs/statistics/classifiers/PrunedSearch.h"
+#include "imgs/statistics/classifiers/TopK.h"
+#include "imgs/statistics/data_readers/PackedDataset.h"
+
+namespace statistics {
+
+/** Build and search parameters of an HNSW index
+ */
+struct HnswParameters {
+  /// Links per node on the upper layers (twice as many on layer 0); more
+  /// links raise recall, memory and build time (at most 32768)
+  int m = 16;
+
+  /// Width of the search that picks each new node's links; wider gives a
+  /// better graph at the price of build time
+  int ef_construction = 200;
+
+  /// Width of the layer 0 search of a query (at least k is used); the main
+  /// recall versus latency knob, and the only one that can be changed
+  /// after the index is built
+  int ef_search = 64;
+
+  /// Seed of the random layer assignment
+  std::uint32_t seed = 100;
+};
+
+class HnswIndex {
+ public:
+  /** Construct an empty index
+   */
+  HnswIndex() = default;
+
+  /** Build the index over a training set
+   *
+   *  \param[in] training_images  packed training images (and labels); the
+   *                              pixels are shared with, not copied from,
+   *                              the data set
+   *  \param[in] p                the order of the Minkowski distance the
+   *                              index is built for (at least 1)
+   *                              [default is 2]
+   *  \param[in] parameters       graph parameters [default is M = 16,
+   *                              efConstruction = 200, efSearch = 64]
+   */
+  explicit HnswIndex(const PackedDataset& training_images, const double p = 2,
+                     const HnswParameters& parameters = HnswParameters());
+
+  const PackedDataset& training_images() const { return training_images_; }
+  double order() const { return kernel_.order(); }
+  std::size_t size() const { return levels_.size(); }
+  bool empty() const { return levels_.empty(); }
+  const HnswParameters& parameters() const { return parameters_; }
+
+  /// Change the query search width (e.g. to trace a recall curve)
+  void set_ef_search(const int ef_search) {
+    parameters_.ef_search = ef_search;
+  }
+
+  /// Number of layers above layer 0
+  int top_level() const { return top_level_; }
+
+  /// Bytes held by the graph itself (not counting the shared pixels)
+  std::size_t MemoryBytes() const;
+
+  /** Write the graph (not the training images) to a binary stream
+   */
+  void Save(std::ostream& stream) const;
+
+  /** Replace the graph with one written by Save()
+   *
+   *  \param[in] stream           binary stream positioned at the graph
+   *  \param[in] training_images  the training images the graph was built
+   *                              over
+   *  \return                     whether a consistent graph was read (the
+   *                              graph is left empty otherwise)
+   */
+  bool Load(std::istream& stream, const PackedDataset& training_images);
+
+  /** Offer the (approximately) nearest training images of an image to its
+   *  selection (power sums, as in the linear scan)
+   *
+   *  \param[in]     image       the image to search for
+   *  \param[in,out] neighbors   the k nearest so far
+   *  \param[in,out] statistics  counts to add this search's to (skipped
+   *                             are the training images never compared)
+   */
+  void Nearest(const unsigned char* image, TopK& neighbors,
+               KnnStatistics& statistics) const;
+
+ private:
+  // Best-first search state: nodes already reached during one search
+  // (marked with the search's generation, so reusable across searches)
+  struct Visited {
+    std::vector<std::uint32_t> marks;
+    std::uint32_t generation = 0;
+  };
+
+  double PowerSum(const unsigned char* image, const std::uint32_t node) const;
+  int MaximumLinks(const int level) const;
+  std::uint32_t* Links(const std::uint32_t node, const int level);
+  const std::uint32_t* Links(const std::uint32_t node, const int level) const;
+
+  std::uint32_t Greedy(const unsigned char* image, std::uint32_t entry,
+                       const int level, std::size_t& evaluations) const;
+  std::vector<Neighbor> SearchLayer(const unsigned char* image,
+                                    const std::vector<Neighbor>& entries,
+                                    const std::size_t ef, const int level,
+                                    Visited& visited,
+                                    std::size_t& evaluations) const;
+  std::vector<Neighbor> SelectNeighbors(std::vector<Neighbor> candidates,
+                                        const int maximum) const;
+  void Connect(const std::uint32_t node, const std::uint32_t neighbor,
+               const int level);
+  void Insert(const std::uint32_t node, Visited& visited);
+
+  PackedDataset training_images_;
+  MinkowskiKernel kernel_{2};
+  HnswParameters parameters_;
+
+  // Layer of every node, the single entry node on the top layer, and the
+  // links as [count, link...] blocks: MaximumLinks(0) + 1 values per node on
+  // layer 0, and MaximumLinks(1) + 1 per node and upper layer it is on
+  std::vector<int> levels_;
+  int top_level_ = -1;
+  std::uint32_t entry_ = 0;
+  std::vector<std::uint32_t> base_links_;
+  std::vector<std::vector<std::uint32_t>> upper_links_;
+};
+}
@@ -9,18 +9,113 @@
 #include <iostream>
 #include <vector>
 #include <cmath>
+#include <cstdint>
+#include <cstdlib>
 #include <map>
 #include <algorithm>
+#include <memory>
 
 #include <opencv2/core.hpp>
 
 #include "imgs/statistics/classifiers/Knn.h"
+#include "imgs/statistics/classifiers/HammingKernels.h"
+#include "imgs/statistics/classifiers/Hnsw.h"
+#include "imgs/statistics/classifiers/KnnClassifier.h"
+#include "imgs/statistics/classifiers/MinkowskiKernels.h"
+#include "imgs/statistics/classifiers/NibbleKernels.h"
+#include "imgs/statistics/classifiers/ProductQuantizer.h"
+#include "imgs/statistics/classifiers/PrunedSearch.h"
+#include "imgs/statistics/classifiers/TopK.h"
 #include "imgs/statistics/data_readers/Mnist.h"
+#include "imgs/statistics/parallel/ThreadPool.h"
 #include "imgs/statistics/minkowski_distance/MinkowskiDistance.h"  // Include the MinkowskiDistance header
 
 
 namespace statistics {
 
+namespace {
+
+//check a labeled training set (anything with has_labels(), dimension()
+//and size()) against the test image size and k
+template <typename Training>
+bool IsValidTraining(const std::size_t test_dimension,
+                     const Training& training, const int k) {
+  if (!training.has_labels()) {
+    std::cerr << "Training images have no labels!" << std::endl;
+    return false;
+  }
+  if (test_dimension != training.dimension()) {
+    std::cerr << "Test and training image size mismatch!" << std::endl;
+    return false;
+  }
+  if (k < 1 || static_cast<std::size_t>(k) > training.size()) {
+    std::cerr << "k must be between 1 and the number of training images!"
+              << std::endl;
+    return false;
+  }
+  return true;
+}
+
+//classify every test image from the k nearest training images that
+//nearest(t, neighbors, statistics, worker) selects for it, splitting only
+//the test images across threads
+template <typename Training, typename Nearest>
+std::vector<unsigned char> ClassifyEach(const std::size_t number_tests,
+                                        const Training& training, const int k,
+                                        const KnnOptions& options,
+                                        const Nearest& nearest) {
+  std::vector<unsigned char> predicted_test_labels(number_tests, 0);
+
+  unsigned int number_threads = (options.number_threads == 0)
+                                    ? ThreadPool::HardwareThreads()
+                                    : options.number_threads;
+  number_threads = std::max(number_threads, 1u);
+
+  std::vector<TopK> neighbors(number_threads, TopK(k));
+  std::vector<KnnStatistics> worker_statistics(number_threads);
+  auto classify = [&](std::size_t begin, std::size_t end,
+                      unsigned int worker) {
+    for (std::size_t t = begin; t < end; ++t) {
+      neighbors[worker].Clear();
+      nearest(t, neighbors[worker], worker_statistics[worker], worker);
+      predicted_test_labels[t] = Vote(neighbors[worker], training);
+    }
+  };
+  if (number_threads == 1) {
+    classify(0, number_tests, 0);
+  } else {
+    ThreadPool pool(number_threads);
+    pool.ParallelFor(0, number_tests, 1, classify);
+  }
+
+  if (options.statistics != nullptr) {
+    for (const auto& statistics : worker_statistics) {
+      options.statistics->Add(statistics);
+    }
+  }
+  return predicted_test_labels;
+}
+
+//classify with any prebuilt index of a labeled training set (an index
+//offers the neighbors of one image through Nearest())
+template <typename Index>
+std::vector<unsigned char> IndexKnn(const PackedDataset& test_images,
+                                    const Index& index, const int k,
+                                    const KnnOptions& options) {
+  const PackedDataset& training_images = index.training_images();
+  if (!IsValidTraining(test_images.dimension(), training_images, k)) {
+    return std::vector<unsigned char>();
+  }
+  return ClassifyEach(
+      test_images.size(), training_images, k, options,
+      [&](std::size_t t, TopK& neighbors, KnnStatistics& statistics,
+          unsigned int) {
+        index.Nearest(test_images.ptr(t), neighbors, statistics);
+      });
+}
+
+}  // namespace
+
 //flatten a cv::Mat image into a 1D vector of doubles.
 std::vector<double> FlattenImage(const cv::Mat& image) {
   std::vector<double> flattened(image.rows * image.cols);
@@ -48,6 +143,30 @@ std::vector<unsigned char> Knn(
     return predicted_test_labels;
   }
 
+  //8-bit single channel images of one size go through the packed path,
+  //which also honors a non-integer order p
+  if (!test_images.empty() && !training_images.empty()) {
+    const cv::Size image_size = training_images.front().size();
+    auto is_packable = [&image_size](const cv::Mat& image) {
+      return image.type() == CV_8UC1 && image.size() == image_size;
+    };
+    if (std::all_of(test_images.begin(), test_images.end(), is_packable) &&
+        std::all_of(training_images.begin(), training_images.end(),
+                    is_packable)) {
+      PackedDataset packed_test_images = PackImages(test_images);
+      PackedDataset packed_training_images =
+          PackImages(training_images, training_labels);
+
+      //thresholded characters rank identically by Hamming distance for
+      //every p, so they are compared one bit per pixel
+      if (IsBinary(packed_test_images) && IsBinary(packed_training_images)) {
+        return Knn(PackBinary(packed_test_images),
+                   PackBinary(packed_training_images), k);
+      }
+      return Knn(packed_test_images, packed_training_images, k, p);
+    }
+  }
+
   //test image processing
   for (const auto& test_image : test_images) {
     // Vector to store distances and their corresponding training labels
@@ -89,5 +208,121 @@ std::vector<unsigned char> Knn(
   return predicted_test_labels;
 }
 
-} 
+//k-NN Classifier over packed data sets: all of the work is done by a
+//classifier fitted for this one call.
+std::vector<unsigned char> Knn(const PackedDataset& test_images,
+                               const PackedDataset& training_images,
+                               const int k, const double p,
+                               const KnnOptions& options) {
+  KnnClassifier classifier(k, p, options);
+  if (!classifier.Fit(training_images)) {
+    return std::vector<unsigned char>();
+  }
+  return classifier.PredictBatch(test_images);
+}
+
+//k-NN Classifier over a vantage point tree of the training set.
+std::vector<unsigned char> Knn(const PackedDataset& test_images,
+                               const VpTree& index, const int k,
+                               const KnnOptions& options) {
+  return IndexKnn(test_images, index, k, options);
+}
 
+//k-NN Classifier over an HNSW graph of the training set.
+std::vector<unsigned char> Knn(const PackedDataset& test_images,
+                               const HnswIndex& index, const int k,
+                               const KnnOptions& options) {
+  return IndexKnn(test_images, index, k, options);
+}
+
+//k-NN Classifier in a principal component space of the training set.
+std::vector<unsigned char> Knn(const PackedDataset& test_images,
+                               const PcaIndex& index, const int k,
+                               const KnnOptions& options) {
+  return IndexKnn(test_images, index, k, options);
+}
+
+//k-NN Classifier shortlisting at low resolution, ranking at full resolution.
+std::vector<unsigned char> Knn(const PackedDataset& test_images,
+                               const CascadeIndex& index, const int k,
+                               const KnnOptions& options) {
+  return IndexKnn(test_images, index, k, options);
+}
+
+//k-NN Classifier over bit-packed binary images by Hamming distance.
+std::vector<unsigned char> Knn(const BinaryDataset& test_images,
+                               const BinaryDataset& training_images,
+                               const int k, const KnnOptions& options) {
+  if (!IsValidTraining(test_images.dimension(), training_images, k)) {
+    return std::vector<unsigned char>();
+  }
+
+  //(distance, index) ordering as in the 8-bit scan, so the labels match it
+  const HammingKernel kernel(training_images.words());
+  return ClassifyEach(
+      test_images.size(), training_images, k, options,
+      [&](std::size_t t, TopK& neighbors, KnnStatistics&, unsigned int) {
+        const std::uint64_t* test_ptr = test_images.ptr(t);
+        for (std::size_t i = 0; i < training_images.size(); ++i) {
+          neighbors.Push(kernel.Distance(test_ptr, training_images.ptr(i)),
+                         i);
+        }
+      });
+}
+
+//k-NN Classifier over 4-bit quantized images.
+std::vector<unsigned char> Knn(const NibbleDataset& test_images,
+                               const NibbleDataset& training_images,
+                               const int k, const double p,
+                               const KnnOptions& options) {
+  if (!IsValidTraining(test_images.dimension(), training_images, k)) {
+    return std::vector<unsigned char>();
+  }
+  if (p < 1) {
+    std::cerr << "The Minkowski order p must be at least 1!" << std::endl;
+    return std::vector<unsigned char>();
+  }
+
+  const NibbleKernel kernel(p);
+  return ClassifyEach(
+      test_images.size(), training_images, k, options,
+      [&](std::size_t t, TopK& neighbors, KnnStatistics&, unsigned int) {
+        const unsigned char* test_ptr = test_images.ptr(t);
+        for (std::size_t i = 0; i < training_images.size(); ++i) {
+          neighbors.Push(kernel.PowerSum(test_ptr, training_images.ptr(i),
+                                         training_images.stride()),
+                         i);
+        }
+      });
+}
+
+//k-NN Classifier over a product-quantized training store.
+std::vector<unsigned char> Knn(const PackedDataset& test_images,
+                               const ProductQuantizer& quantizer, const int k,
+                               const double p, const KnnOptions& options) {
+  if (!IsValidTraining(test_images.dimension(), quantizer, k)) {
+    return std::vector<unsigned char>();
+  }
+  if (p < 1) {
+    std::cerr << "The Minkowski order p must be at least 1!" << std::endl;
+    return std::vector<unsigned char>();
+  }
+
+  //one distance table per test image, built in the worker's own buffer
+  unsigned int number_threads = (options.number_threads == 0)
+                                    ? ThreadPool::HardwareThreads()
+                                    : options.number_threads;
+  std::vector<std::vector<double>> tables(std::max(number_threads, 1u));
+  return ClassifyEach(
+      test_images.size(), quantizer, k, options,
+      [&](std::size_t t, TopK& neighbors, KnnStatistics&,
+          unsigned int worker) {
+        std::vector<double>& table = tables[worker];
+        quantizer.DistanceTable(test_images.ptr(t), p, table);
+        for (std::size_t i = 0; i < quantizer.size(); ++i) {
+          neighbors.Push(quantizer.AsymmetricPowerSum(table.data(), i), i);
+        }
+      });
+}
+
+}
@@ -12,8 +12,60 @@
 
 #include <opencv2/opencv.hpp>
 
+#include "imgs/statistics/classifiers/Cascade.h"
+#include "imgs/statistics/classifiers/Hnsw.h"
+#include "imgs/statistics/classifiers/Pca.h"
+#include "imgs/statistics/classifiers/ProductQuantizer.h"
+#include "imgs/statistics/classifiers/PrunedSearch.h"
+#include "imgs/statistics/classifiers/VpTree.h"
+#include "imgs/statistics/data_readers/BinaryDataset.h"
+#include "imgs/statistics/data_readers/NibbleDataset.h"
+#include "imgs/statistics/data_readers/PackedDataset.h"
+
 namespace statistics {
 
+/** Execution options for the packed k-NN classifier
+ */
+struct KnnOptions {
+  /// Number of threads to classify with (1 runs serially on the calling
+  /// thread, 0 uses one thread per hardware thread).  Every setting gives
+  /// bit-identical results: the work is split across the test images, or
+  /// across shards of the training set when there are too few test images
+  /// to occupy every thread, and distance ties are always broken in favor
+  /// of the lower training index.
+  unsigned int number_threads = 1;
+
+  /// For p = 2, compute the distances of whole blocks of test images at once
+  /// as ||a||^2 + ||b||^2 - 2 a.b, using the squared norms cached when the
+  /// data sets were loaded and a cache-blocked integer matrix multiply.
+  /// The arithmetic is exact, so the classification is unchanged; it pays
+  /// off for large test sets rather than a single plate.  Images larger
+  /// than kMaximumNormDimension pixels take the scalar scan instead.
+  bool batched_l2 = false;
+
+  /// Prune the search: visit the training images in order of their pixel
+  /// sum, reject candidates whose lower bounds (from the cached pixel sums,
+  /// row sums and norms) exceed the current k-th nearest distance, and
+  /// abandon a distance once its partial sum does.  The search stays exact,
+  /// so the classification is unchanged.  Ignored when batched_l2 applies.
+  bool prune = false;
+
+  /// Classify whole blocks of test images against cache-sized tiles of the
+  /// training set, keeping each test image's k nearest across the tiles,
+  /// so that every tile is streamed from memory once per block instead of
+  /// once per test image.  Works for every order p; orders without a
+  /// vectorized kernel also abandon a power sum once it exceeds the test
+  /// image's current k-th nearest.  The search stays exact, so the
+  /// classification is unchanged.  Ignored when
+  /// batched_l2 or prune applies, or when there are too few test images to
+  /// give every thread a block.
+  bool tiled = false;
+
+  /// If not nullptr, the counts of the pruned search are added to it (e.g.
+  /// to report the pruning rate)
+  KnnStatistics* statistics = nullptr;
+};
+
 /** Perform k-NN classification
  *
  *  \param[in] test_images      vector containing the images to be classified
@@ -30,7 +82,12 @@ namespace statistics {
  *                              p = 2 represents the Euclidean distance
  *                              or L2-norm; both of these choices will trigger
  *                              the use of the cv::norm() routine and will
- *                              run significantly faster than any other order)
+ *                              run significantly faster than any other order;
+ *                              CV_8UC1 images of one size are classified on
+ *                              the packed path, which also supports
+ *                              non-integer orders, and 0/255 images by
+ *                              Hamming distance, which ranks them the same
+ *                              for every order)
  *                              [default is 2]
  *  \return                     vector containing the enumerated labels for
  *                              each of the classified test images
@@ -40,4 +97,182 @@ std::vector<unsigned char> Knn(
     const std::vector<cv::Mat>& training_images,
     const std::vector<unsigned char>& training_labels, const int k,
     const double p = 2);
+
+/** Perform k-NN classification on packed data sets
+ *
+ *  The training set is scanned linearly, one contiguous image row at a
+ *  time, with the Minkowski distance evaluated directly on the 8-bit
+ *  pixels (no per-pair cv::norm() dispatch and no per-image allocation).
+ *  This fits a KnnClassifier for the one call; to classify repeatedly
+ *  against the same training set, fit one once and keep it.
+ *
+ *  \param[in] test_images      packed data set containing the images to be
+ *                              classified (labels, if any, are ignored)
+ *  \param[in] training_images  packed data set containing the images and
+ *                              enumerated labels to be used as training
+ *                              data
+ *  \param[in] k                the number of neighbors to be considered in
+ *                              the majority vote for class assignment
+ *  \param[in] p                the order to use in the computation of the
+ *                              Lp-norm (Minkowski distance); non-integer
+ *                              orders (e.g. 2.5) are supported
+ *                              [default is 2]
+ *  \param[in] options          execution options [default is serial]
+ *  \return                     vector containing the enumerated labels for
+ *                              each of the classified test images
+ */
+std::vector<unsigned char> Knn(const PackedDataset& test_images,
+                               const PackedDataset& training_images,
+                               const int k, const double p = 2,
+                               const KnnOptions& options = KnnOptions());
+
+/** Perform k-NN classification with a prebuilt metric index
+ *
+ *  The neighbors, and so the labels, are exactly those of the linear scan
+ *  with the order p the index was built for.
+ *
+ *  \param[in] test_images  packed data set containing the images to be
+ *                          classified (labels, if any, are ignored)
+ *  \param[in] index        vantage point tree over the labeled training
+ *                          images
+ *  \param[in] k            the number of neighbors to be considered in the
+ *                          majority vote for class assignment
+ *  \param[in] options      execution options (number_threads and
+ *                          statistics are honored) [default is serial]
+ *  \return                 vector containing the enumerated labels for
+ *                          each of the classified test images
+ */
+std::vector<unsigned char> Knn(const PackedDataset& test_images,
+                               const VpTree& index, const int k,
+                               const KnnOptions& options = KnnOptions());
+
+/** Perform approximate k-NN classification with a prebuilt HNSW graph
+ *
+ *  Only a small part of the training set is compared against, so a true
+ *  neighbor is occasionally missed; the index's efSearch trades recall for
+ *  latency.
+ *
+ *  \param[in] test_images  packed data set containing the images to be
+ *                          classified (labels, if any, are ignored)
+ *  \param[in] index        HNSW graph over the labeled training images
+ *  \param[in] k            the number of neighbors to be considered in the
+ *                          majority vote for class assignment
+ *  \param[in] options      execution options (number_threads and
+ *                          statistics are honored) [default is serial]
+ *  \return                 vector containing the enumerated labels for
+ *                          each of the classified test images
+ */
+std::vector<unsigned char> Knn(const PackedDataset& test_images,
+                               const HnswIndex& index, const int k,
+                               const KnnOptions& options = KnnOptions());
+
+/** Perform k-NN classification in a principal component space
+ *
+ *  The training images are ranked by the squared L2 distance between the
+ *  projections, and, if the index re-ranks, its nearest candidates by their
+ *  exact pixel-space power sums of the index's order.
+ *
+ *  \param[in] test_images  packed data set containing the images to be
+ *                          classified (labels, if any, are ignored); they
+ *                          are projected with the index's projection
+ *  \param[in] index        projected labeled training images
+ *  \param[in] k            the number of neighbors to be considered in the
+ *                          majority vote for class assignment
+ *  \param[in] options      execution options (number_threads and
+ *                          statistics are honored) [default is serial]
+ *  \return                 vector containing the enumerated labels for
+ *                          each of the classified test images
+ */
+std::vector<unsigned char> Knn(const PackedDataset& test_images,
+                               const PcaIndex& index, const int k,
+                               const KnnOptions& options = KnnOptions());
+
+/** Perform coarse-to-fine k-NN classification
+ *
+ *  The training images are shortlisted by the power sum of their block
+ *  sums, and the shortlist is ranked by the full-resolution power sums of
+ *  the index's order.
+ *
+ *  \param[in] test_images  packed data set containing the images to be
+ *                          classified (labels, if any, are ignored)
+ *  \param[in] index        downsampled labeled training images
+ *  \param[in] k            the number of neighbors to be considered in the
+ *                          majority vote for class assignment
+ *  \param[in] options      execution options (number_threads and
+ *                          statistics are honored) [default is serial]
+ *  \return                 vector containing the enumerated labels for
+ *                          each of the classified test images
+ */
+std::vector<unsigned char> Knn(const PackedDataset& test_images,
+                               const CascadeIndex& index, const int k,
+                               const KnnOptions& options = KnnOptions());
+
+/** Perform k-NN classification of bit-packed binary images
+ *
+ *  Neighbors are ranked by Hamming distance (a popcount per 64 pixels),
+ *  which for thresholded images gives the same neighbors, and so the same
+ *  labels, as the packed classifier with any order p.
+ *
+ *  \param[in] test_images      bit-packed data set containing the images to
+ *                              be classified (labels, if any, are ignored)
+ *  \param[in] training_images  bit-packed data set containing the images
+ *                              and enumerated labels to be used as training
+ *                              data
+ *  \param[in] k                the number of neighbors to be considered in
+ *                              the majority vote for class assignment
+ *  \param[in] options          execution options (number_threads is
+ *                              honored) [default is serial]
+ *  \return                     vector containing the enumerated labels for
+ *                              each of the classified test images
+ */
+std::vector<unsigned char> Knn(const BinaryDataset& test_images,
+                               const BinaryDataset& training_images,
+                               const int k,
+                               const KnnOptions& options = KnnOptions());
+
+/** Perform k-NN classification of 4-bit quantized images
+ *
+ *  Distances are taken between the 4-bit levels, so the neighbors are those
+ *  of the packed classifier on the Quantize()d (4-bit depth) images.
+ *
+ *  \param[in] test_images      nibble-packed data set containing the images
+ *                              to be classified (labels, if any, are
+ *                              ignored)
+ *  \param[in] training_images  nibble-packed data set containing the images
+ *                              and enumerated labels to be used as training
+ *                              data
+ *  \param[in] k                the number of neighbors to be considered in
+ *                              the majority vote for class assignment
+ *  \param[in] p                the order to use in the computation of the
+ *                              Lp-norm (Minkowski distance) [default is 2]
+ *  \param[in] options          execution options (number_threads is
+ *                              honored) [default is serial]
+ *  \return                     vector containing the enumerated labels for
+ *                              each of the classified test images
+ */
+std::vector<unsigned char> Knn(const NibbleDataset& test_images,
+                               const NibbleDataset& training_images,
+                               const int k, const double p = 2,
+                               const KnnOptions& options = KnnOptions());
+
+/** Perform approximate k-NN classification against a product-quantized
+ *  training store, with asymmetric distances (exact test pixels against
+ *  the training images' centroids)
+ *
+ *  \param[in] test_images  packed data set containing the images to be
+ *                          classified (labels, if any, are ignored)
+ *  \param[in] quantizer    product-quantized labeled training images
+ *  \param[in] k            the number of neighbors to be considered in the
+ *                          majority vote for class assignment
+ *  \param[in] p            the order to use in the computation of the
+ *                          Lp-norm (Minkowski distance) [default is 2]
+ *  \param[in] options      execution options (number_threads is honored)
+ *                          [default is serial]
+ *  \return                 vector containing the enumerated labels for
+ *                          each of the classified test images
+ */
+std::vector<unsigned char> Knn(const PackedDataset& test_images,
+                               const ProductQuantizer& quantizer, const int k,
+                               const double p = 2,
+                               const KnnOptions& options = KnnOptions());
 }
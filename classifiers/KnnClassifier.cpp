@@ -0,0 +1,631 @@
+/** Implementation file for the k-NN classifier with prepared training
+ *  state.
+ *
+ *  \file statistics/classifiers/KnnClassifier.cpp
+ *  \date 17 Oct 2026
+ */
+
+#include "imgs/statistics/classifiers/KnnClassifier.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include "imgs/statistics/classifiers/L2Gemm.h"
+#include "imgs/statistics/classifiers/MinkowskiKernels.h"
+#include "imgs/statistics/classifiers/PrunedSearch.h"
+#include "imgs/statistics/classifiers/TiledSearch.h"
+#include "imgs/statistics/parallel/ThreadPool.h"
+
+namespace statistics {
+
+namespace {
+
+// Test images per worker needed before the queries alone are split
+constexpr std::size_t kQueriesPerThread = 4;
+
+// Chunks dealt to each worker so stealing can even out the load
+constexpr std::size_t kChunksPerThread = 8;
+
+// Smallest training shard worth a task of its own
+constexpr std::size_t kMinimumShardSize = 1024;
+
+// Offer every training image in [begin, end) to the bounded selection
+void NearestInRange(const unsigned char* test_ptr,
+                    const PackedDataset& training_images,
+                    const std::size_t begin, const std::size_t end,
+                    const MinkowskiKernel& kernel, TopK& neighbors) {
+  const std::size_t number_pixels = training_images.dimension();
+  for (std::size_t i = begin; i < end; ++i) {
+    neighbors.Push(
+        kernel.PowerSum(test_ptr, training_images.ptr(i), number_pixels), i);
+  }
+}
+
+// The k nearest training images of each test image in [begin, end) (at
+// most kGemmTestBlock of them) from the batched L2 engine; the squared
+// distances are the same exact integers the L2 kernel produces
+void BatchedL2Nearest(const PackedDataset& test_images,
+                      const std::size_t begin, const std::size_t end,
+                      const PackedDataset& training_images, const int k,
+                      L2GemmEngine& engine, std::vector<std::uint32_t>& tile,
+                      std::vector<TopK>& neighbors) {
+  const std::size_t number_training = training_images.size();
+  engine.LoadTestBlock(test_images, begin, end);
+  tile.resize(kGemmTestBlock * kGemmTrainingBlock);
+  neighbors.resize(kGemmTestBlock);
+  for (auto& selection : neighbors) {
+    selection.Reset(k);
+  }
+
+  for (std::size_t tile_begin = 0; tile_begin < number_training;
+       tile_begin += kGemmTrainingBlock) {
+    std::size_t tile_end =
+        std::min(tile_begin + kGemmTrainingBlock, number_training);
+    std::size_t width = tile_end - tile_begin;
+    engine.SquaredDistances(tile_begin, tile_end, tile.data());
+
+    // Fold the tile into each test image's running k nearest
+    for (std::size_t t = 0; t < end - begin; ++t) {
+      const std::uint32_t* row = tile.data() + t * width;
+      for (std::size_t j = 0; j < width; ++j) {
+        neighbors[t].Push(static_cast<double>(row[j]), tile_begin + j);
+      }
+    }
+  }
+}
+
+// Training set storage that grows geometrically as images are inserted:
+// pixels and labels for capacity images, and their statistics
+struct TrainingStore {
+  TrainingStore(const std::size_t capacity, const int rows, const int cols)
+      : images(capacity, rows, cols),
+        squared_norms(capacity),
+        pixel_sums(capacity),
+        row_sums(capacity * rows) {}
+
+  std::size_t capacity() const { return images.size(); }
+
+  PackedDataset images;
+  std::vector<std::uint32_t> squared_norms;
+  std::vector<std::uint32_t> pixel_sums;
+  std::vector<std::uint32_t> row_sums;
+};
+
+// Smallest capacity a store is created with
+constexpr std::size_t kMinimumStoreCapacity = 64;
+
+// The statistics of one stored image, as PackedDataset::ComputeStatistics()
+// computes them
+void ComputeImageStatistics(TrainingStore& store, const std::size_t idx) {
+  const int rows = store.images.rows();
+  const int cols = store.images.cols();
+  const unsigned char* image = store.images.ptr(idx);
+  std::uint32_t squared_norm = 0;
+  std::uint32_t pixel_sum = 0;
+  for (int r = 0; r < rows; ++r) {
+    std::uint32_t row_sum = 0;
+    for (int c = 0; c < cols; ++c) {
+      std::uint32_t pixel = image[r * cols + c];
+      squared_norm += pixel * pixel;
+      row_sum += pixel;
+    }
+    store.row_sums[idx * rows + r] = row_sum;
+    pixel_sum += row_sum;
+  }
+  store.squared_norms[idx] = squared_norm;
+  store.pixel_sums[idx] = pixel_sum;
+}
+
+// A store of the given capacity holding a copy of a data set's images
+std::shared_ptr<TrainingStore> CopyToStore(const PackedDataset& images,
+                                           const std::size_t capacity) {
+  auto store = std::make_shared<TrainingStore>(capacity, images.rows(),
+                                               images.cols());
+  const std::size_t number_images = images.size();
+  const int rows = images.rows();
+  for (std::size_t idx = 0; idx < number_images; ++idx) {
+    std::memcpy(store->images.ptr(idx), images.ptr(idx), images.dimension());
+    store->images.labels()[idx] = images.label(idx);
+    if (images.has_statistics()) {
+      store->squared_norms[idx] = images.squared_norms()[idx];
+      store->pixel_sums[idx] = images.pixel_sums()[idx];
+      std::copy(images.row_sums(idx), images.row_sums(idx) + rows,
+                store->row_sums.begin() + idx * rows);
+    } else {
+      ComputeImageStatistics(*store, idx);
+    }
+  }
+  return store;
+}
+
+// The first number_images images of a store as a data set (which keeps the
+// store alive)
+PackedDataset StoreView(const std::shared_ptr<TrainingStore>& store,
+                        const std::size_t number_images) {
+  PackedDataset view(number_images, store->images.rows(),
+                     store->images.cols(), store->images.ptr(0),
+                     store->images.stride(), store->images.labels(), store);
+  view.SetStatistics(store->squared_norms.data(), store->pixel_sums.data(),
+                     store->row_sums.data(), store);
+  return view;
+}
+
+}  // namespace
+
+struct KnnClassifier::State {
+  State(const PackedDataset& training, const double p,
+        const unsigned int threads)
+      : training_images(training),
+        kernel(p, training.rows(), training.cols()),
+        number_threads(std::max(threads, 1u)),
+        neighbors(number_threads),
+        worker_statistics(number_threads),
+        image(training.dimension()) {}
+
+  // The training set (with its statistics) and the distance kernel
+  PackedDataset training_images;
+  MinkowskiKernel kernel;
+  std::unique_ptr<PrunedSearch> pruned_search;
+
+  // Worker threads (none when classifying serially), and per worker its
+  // k nearest, its search counts, (for batched L2) its engine and tile,
+  // and (for batched L2 and the tiled search) its block of selections
+  unsigned int number_threads;
+  std::unique_ptr<ThreadPool> pool;
+  std::vector<TopK> neighbors;
+  std::vector<KnnStatistics> worker_statistics;
+  std::vector<std::unique_ptr<L2GemmEngine>> engines;
+  std::vector<std::vector<std::uint32_t>> tiles;
+  std::vector<std::vector<TopK>> block_neighbors;
+  bool use_tiles = false;
+
+  // The classifier's own growable copy of the training set, made by the
+  // first Insert() or Remove() (training_images is then a view of it)
+  std::shared_ptr<TrainingStore> store;
+
+  // Per-shard selections of a few test images split across the training
+  // set, and a contiguous copy of a non-continuous cv::Mat
+  std::vector<TopK> shard_neighbors;
+  TopK merged;
+  std::vector<unsigned char> image;
+};
+
+KnnClassifier::KnnClassifier(const int k, const double p,
+                             const KnnOptions& options)
+    : k_(k), p_(p), options_(options) {}
+
+KnnClassifier::~KnnClassifier() = default;
+KnnClassifier::KnnClassifier(KnnClassifier&& other) noexcept = default;
+KnnClassifier& KnnClassifier::operator=(KnnClassifier&& other) noexcept =
+    default;
+
+bool KnnClassifier::Fit(const PackedDataset& training_images) {
+  state_.reset();
+
+  // Argument checking
+  if (!training_images.has_labels()) {
+    std::cerr << "Training images have no labels!" << std::endl;
+    return false;
+  }
+  if (k_ < 1 || static_cast<std::size_t>(k_) > training_images.size()) {
+    std::cerr << "k must be between 1 and the number of training images!"
+              << std::endl;
+    return false;
+  }
+  if (p_ < 1) {
+    std::cerr << "The Minkowski order p must be at least 1!" << std::endl;
+    return false;
+  }
+
+  const unsigned int number_threads = (options_.number_threads == 0)
+                                          ? ThreadPool::HardwareThreads()
+                                          : options_.number_threads;
+  std::unique_ptr<State> state(
+      new State(training_images, p_, number_threads));
+
+  // The batched and pruned searches need the per-image statistics, which
+  // the readers normally compute at load time (the copy shares the pixels);
+  // the batched L2 search is only exact while the squared norms fit in 32
+  // bits, and larger images take the scalar scan
+  const bool use_batched_l2 =
+      options_.batched_l2 && p_ == 2 &&
+      training_images.dimension() <= kMaximumNormDimension;
+  const bool use_pruning = options_.prune && !use_batched_l2;
+  if ((use_batched_l2 || use_pruning) &&
+      !state->training_images.has_statistics()) {
+    state->training_images.ComputeStatistics();
+  }
+  if (use_pruning) {
+    state->pruned_search.reset(
+        new PrunedSearch(state->training_images, state->kernel));
+  }
+  state->use_tiles = options_.tiled && !use_batched_l2 && !use_pruning;
+  if (use_batched_l2 || state->use_tiles) {
+    state->block_neighbors.resize(state->number_threads);
+  }
+  if (use_batched_l2) {
+    state->tiles.resize(state->number_threads);
+    for (unsigned int worker = 0; worker < state->number_threads; ++worker) {
+      state->engines.emplace_back(new L2GemmEngine(state->training_images));
+    }
+  }
+  if (state->number_threads > 1) {
+    state->pool.reset(new ThreadPool(state->number_threads));
+  }
+  for (auto& selection : state->neighbors) {
+    selection.Reset(k_);
+  }
+  state->merged.Reset(k_);
+
+  state_ = std::move(state);
+  return true;
+}
+
+const PackedDataset& KnnClassifier::training_images() const {
+  static const PackedDataset kEmpty;
+  return state_ ? state_->training_images : kEmpty;
+}
+
+void KnnClassifier::Nearest(const unsigned char* image) {
+  TopK& neighbors = state_->neighbors[0];
+  neighbors.Clear();
+  if (state_->pruned_search) {
+    state_->pruned_search->Nearest(image, neighbors,
+                                   state_->worker_statistics[0]);
+    if (options_.statistics != nullptr) {
+      options_.statistics->Add(state_->worker_statistics[0]);
+      state_->worker_statistics[0] = KnnStatistics();
+    }
+  } else {
+    NearestInRange(image, state_->training_images, 0,
+                   state_->training_images.size(), state_->kernel,
+                   neighbors);
+  }
+}
+
+void KnnClassifier::Reserve(const std::size_t number_images) {
+  State& state = *state_;
+  const std::size_t size = state.training_images.size();
+  if (state.store && state.store->capacity() >= number_images) {
+    return;
+  }
+
+  // Grow geometrically, so that a sequence of insertions copies each image
+  // a constant number of times on average
+  const std::size_t capacity = std::max(
+      {number_images, 2 * size, kMinimumStoreCapacity});
+  state.store = CopyToStore(state.training_images, capacity);
+  state.training_images = StoreView(state.store, size);
+}
+
+bool KnnClassifier::Insert(const unsigned char* image,
+                           const unsigned char label) {
+  if (!state_) {
+    std::cerr << "The classifier has not been fitted!" << std::endl;
+    return false;
+  }
+  State& state = *state_;
+  const std::size_t idx = state.training_images.size();
+  Reserve(idx + 1);
+
+  TrainingStore& store = *state.store;
+  std::memcpy(store.images.ptr(idx), image, store.images.dimension());
+  store.images.labels()[idx] = label;
+  ComputeImageStatistics(store, idx);
+  state.training_images = StoreView(state.store, idx + 1);
+  if (state.pruned_search) {
+    state.pruned_search->Insert(idx);
+  }
+  return true;
+}
+
+bool KnnClassifier::Insert(const cv::Mat& image, const unsigned char label) {
+  if (!state_) {
+    std::cerr << "The classifier has not been fitted!" << std::endl;
+    return false;
+  }
+  const PackedDataset& training = state_->training_images;
+  if (image.type() != CV_8UC1 || image.rows != training.rows() ||
+      image.cols != training.cols()) {
+    std::cerr << "Training images must be CV_8UC1 and " << training.rows()
+              << "x" << training.cols() << std::endl;
+    return false;
+  }
+  if (image.isContinuous()) {
+    return Insert(image.ptr<uchar>(0), label);
+  }
+  for (int r = 0; r < image.rows; ++r) {
+    std::memcpy(state_->image.data() + r * image.cols, image.ptr<uchar>(r),
+                image.cols);
+  }
+  return Insert(state_->image.data(), label);
+}
+
+bool KnnClassifier::Remove(const std::size_t idx) {
+  if (!state_) {
+    std::cerr << "The classifier has not been fitted!" << std::endl;
+    return false;
+  }
+  State& state = *state_;
+  const std::size_t size = state.training_images.size();
+  if (idx >= size) {
+    std::cerr << "No training image " << idx << " to remove!" << std::endl;
+    return false;
+  }
+  if (size - 1 < static_cast<std::size_t>(k_)) {
+    std::cerr << "Removing a training image would leave fewer than k!"
+              << std::endl;
+    return false;
+  }
+  Reserve(size);
+
+  // The last image moves into the removed one's place
+  const std::size_t last = size - 1;
+  if (state.pruned_search) {
+    state.pruned_search->Remove(idx, last);
+  }
+  TrainingStore& store = *state.store;
+  if (idx != last) {
+    const int rows = store.images.rows();
+    std::memcpy(store.images.ptr(idx), store.images.ptr(last),
+                store.images.stride());
+    store.images.labels()[idx] = store.images.labels()[last];
+    store.squared_norms[idx] = store.squared_norms[last];
+    store.pixel_sums[idx] = store.pixel_sums[last];
+    std::copy(store.row_sums.begin() + last * rows,
+              store.row_sums.begin() + (last + 1) * rows,
+              store.row_sums.begin() + idx * rows);
+  }
+  state.training_images = StoreView(state.store, last);
+  return true;
+}
+
+unsigned char KnnClassifier::Predict(const unsigned char* image) {
+  if (!state_) {
+    std::cerr << "The classifier has not been fitted!" << std::endl;
+    return 0;
+  }
+  Nearest(image);
+  return Vote(state_->neighbors[0], state_->training_images);
+}
+
+unsigned char KnnClassifier::Predict(const cv::Mat& image) {
+  if (!state_) {
+    std::cerr << "The classifier has not been fitted!" << std::endl;
+    return 0;
+  }
+  const PackedDataset& training = state_->training_images;
+  if (image.type() != CV_8UC1 || image.rows != training.rows() ||
+      image.cols != training.cols()) {
+    std::cerr << "Test images must be CV_8UC1 and " << training.rows()
+              << "x" << training.cols() << std::endl;
+    return 0;
+  }
+  if (image.isContinuous()) {
+    return Predict(image.ptr<uchar>(0));
+  }
+  for (int r = 0; r < image.rows; ++r) {
+    std::memcpy(state_->image.data() + r * image.cols, image.ptr<uchar>(r),
+                image.cols);
+  }
+  return Predict(state_->image.data());
+}
+
+unsigned char KnnClassifier::PredictWithNeighbors(
+    const unsigned char* image, std::vector<Neighbor>& neighbors) {
+  neighbors.clear();
+  if (!state_) {
+    std::cerr << "The classifier has not been fitted!" << std::endl;
+    return 0;
+  }
+  Nearest(image);
+  const TopK& nearest = state_->neighbors[0];
+  for (const auto& neighbor : nearest) {
+    neighbors.push_back(Neighbor{
+        state_->kernel.DistanceFromPowerSum(neighbor.distance),
+        neighbor.index});
+  }
+  return Vote(nearest, state_->training_images);
+}
+
+std::vector<unsigned char> KnnClassifier::PredictBatch(
+    const PackedDataset& test_images) {
+  std::vector<unsigned char> labels;
+  PredictBatch(test_images, labels);
+  return labels;
+}
+
+void KnnClassifier::PredictBatch(const PackedDataset& test_images,
+                                 std::vector<unsigned char>& labels) {
+  labels.clear();
+  if (!state_) {
+    std::cerr << "The classifier has not been fitted!" << std::endl;
+    return;
+  }
+  State& state = *state_;
+  const PackedDataset& training_set = state.training_images;
+  if (test_images.dimension() != training_set.dimension()) {
+    std::cerr << "Test and training image size mismatch!" << std::endl;
+    return;
+  }
+
+  const std::size_t number_tests = test_images.size();
+  const std::size_t number_training = training_set.size();
+  labels.assign(number_tests, 0);
+
+  // The test side needs the same statistics as the training side
+  PackedDataset test_set = test_images;
+  if ((state.pruned_search || !state.engines.empty()) &&
+      !test_set.has_statistics()) {
+    test_set.ComputeStatistics();
+  }
+
+  // p = 2 for whole blocks of test images at a time, each block multiplied
+  // against cache-sized training tiles (blocks are split across threads)
+  if (!state.engines.empty()) {
+    auto classify_blocks = [&](std::size_t begin, std::size_t end,
+                               unsigned int worker) {
+      for (std::size_t block = begin; block < end; ++block) {
+        std::size_t block_begin = block * kGemmTestBlock;
+        std::size_t block_end =
+            std::min(block_begin + kGemmTestBlock, number_tests);
+        std::vector<TopK>& neighbors = state.block_neighbors[worker];
+        BatchedL2Nearest(test_set, block_begin, block_end, training_set, k_,
+                         *state.engines[worker], state.tiles[worker],
+                         neighbors);
+        for (std::size_t t = block_begin; t < block_end; ++t) {
+          labels[t] = Vote(neighbors[t - block_begin], training_set);
+        }
+      }
+    };
+
+    const std::size_t number_blocks =
+        (number_tests + kGemmTestBlock - 1) / kGemmTestBlock;
+    if (!state.pool) {
+      classify_blocks(0, number_blocks, 0);
+    } else {
+      state.pool->ParallelFor(0, number_blocks, 1, classify_blocks);
+    }
+    return;
+  }
+
+  // Add the workers' search counts to the caller's
+  auto report_statistics = [&]() {
+    for (auto& statistics : state.worker_statistics) {
+      if (options_.statistics != nullptr) {
+        options_.statistics->Add(statistics);
+      }
+      statistics = KnnStatistics();
+    }
+  };
+
+  // Blocks of test images against cache-sized training tiles, for any
+  // order (blocks are split across threads when there are enough of them)
+  const std::size_t number_tile_blocks =
+      (number_tests + kTileTestImages - 1) / kTileTestImages;
+  if (state.use_tiles &&
+      (!state.pool || number_tile_blocks >= state.pool->size())) {
+    auto classify_blocks = [&](std::size_t begin, std::size_t end,
+                               unsigned int worker) {
+      for (std::size_t block = begin; block < end; ++block) {
+        std::size_t block_begin = block * kTileTestImages;
+        std::size_t block_end =
+            std::min(block_begin + kTileTestImages, number_tests);
+        std::vector<TopK>& neighbors = state.block_neighbors[worker];
+        neighbors.resize(kTileTestImages);
+        for (auto& selection : neighbors) {
+          selection.Reset(k_);
+        }
+        TiledNearest(test_set, block_begin, block_end, training_set,
+                     training_set.size(), 0, state.kernel, neighbors.data(),
+                     state.worker_statistics[worker]);
+        for (std::size_t t = block_begin; t < block_end; ++t) {
+          labels[t] = Vote(neighbors[t - block_begin], training_set);
+        }
+      }
+    };
+
+    if (!state.pool) {
+      classify_blocks(0, number_tile_blocks, 0);
+    } else {
+      state.pool->ParallelFor(0, number_tile_blocks, 1, classify_blocks);
+    }
+    report_statistics();
+    return;
+  }
+
+  // Offer the training images [begin, end) to a test image's selection,
+  // through the pruned search if requested (counting per worker)
+  auto nearest = [&](std::size_t t, std::size_t begin, std::size_t end,
+                     TopK& neighbors, unsigned int worker) {
+    if (!state.pruned_search) {
+      NearestInRange(test_set.ptr(t), training_set, begin, end, state.kernel,
+                     neighbors);
+    } else if (begin == 0 && end == number_training) {
+      state.pruned_search->Nearest(test_set, t, neighbors,
+                                   state.worker_statistics[worker]);
+    } else {
+      state.pruned_search->NearestInRange(test_set, t, begin, end, neighbors,
+                                          state.worker_statistics[worker]);
+    }
+  };
+
+  // Serial path, one k-neighbor buffer reused for every test image
+  if (!state.pool) {
+    TopK& neighbors = state.neighbors[0];
+    for (std::size_t t = 0; t < number_tests; ++t) {
+      neighbors.Clear();
+      nearest(t, 0, number_training, neighbors, 0);
+      labels[t] = Vote(neighbors, training_set);
+    }
+    report_statistics();
+    return;
+  }
+
+  ThreadPool& pool = *state.pool;
+
+  // Enough test images to keep every worker busy: split across the queries
+  if (number_tests >= kQueriesPerThread * pool.size()) {
+    std::size_t grain = std::max<std::size_t>(
+        number_tests / (kChunksPerThread * pool.size()), 1);
+    pool.ParallelFor(
+        0, number_tests, grain,
+        [&](std::size_t begin, std::size_t end, unsigned int worker) {
+          TopK& neighbors = state.neighbors[worker];
+          for (std::size_t t = begin; t < end; ++t) {
+            neighbors.Clear();
+            nearest(t, 0, number_training, neighbors, worker);
+            labels[t] = Vote(neighbors, training_set);
+          }
+        });
+    report_statistics();
+    return;
+  }
+
+  // Only a few test images (e.g. the characters of one plate): also split
+  // the training set into shards and merge the per-shard nearest neighbors
+  std::size_t number_shards =
+      (kChunksPerThread * pool.size() + number_tests - 1) / number_tests;
+  number_shards = std::min(
+      number_shards,
+      std::max<std::size_t>(number_training / kMinimumShardSize, 1));
+  const std::size_t shard_size =
+      (number_training + number_shards - 1) / number_shards;
+  number_shards = (number_training + shard_size - 1) / shard_size;
+
+  // (the selections are kept between calls, so they are reallocated only
+  // when a call needs more of them than any before)
+  const std::size_t number_tasks = number_tests * number_shards;
+  if (state.shard_neighbors.size() < number_tasks) {
+    state.shard_neighbors.resize(number_tasks, TopK(k_));
+  }
+  pool.ParallelFor(
+      0, number_tasks, 1,
+      [&](std::size_t begin, std::size_t end, unsigned int worker) {
+        for (std::size_t task = begin; task < end; ++task) {
+          std::size_t t = task / number_shards;
+          std::size_t shard_begin = (task % number_shards) * shard_size;
+          std::size_t shard_end =
+              std::min(shard_begin + shard_size, number_training);
+          state.shard_neighbors[task].Clear();
+          nearest(t, shard_begin, shard_end, state.shard_neighbors[task],
+                  worker);
+        }
+      });
+
+  // The k nearest of the union of each shard's k nearest are the k nearest
+  // overall, and the (distance, index) order makes the merge deterministic
+  for (std::size_t t = 0; t < number_tests; ++t) {
+    state.merged.Clear();
+    for (std::size_t shard = 0; shard < number_shards; ++shard) {
+      state.merged.Merge(state.shard_neighbors[t * number_shards + shard]);
+    }
+    labels[t] = Vote(state.merged, training_set);
+  }
+  report_statistics();
+}
+}
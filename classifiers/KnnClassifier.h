@@ -0,0 +1,181 @@
+/** Interface file for a k-NN classifier that prepares its training set
+ *  once and then classifies any number of test images against it.
+ *
+ *  Fit() does all of the training-side work of the packed Knn(): it checks
+ *  the training set, computes the per-image statistics the pruned and
+ *  batched searches need, selects the distance kernel, indexes the
+ *  training set for the pruned search, starts the worker threads, and
+ *  allocates every buffer a prediction uses.  The Predict*() calls then do
+ *  no setup of their own, and classifying single images (e.g. the few
+ *  characters of one plate, many times per second) allocates nothing.
+ *
+ *  The classifications are exactly those of the packed Knn() with the same
+ *  k, p and options (which is itself a wrapper around this class).  A
+ *  classifier keeps per-call scratch space, so one instance must not be
+ *  used from several threads at once; it uses its own threads instead.
+ *
+ *  \file statistics/classifiers/KnnClassifier.h
+ *  \date 17 Oct 2026
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include <opencv2/opencv.hpp>
+
+#include "imgs/statistics/classifiers/Knn.h"
+#include "imgs/statistics/classifiers/TopK.h"
+#include "imgs/statistics/data_readers/PackedDataset.h"
+
+namespace statistics {
+
+class KnnClassifier {
+ public:
+  /** Construct an unfitted classifier
+   *
+   *  \param[in] k        the number of neighbors to be considered in the
+   *                      majority vote for class assignment [default is 1]
+   *  \param[in] p        the order to use in the computation of the
+   *                      Lp-norm (Minkowski distance); non-integer orders
+   *                      (e.g. 2.5) are supported [default is 2]
+   *  \param[in] options  execution options [default is serial]
+   */
+  explicit KnnClassifier(const int k = 1, const double p = 2,
+                         const KnnOptions& options = KnnOptions());
+  ~KnnClassifier();
+
+  KnnClassifier(KnnClassifier&& other) noexcept;
+  KnnClassifier& operator=(KnnClassifier&& other) noexcept;
+  KnnClassifier(const KnnClassifier&) = delete;
+  KnnClassifier& operator=(const KnnClassifier&) = delete;
+
+  /** Prepare a training set for classification (replacing any earlier one)
+   *
+   *  \param[in] training_images  packed data set containing the images and
+   *                              enumerated labels to be used as training
+   *                              data (the pixels are shared, not copied)
+   *  \return                     whether the training set, k and p are
+   *                              valid (the classifier is left unfitted
+   *                              otherwise)
+   */
+  bool Fit(const PackedDataset& training_images);
+
+  bool is_fitted() const { return state_ != nullptr; }
+  int k() const { return k_; }
+  double order() const { return p_; }
+  const KnnOptions& options() const { return options_; }
+
+  /// The fitted training set (empty until fitted)
+  const PackedDataset& training_images() const;
+
+  /** Add a labeled image to the fitted training set, visible to the very
+   *  next prediction
+   *
+   *  The first insertion or removal copies the training set into storage
+   *  of the classifier's own (the fitted data set is never modified), with
+   *  room to grow; its capacity then doubles whenever it fills, so an
+   *  insertion costs one image's pixels and statistics, plus (when
+   *  pruning) one insertion into the pixel-sum order, instead of a Fit().
+   *
+   *  \param[in] image  the image's pixels, row by row, in the training
+   *                    images' geometry
+   *  \param[in] label  its enumerated label
+   *  \return           whether it was added (false, with a message, if the
+   *                    classifier is not fitted); it is the last training
+   *                    image
+   */
+  bool Insert(const unsigned char* image, const unsigned char label);
+
+  /** Add a labeled CV_8UC1 image of the training images' size to the
+   *  fitted training set
+   *
+   *  \param[in] image  the image
+   *  \param[in] label  its enumerated label
+   *  \return           whether it was added (false, with a message, if the
+   *                    image's type or size is wrong)
+   */
+  bool Insert(const cv::Mat& image, const unsigned char label);
+
+  /** Remove an image from the fitted training set
+   *
+   *  The last training image takes the removed one's index (the others
+   *  keep theirs), so a removal costs one image's copy, plus (when
+   *  pruning) one removal from the pixel-sum order.
+   *
+   *  \param[in] idx  index of the training image to remove
+   *  \return         whether it was removed (false, with a message, if
+   *                  there is no such image or fewer than k would remain)
+   */
+  bool Remove(const std::size_t idx);
+
+  /** Classify one image
+   *
+   *  \param[in] image  the image's pixels, row by row, in the training
+   *                    images' geometry
+   *  \return           its enumerated label
+   */
+  unsigned char Predict(const unsigned char* image);
+
+  /** Classify one CV_8UC1 image of the training images' size (e.g. one
+   *  segmented character)
+   *
+   *  \param[in] image  the image
+   *  \return           its enumerated label (0, with a message, if the
+   *                    image's type or size is wrong)
+   */
+  unsigned char Predict(const cv::Mat& image);
+
+  /** Classify one image and report the neighbors that decided it
+   *
+   *  \param[in]  image      the image's pixels, row by row, in the training
+   *                         images' geometry
+   *  \param[out] neighbors  its k nearest training images, nearest first,
+   *                         with their Minkowski distances (the vector's
+   *                         storage is reused from call to call)
+   *  \return                its enumerated label
+   */
+  unsigned char PredictWithNeighbors(const unsigned char* image,
+                                     std::vector<Neighbor>& neighbors);
+
+  /** Classify every image of a packed data set
+   *
+   *  \param[in]  test_images  packed data set containing the images to be
+   *                           classified (labels, if any, are ignored)
+   *  \param[out] labels       the enumerated label of each test image
+   *                           (empty, with a message, if the test images do
+   *                           not match the training images or the
+   *                           classifier is not fitted)
+   */
+  void PredictBatch(const PackedDataset& test_images,
+                    std::vector<unsigned char>& labels);
+
+  /** Classify every image of a packed data set
+   *
+   *  \param[in] test_images  packed data set containing the images to be
+   *                          classified (labels, if any, are ignored)
+   *  \return                 vector containing the enumerated labels for
+   *                          each of the classified test images
+   */
+  std::vector<unsigned char> PredictBatch(const PackedDataset& test_images);
+
+ private:
+  // Everything Fit() prepares, kept at a fixed address since the search
+  // structures refer to the training set and kernel inside it
+  struct State;
+
+  // The k nearest of one image into the serial selection
+  void Nearest(const unsigned char* image);
+
+  // Make sure the training set is in the classifier's own storage, with
+  // room for number_images images
+  void Reserve(const std::size_t number_images);
+
+  int k_;
+  double p_;
+  KnnOptions options_;
+  std::unique_ptr<State> state_;
+};
+}
@@ -0,0 +1,270 @@
+/** Implementation file for the on-disk k-NN model.
+ *
+ *  \file statistics/classifiers/KnnModel.cpp
+ *  \date 17 Oct 2026
+ */
+
+#include "imgs/statistics/classifiers/KnnModel.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <istream>
+#include <memory>
+#include <streambuf>
+#include <vector>
+
+#include "imgs/statistics/classifiers/Serialization.h"
+
+namespace statistics {
+
+namespace {
+
+// File identification
+constexpr char kKnnModelMagic[8] = {'R', 'I', 'T', 'K', 'N', 'N', 'M', 'D'};
+
+// Which of the optional parts the file holds
+constexpr std::uint32_t kHasLabels = 1u << 0;
+constexpr std::uint32_t kHasVpTree = 1u << 1;
+constexpr std::uint32_t kHasHnsw = 1u << 2;
+constexpr std::uint32_t kHasProjection = 1u << 3;
+
+// Fixed header at the start of the file; every section starts at a
+// multiple of kPackedAlignment bytes
+struct ModelHeader {
+  char magic[8];
+  std::uint32_t version;
+  std::uint32_t flags;
+  std::uint64_t number_images;
+  std::int32_t number_rows;
+  std::int32_t number_cols;
+  std::uint64_t stride;
+  std::uint64_t pixels_offset;
+  std::uint64_t labels_offset;
+  std::uint64_t statistics_offset;
+  std::uint64_t indexes_offset;
+  std::uint64_t file_bytes;
+};
+
+std::uint64_t Aligned(const std::uint64_t offset) {
+  return (offset + kPackedAlignment - 1) / kPackedAlignment *
+         kPackedAlignment;
+}
+
+// Zero-fill the stream up to the next section boundary
+std::uint64_t PadToAlignment(std::ostream& stream, const std::uint64_t offset) {
+  static const char zeros[kPackedAlignment] = {};
+  const std::uint64_t aligned = Aligned(offset);
+  stream.write(zeros, aligned - offset);
+  return aligned;
+}
+
+// Read-only stream over a block of (mapped) memory, without copying it
+class MemoryBuffer : public std::streambuf {
+ public:
+  MemoryBuffer(char* begin, char* end) { setg(begin, begin, end); }
+};
+
+}  // namespace
+
+bool WriteKnnModel(const std::string filename, const KnnModel& model) {
+  // (a copy shares the pixels, so computing its statistics leaves the
+  // model's data set untouched)
+  PackedDataset training_images = model.training_images;
+  if (!training_images.has_statistics()) {
+    training_images.ComputeStatistics();
+  }
+
+  // Open file
+  std::ofstream file(filename, std::ios::binary);
+  if (!file.is_open()) {
+    std::cerr << "Unable to open k-NN model file for writing: " << filename
+              << std::endl;
+    return false;
+  }
+
+  const std::uint64_t number_images = training_images.size();
+  ModelHeader header{};
+  std::memcpy(header.magic, kKnnModelMagic, sizeof(header.magic));
+  header.version = kKnnModelVersion;
+  header.flags = (training_images.has_labels() ? kHasLabels : 0) |
+                 (model.vp_tree.empty() ? 0 : kHasVpTree) |
+                 (model.hnsw.empty() ? 0 : kHasHnsw) |
+                 (model.projection.empty() ? 0 : kHasProjection);
+  header.number_images = number_images;
+  header.number_rows = training_images.rows();
+  header.number_cols = training_images.cols();
+  header.stride = Aligned(training_images.dimension());
+
+  // Header (rewritten with the offsets at the end), then the pixels, padded
+  // to the same stride as a packed data set
+  WriteValue(file, header);
+  std::uint64_t offset = PadToAlignment(file, sizeof(ModelHeader));
+  header.pixels_offset = offset;
+  std::vector<char> row(header.stride, 0);
+  for (std::uint64_t idx = 0; idx < number_images; ++idx) {
+    std::memcpy(row.data(), training_images.ptr(idx),
+                training_images.dimension());
+    file.write(row.data(), row.size());
+  }
+  offset += number_images * header.stride;
+
+  header.labels_offset = offset;
+  if (training_images.has_labels()) {
+    file.write(reinterpret_cast<const char*>(training_images.labels()),
+               number_images);
+    offset = PadToAlignment(file, offset + number_images);
+  }
+
+  // Squared norms, pixel sums and row sums, in the layout
+  // PackedDataset::SetStatistics() takes
+  header.statistics_offset = offset;
+  const std::uint64_t statistics_count =
+      number_images * (2 + static_cast<std::uint64_t>(header.number_rows));
+  file.write(reinterpret_cast<const char*>(training_images.squared_norms()),
+             number_images * sizeof(std::uint32_t));
+  file.write(reinterpret_cast<const char*>(training_images.pixel_sums()),
+             number_images * sizeof(std::uint32_t));
+  file.write(reinterpret_cast<const char*>(training_images.row_sums(0)),
+             number_images * header.number_rows * sizeof(std::uint32_t));
+  offset = PadToAlignment(file,
+                          offset + statistics_count * sizeof(std::uint32_t));
+
+  // The indexes, in flag order
+  header.indexes_offset = offset;
+  if (header.flags & kHasVpTree) {
+    model.vp_tree.Save(file);
+  }
+  if (header.flags & kHasHnsw) {
+    model.hnsw.Save(file);
+  }
+  if (header.flags & kHasProjection) {
+    WritePcaProjection(file, model.projection);
+  }
+  header.file_bytes = static_cast<std::uint64_t>(file.tellp());
+
+  file.seekp(0);
+  WriteValue(file, header);
+  if (!file) {
+    std::cerr << "Error writing k-NN model file: " << filename << std::endl;
+    return false;
+  }
+  return true;
+}
+
+KnnModel ReadKnnModel(const std::string filename) {
+  // Open file
+  const int descriptor = open(filename.c_str(), O_RDONLY);
+  if (descriptor < 0) {
+    // Report error and terminate if file does not exist or could not be opened
+    std::cerr << "Unable to open k-NN model file: " << filename << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  struct stat status;
+  if (fstat(descriptor, &status) != 0 ||
+      static_cast<std::uint64_t>(status.st_size) < sizeof(ModelHeader)) {
+    std::cerr << "Not a k-NN model file: " << filename << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  // Map the whole file privately (copy on write); the mapping outlives the
+  // descriptor, and is released with the last data set that refers to it
+  const std::size_t file_bytes = static_cast<std::size_t>(status.st_size);
+  void* mapping = mmap(nullptr, file_bytes, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE, descriptor, 0);
+  close(descriptor);
+  if (mapping == MAP_FAILED) {
+    std::cerr << "Unable to map k-NN model file: " << filename << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  std::shared_ptr<void> owner(
+      mapping, [file_bytes](void* address) { munmap(address, file_bytes); });
+  unsigned char* base = static_cast<unsigned char*>(mapping);
+
+  // Check the header against the file before trusting any offset in it
+  ModelHeader header;
+  std::memcpy(&header, base, sizeof(header));
+  if (std::memcmp(header.magic, kKnnModelMagic, sizeof(header.magic)) != 0 ||
+      header.version != kKnnModelVersion) {
+    std::cerr << "Not a k-NN model file (or of an unsupported version): "
+              << filename << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  const std::uint64_t number_images = header.number_images;
+  const std::uint64_t dimension =
+      static_cast<std::uint64_t>(header.number_rows) * header.number_cols;
+  const std::uint64_t label_bytes = (header.flags & kHasLabels) ? 1 : 0;
+  const std::uint64_t statistics_bytes =
+      (2 + static_cast<std::uint64_t>(header.number_rows)) *
+      sizeof(std::uint32_t);
+
+  // Whether count items of item_bytes each fit in the file after offset,
+  // checked by division so that no product of the header's values can wrap
+  const auto fits = [file_bytes](const std::uint64_t offset,
+                                 const std::uint64_t count,
+                                 const std::uint64_t item_bytes) {
+    return offset <= file_bytes &&
+           (item_bytes == 0 || count <= (file_bytes - offset) / item_bytes);
+  };
+  if (header.number_rows < 0 || header.number_cols < 0 ||
+      header.file_bytes != file_bytes || header.stride < dimension ||
+      header.stride % kPackedAlignment != 0 ||
+      header.pixels_offset % kPackedAlignment != 0 ||
+      header.statistics_offset % alignof(std::uint32_t) != 0 ||
+      !fits(header.pixels_offset, number_images, header.stride) ||
+      !fits(header.labels_offset, number_images, label_bytes) ||
+      !fits(header.statistics_offset, number_images, statistics_bytes) ||
+      header.labels_offset <
+          header.pixels_offset + number_images * header.stride ||
+      header.statistics_offset <
+          header.labels_offset + number_images * label_bytes ||
+      header.indexes_offset <
+          header.statistics_offset + number_images * statistics_bytes ||
+      header.indexes_offset > file_bytes) {
+    std::cerr << "Corrupt or truncated k-NN model file: " << filename
+              << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  // The training images, labels and statistics are used in place
+  KnnModel model;
+  model.training_images = PackedDataset(
+      number_images, header.number_rows, header.number_cols,
+      base + header.pixels_offset, header.stride,
+      (header.flags & kHasLabels) ? base + header.labels_offset : nullptr,
+      owner);
+  const std::uint32_t* statistics = reinterpret_cast<const std::uint32_t*>(
+      base + header.statistics_offset);
+  model.training_images.SetStatistics(statistics, statistics + number_images,
+                                      statistics + 2 * number_images, owner);
+
+  // The indexes are read out of the mapping
+  MemoryBuffer buffer(reinterpret_cast<char*>(base + header.indexes_offset),
+                      reinterpret_cast<char*>(base + file_bytes));
+  std::istream stream(&buffer);
+  bool is_valid = true;
+  if (header.flags & kHasVpTree) {
+    is_valid = model.vp_tree.Load(stream, model.training_images);
+  }
+  if (is_valid && (header.flags & kHasHnsw)) {
+    is_valid = model.hnsw.Load(stream, model.training_images);
+  }
+  if (is_valid && (header.flags & kHasProjection)) {
+    is_valid = ReadPcaProjection(stream, model.projection) &&
+               model.projection.dimension() == dimension;
+  }
+  if (!is_valid) {
+    std::cerr << "Corrupt k-NN model file index: " << filename << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  // Return the model
+  return model;
+}
+}
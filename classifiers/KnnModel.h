@@ -0,0 +1,69 @@
+/** Interface file for the on-disk k-NN model: the packed training images,
+ *  their labels and per-image statistics, and any of the prebuilt indexes
+ *  (vantage point tree, HNSW graph, PCA projection), in one versioned file.
+ *
+ *  The file is read by mapping it into memory: the training images, labels
+ *  and statistics are used in place, with every image row at the same
+ *  64-byte alignment as in a freshly packed data set, so loading costs
+ *  neither parsing nor copying, and processes that load the same model
+ *  share its pages in the page cache.  (The mapping is private, so a
+ *  process that modifies the pixels gets its own copy of those pages and
+ *  never changes the file.)  Only the indexes, which are small next to the
+ *  pixels, are copied out of the mapping.
+ *
+ *  Values are stored in the byte order of the machine that wrote the file.
+ *
+ *  \file statistics/classifiers/KnnModel.h
+ *  \date 17 Oct 2026
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "imgs/statistics/classifiers/Hnsw.h"
+#include "imgs/statistics/classifiers/Pca.h"
+#include "imgs/statistics/classifiers/VpTree.h"
+#include "imgs/statistics/data_readers/PackedDataset.h"
+
+namespace statistics {
+
+/// Format version written by WriteKnnModel() (the only one it reads)
+constexpr std::uint32_t kKnnModelVersion = 1;
+
+/** A k-NN model; every index is optional, and left empty when absent
+ */
+struct KnnModel {
+  /// Packed training images and labels, with their statistics computed
+  PackedDataset training_images;
+
+  /// Exact metric index over training_images
+  VpTree vp_tree;
+
+  /// Approximate nearest-neighbor graph over training_images
+  HnswIndex hnsw;
+
+  /// Principal component projection learned from training_images
+  PcaProjection projection;
+};
+
+/** Write a model file
+ *
+ *  \param[in] filename  path of the file to (over)write
+ *  \param[in] model     the model; its indexes must have been built over
+ *                       its training images (the statistics are computed
+ *                       for the file if the training images lack them)
+ *  \return              whether the file was written completely
+ */
+bool WriteKnnModel(const std::string filename, const KnnModel& model);
+
+/** Map a model file written by WriteKnnModel() into memory
+ *
+ *  \param[in] filename  path of the file to read
+ *  \return              the model, whose training images remain mapped for
+ *                       as long as any copy of them (or of an index over
+ *                       them) is alive
+ */
+KnnModel ReadKnnModel(const std::string filename);
+}
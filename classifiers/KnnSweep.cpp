@@ -0,0 +1,311 @@
+/** Implementation file for the single-pass sweep of the k-NN
+ *  hyperparameters.
+ *
+ *  \file statistics/classifiers/KnnSweep.cpp
+ *  \date 17 Oct 2026
+ */
+
+#include "imgs/statistics/classifiers/KnnSweep.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+
+#include "imgs/statistics/classifiers/Distance.h"
+#include "imgs/statistics/classifiers/MinkowskiKernels.h"
+#include "imgs/statistics/classifiers/TopK.h"
+#include "imgs/statistics/parallel/ThreadPool.h"
+
+namespace statistics {
+
+namespace {
+
+constexpr std::size_t kChunk = MinkowskiKernel::kAbandonChunk;
+
+// The chunk sums of the three direct orders are accumulated in 32 bits
+static_assert(kChunk * 255 * 255 * 255 <= UINT32_MAX,
+              "chunk sums of |d|^3 overflow 32 bits");
+
+// How an order accumulates |d|^p from the absolute differences: directly
+// for 1-3, from a table of exact integers up to kMaxIntegerTableOrder, and
+// from a table of doubles beyond (and for non-integer orders, or images too
+// large for 64-bit integer sums), exactly as the kernels do
+enum class OrderKind { kL1, kL2, kL3, kIntegerTable, kRealTable };
+
+struct SweepOrder {
+  OrderKind kind;
+  const std::uint64_t* integer_powers = nullptr;
+  std::array<double, 256> real_powers{};
+};
+
+SweepOrder MakeSweepOrder(const double p, const std::size_t number_pixels) {
+  static const std::array<std::uint64_t, 256>* kIntegerTables[] = {
+      nullptr,         &kPowerTable<1>, &kPowerTable<2>, &kPowerTable<3>,
+      &kPowerTable<4>, &kPowerTable<5>, &kPowerTable<6>};
+  SweepOrder order;
+  const int integer_order = static_cast<int>(p);
+  if (integer_order != p ||
+      integer_order > MinkowskiKernel::kMaxIntegerTableOrder ||
+      !FitsIntegerPowerSum(integer_order, number_pixels)) {
+    order.kind = OrderKind::kRealTable;
+    for (int d = 0; d < 256; ++d) {
+      order.real_powers[d] = std::pow(static_cast<double>(d), p);
+    }
+  } else if (integer_order <= 3) {
+    order.kind = static_cast<OrderKind>(integer_order - 1);
+  } else {
+    order.kind = OrderKind::kIntegerTable;
+    order.integer_powers = kIntegerTables[integer_order]->data();
+  }
+  return order;
+}
+
+// An order's |d|^p over one chunk of absolute differences, added to its
+// running sum
+void Accumulate(const SweepOrder& order, const unsigned char* differences,
+                const std::size_t length, std::uint64_t& integer_sum,
+                double& real_sum) {
+  std::uint32_t chunk_sum = 0;
+  switch (order.kind) {
+    case OrderKind::kL1:
+      for (std::size_t j = 0; j < length; ++j) {
+        chunk_sum += differences[j];
+      }
+      integer_sum += chunk_sum;
+      break;
+    case OrderKind::kL2:
+      for (std::size_t j = 0; j < length; ++j) {
+        const std::uint32_t d = differences[j];
+        chunk_sum += d * d;
+      }
+      integer_sum += chunk_sum;
+      break;
+    case OrderKind::kL3:
+      for (std::size_t j = 0; j < length; ++j) {
+        const std::uint32_t d = differences[j];
+        chunk_sum += d * d * d;
+      }
+      integer_sum += chunk_sum;
+      break;
+    case OrderKind::kIntegerTable:
+      for (std::size_t j = 0; j < length; ++j) {
+        integer_sum += order.integer_powers[differences[j]];
+      }
+      break;
+    case OrderKind::kRealTable:
+      for (std::size_t j = 0; j < length; ++j) {
+        real_sum += order.real_powers[differences[j]];
+      }
+      break;
+  }
+}
+
+// Per-worker selections and running sums
+struct SweepWorker {
+  std::vector<TopK> neighbors;
+  std::vector<std::uint64_t> integer_sums;
+  std::vector<double> real_sums;
+  std::vector<unsigned char> is_live;
+  std::vector<std::size_t> pixels;
+  std::size_t pairs = 0;
+  std::size_t abandoned = 0;
+};
+
+}  // namespace
+
+void KnnSweep::Best(std::size_t& order_index, std::size_t& k_index) const {
+  order_index = 0;
+  k_index = 0;
+  double best = -1;
+  for (std::size_t k = 0; k < ks.size(); ++k) {
+    for (std::size_t o = 0; o < orders.size(); ++o) {
+      if (accuracy[o][k] > best) {
+        best = accuracy[o][k];
+        order_index = o;
+        k_index = k;
+      }
+    }
+  }
+}
+
+KnnSweep SweepKnn(const PackedDataset& test_images,
+                  const PackedDataset& training_images, const int k_max,
+                  const std::vector<double>& orders,
+                  const unsigned int number_threads) {
+  if (test_images.rows() != training_images.rows() ||
+      test_images.cols() != training_images.cols()) {
+    std::cerr << "Test and training image size mismatch!" << std::endl;
+    return {};
+  }
+  if (!test_images.has_labels() || !training_images.has_labels()) {
+    std::cerr << "Test and training images must both be labeled!"
+              << std::endl;
+    return {};
+  }
+  if (k_max < 1 || static_cast<std::size_t>(k_max) > training_images.size()) {
+    std::cerr << "k must be between 1 and the number of training images!"
+              << std::endl;
+    return {};
+  }
+  if (orders.empty() ||
+      *std::min_element(orders.begin(), orders.end()) < 1) {
+    std::cerr << "The Minkowski order p must be at least 1!" << std::endl;
+    return {};
+  }
+
+  const std::size_t number_test = test_images.size();
+  const std::size_t number_training = training_images.size();
+  const std::size_t number_orders = orders.size();
+  const std::size_t number_pixels = training_images.dimension();
+  const std::size_t k = static_cast<std::size_t>(k_max);
+
+  std::vector<SweepOrder> sweep_orders;
+  sweep_orders.reserve(number_orders);
+  for (const double p : orders) {
+    sweep_orders.push_back(MakeSweepOrder(p, number_pixels));
+  }
+
+  // The labels of each test image's k_max nearest per order, nearest first
+  std::vector<unsigned char> neighbor_labels(number_test * number_orders * k);
+
+  using Clock = std::chrono::steady_clock;
+  auto start = Clock::now();
+
+  ThreadPool pool(number_threads);
+  std::vector<SweepWorker> workers(pool.size());
+  for (auto& worker : workers) {
+    worker.neighbors.assign(number_orders, TopK(k_max));
+    worker.integer_sums.resize(number_orders);
+    worker.real_sums.resize(number_orders);
+    worker.is_live.resize(number_orders);
+    worker.pixels.assign(number_orders, 0);
+  }
+
+  pool.ParallelFor(
+      0, number_test, 16,
+      [&](std::size_t begin, std::size_t end, unsigned int w) {
+        SweepWorker& worker = workers[w];
+        std::array<unsigned char, kChunk> differences;
+        for (std::size_t t = begin; t < end; ++t) {
+          const unsigned char* a = test_images.ptr(t);
+          for (auto& neighbors : worker.neighbors) {
+            neighbors.Clear();
+          }
+
+          for (std::size_t i = 0; i < number_training; ++i) {
+            const unsigned char* b = training_images.ptr(i);
+            std::fill(worker.integer_sums.begin(), worker.integer_sums.end(),
+                      0);
+            std::fill(worker.real_sums.begin(), worker.real_sums.end(), 0);
+            std::fill(worker.is_live.begin(), worker.is_live.end(), 1);
+            std::size_t number_live = number_orders;
+
+            // One pass over the absolute differences for every order still
+            // within its bound
+            for (std::size_t j = 0; j < number_pixels && number_live > 0;
+                 j += kChunk) {
+              const std::size_t length = std::min(kChunk, number_pixels - j);
+              for (std::size_t l = 0; l < length; ++l) {
+                differences[l] = static_cast<unsigned char>(
+                    std::abs(a[j + l] - b[j + l]));
+              }
+              for (std::size_t o = 0; o < number_orders; ++o) {
+                if (!worker.is_live[o]) {
+                  continue;
+                }
+                Accumulate(sweep_orders[o], differences.data(), length,
+                           worker.integer_sums[o], worker.real_sums[o]);
+                worker.pixels[o] += length;
+                const double sum =
+                    (sweep_orders[o].kind == OrderKind::kRealTable)
+                        ? worker.real_sums[o]
+                        : static_cast<double>(worker.integer_sums[o]);
+                if (sum > worker.neighbors[o].Bound()) {
+                  worker.is_live[o] = 0;
+                  --number_live;
+                }
+              }
+            }
+
+            ++worker.pairs;
+            if (number_live < number_orders) {
+              ++worker.abandoned;
+            }
+            for (std::size_t o = 0; o < number_orders; ++o) {
+              if (worker.is_live[o]) {
+                worker.neighbors[o].Push(
+                    (sweep_orders[o].kind == OrderKind::kRealTable)
+                        ? worker.real_sums[o]
+                        : static_cast<double>(worker.integer_sums[o]),
+                    i);
+              }
+            }
+          }
+
+          for (std::size_t o = 0; o < number_orders; ++o) {
+            unsigned char* labels =
+                neighbor_labels.data() + (t * number_orders + o) * k;
+            for (std::size_t n = 0; n < k; ++n) {
+              labels[n] =
+                  training_images.label(worker.neighbors[o][n].index);
+            }
+          }
+        }
+      });
+
+  KnnSweep sweep;
+  sweep.orders = orders;
+  sweep.distance_seconds =
+      std::chrono::duration<double>(Clock::now() - start).count();
+
+  // The distance pass's time, split across the orders by the pixels each
+  // accumulated
+  std::vector<double> pixels(number_orders, 0);
+  double total_pixels = 0;
+  for (const auto& worker : workers) {
+    for (std::size_t o = 0; o < number_orders; ++o) {
+      pixels[o] += worker.pixels[o];
+      total_pixels += worker.pixels[o];
+    }
+    sweep.pairs += worker.pairs;
+    sweep.abandoned += worker.abandoned;
+  }
+
+  // Every k from the first k of the k_max nearest, each cell timed
+  for (int n = 1; n <= k_max; ++n) {
+    sweep.ks.push_back(n);
+  }
+  sweep.accuracy.assign(number_orders, std::vector<double>(k, 0));
+  sweep.seconds.assign(number_orders, std::vector<double>(k, 0));
+  for (std::size_t o = 0; o < number_orders; ++o) {
+    const double order_seconds =
+        (total_pixels > 0) ? sweep.distance_seconds * pixels[o] / total_pixels
+                           : 0;
+    for (std::size_t n = 1; n <= k; ++n) {
+      start = Clock::now();
+      std::size_t correct = 0;
+      for (std::size_t t = 0; t < number_test; ++t) {
+        const unsigned char* labels =
+            neighbor_labels.data() + (t * number_orders + o) * k;
+        LabelHistogram label_counts;
+        for (std::size_t m = 0; m < n; ++m) {
+          label_counts.Add(labels[m]);
+        }
+        correct += (label_counts.MostCommon() == test_images.label(t));
+      }
+      const double vote_seconds =
+          std::chrono::duration<double>(Clock::now() - start).count();
+      sweep.vote_seconds += vote_seconds;
+      sweep.accuracy[o][n - 1] =
+          (number_test > 0) ? static_cast<double>(correct) / number_test : 0;
+      sweep.seconds[o][n - 1] = order_seconds + vote_seconds;
+    }
+  }
+
+  return sweep;
+}
+}
@@ -0,0 +1,88 @@
+/** Interface file for a single-pass sweep of the k-NN hyperparameters k
+ *  and p over a labeled test set.
+ *
+ *  Tuning k and p by re-running Knn() for every pair repeats the whole
+ *  test x training distance computation each time, although
+ *
+ *    - the k nearest neighbors of an image are the first k of its k_max
+ *      nearest (both ordered by NearerThan()), so one selection of k_max
+ *      neighbors per order answers every k <= k_max, and
+ *    - the power sums of all orders are sums over the same per-pixel
+ *      absolute differences |a - b|, so these are computed once per image
+ *      pair and every order accumulates its |d|^p from them.
+ *
+ *  Each pair is summed in chunks of MinkowskiKernel::kAbandonChunk pixels,
+ *  and an order stops accumulating once its partial sum exceeds its k_max-th
+ *  nearest so far; the pair is abandoned when every order has stopped.  The
+ *  completed sums are bit-identical to the kernels' (exact integers, or the
+ *  same sequential double sum for non-integer orders), so every cell of the
+ *  sweep classifies exactly as Knn() with that k and p would.
+ *
+ *  \file statistics/classifiers/KnnSweep.h
+ *  \date 17 Oct 2026
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "imgs/statistics/data_readers/PackedDataset.h"
+
+namespace statistics {
+
+/** Accuracy and cost of every (p, k) pair of a sweep
+ */
+struct KnnSweep {
+  /// The orders swept, in the order given
+  std::vector<double> orders;
+
+  /// The numbers of neighbors swept, 1 through k_max
+  std::vector<int> ks;
+
+  /// Fraction of the test images classified correctly, [order][k - 1]
+  std::vector<std::vector<double>> accuracy;
+
+  /// Seconds attributable to each cell, [order][k - 1]: the order's share
+  /// of the shared distance pass (by pixels it accumulated) plus the time
+  /// of that cell's majority votes
+  std::vector<std::vector<double>> seconds;
+
+  /// Wall time of the shared distance pass and of all of the votes
+  double distance_seconds = 0;
+  double vote_seconds = 0;
+
+  /// Image pairs compared, and those abandoned before their last pixel
+  std::size_t pairs = 0;
+  std::size_t abandoned = 0;
+
+  bool empty() const { return orders.empty() || ks.empty(); }
+
+  /** The cell of highest accuracy (ties go to the smaller k, then to the
+   *  earlier order), as indices into orders and ks
+   */
+  void Best(std::size_t& order_index, std::size_t& k_index) const;
+};
+
+/** Classify a labeled test set with every k <= k_max and every order
+ *
+ *  \param[in] test_images      packed data set containing the labeled
+ *                              images to be classified
+ *  \param[in] training_images  packed data set containing the images and
+ *                              enumerated labels to be used as training
+ *                              data
+ *  \param[in] k_max            largest number of neighbors swept (at most
+ *                              the number of training images)
+ *  \param[in] orders           Minkowski orders swept (each at least 1)
+ *  \param[in] number_threads   threads the test images are split across
+ *                              (0 uses one per hardware thread) [default
+ *                              is 0]
+ *  \return                     accuracy and runtime grids (empty, with a
+ *                              message, if the data sets or parameters are
+ *                              invalid)
+ */
+KnnSweep SweepKnn(const PackedDataset& test_images,
+                  const PackedDataset& training_images, const int k_max,
+                  const std::vector<double>& orders,
+                  const unsigned int number_threads = 0);
+}
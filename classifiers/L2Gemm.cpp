@@ -0,0 +1,214 @@
+/** Implementation file for the batched Euclidean distance engine.
+ *
+ *  \file statistics/classifiers/L2Gemm.cpp
+ *  \date 17 Oct 2026
+ */
+
+#include "imgs/statistics/classifiers/L2Gemm.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define STATISTICS_X86_KERNELS 1
+#include <immintrin.h>
+#endif
+
+namespace statistics {
+
+namespace {
+
+// Pixels per vector step of the dot product kernels
+constexpr std::size_t kDepthStep = 16;
+
+// ###################
+// %% Scalar kernel %%
+// ###################
+
+std::uint32_t ScalarDot(const std::int16_t* a, const unsigned char* b,
+                        const std::size_t begin, const std::size_t end) {
+  std::uint32_t dot = 0;
+  for (std::size_t d = begin; d < end; ++d) {
+    dot += static_cast<std::uint32_t>(a[d]) * b[d];
+  }
+  return dot;
+}
+
+// Dot products of every test row with the training images [begin, end)
+void ScalarDots(const std::int16_t* tests, const std::size_t number_tests,
+                const std::size_t test_stride,
+                const PackedDataset& training_images, const std::size_t begin,
+                const std::size_t end, std::uint32_t* dots) {
+  const std::size_t dimension = training_images.dimension();
+  const std::size_t width = end - begin;
+  for (std::size_t t = 0; t < number_tests; ++t) {
+    for (std::size_t j = begin; j < end; ++j) {
+      dots[t * width + (j - begin)] = ScalarDot(
+          tests + t * test_stride, training_images.ptr(j), 0, dimension);
+    }
+  }
+}
+
+#ifdef STATISTICS_X86_KERNELS
+
+// ##################
+// %% AVX2 kernels %%
+// ##################
+
+__attribute__((target("avx2"))) inline std::uint32_t Total(__m256i v) {
+  __m128i sum = _mm_add_epi32(_mm256_castsi256_si128(v),
+                              _mm256_extracti128_si256(v, 1));
+  sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+  sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+  return static_cast<std::uint32_t>(_mm_cvtsi128_si32(sum));
+}
+
+__attribute__((target("avx2"))) inline __m256i Widen(const unsigned char* b) {
+  return _mm256_cvtepu8_epi16(
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(b)));
+}
+
+__attribute__((target("avx2"))) inline __m256i Load(const std::int16_t* a) {
+  return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a));
+}
+
+// One test row against one training image
+__attribute__((target("avx2"))) std::uint32_t Avx2Dot(
+    const std::int16_t* a, const unsigned char* b, const std::size_t depth,
+    const std::size_t dimension) {
+  __m256i acc = _mm256_setzero_si256();
+  for (std::size_t d = 0; d < depth; d += kDepthStep) {
+    acc = _mm256_add_epi32(acc, _mm256_madd_epi16(Load(a + d), Widen(b + d)));
+  }
+  const std::uint32_t dot = Total(acc);
+  _mm256_zeroupper();
+  return dot + ScalarDot(a, b, depth, dimension);
+}
+
+// Register-blocked micro-kernel: 4 test rows x 2 training images share
+// every load, giving 8 independent accumulators
+__attribute__((target("avx2"))) void Avx2Dots(
+    const std::int16_t* tests, const std::size_t number_tests,
+    const std::size_t test_stride, const PackedDataset& training_images,
+    const std::size_t begin, const std::size_t end, std::uint32_t* dots) {
+  const std::size_t dimension = training_images.dimension();
+  const std::size_t depth = dimension / kDepthStep * kDepthStep;
+  const std::size_t width = end - begin;
+
+  std::size_t t = 0;
+  for (; t + 4 <= number_tests; t += 4) {
+    const std::int16_t* a0 = tests + t * test_stride;
+    const std::int16_t* a1 = a0 + test_stride;
+    const std::int16_t* a2 = a1 + test_stride;
+    const std::int16_t* a3 = a2 + test_stride;
+
+    std::size_t j = begin;
+    for (; j + 2 <= end; j += 2) {
+      const unsigned char* b0 = training_images.ptr(j);
+      const unsigned char* b1 = training_images.ptr(j + 1);
+      __m256i acc[8];
+      for (auto& accumulator : acc) {
+        accumulator = _mm256_setzero_si256();
+      }
+      for (std::size_t d = 0; d < depth; d += kDepthStep) {
+        __m256i w0 = Widen(b0 + d);
+        __m256i w1 = Widen(b1 + d);
+        __m256i v0 = Load(a0 + d);
+        __m256i v1 = Load(a1 + d);
+        __m256i v2 = Load(a2 + d);
+        __m256i v3 = Load(a3 + d);
+        acc[0] = _mm256_add_epi32(acc[0], _mm256_madd_epi16(v0, w0));
+        acc[1] = _mm256_add_epi32(acc[1], _mm256_madd_epi16(v0, w1));
+        acc[2] = _mm256_add_epi32(acc[2], _mm256_madd_epi16(v1, w0));
+        acc[3] = _mm256_add_epi32(acc[3], _mm256_madd_epi16(v1, w1));
+        acc[4] = _mm256_add_epi32(acc[4], _mm256_madd_epi16(v2, w0));
+        acc[5] = _mm256_add_epi32(acc[5], _mm256_madd_epi16(v2, w1));
+        acc[6] = _mm256_add_epi32(acc[6], _mm256_madd_epi16(v3, w0));
+        acc[7] = _mm256_add_epi32(acc[7], _mm256_madd_epi16(v3, w1));
+      }
+      const std::int16_t* rows[4] = {a0, a1, a2, a3};
+      for (int r = 0; r < 4; ++r) {
+        std::uint32_t* out = dots + (t + r) * width + (j - begin);
+        out[0] = Total(acc[2 * r]) + ScalarDot(rows[r], b0, depth, dimension);
+        out[1] =
+            Total(acc[2 * r + 1]) + ScalarDot(rows[r], b1, depth, dimension);
+      }
+    }
+    for (; j < end; ++j) {
+      const unsigned char* b = training_images.ptr(j);
+      dots[t * width + (j - begin)] = Avx2Dot(a0, b, depth, dimension);
+      dots[(t + 1) * width + (j - begin)] = Avx2Dot(a1, b, depth, dimension);
+      dots[(t + 2) * width + (j - begin)] = Avx2Dot(a2, b, depth, dimension);
+      dots[(t + 3) * width + (j - begin)] = Avx2Dot(a3, b, depth, dimension);
+    }
+  }
+
+  // Leftover test rows one at a time
+  for (; t < number_tests; ++t) {
+    for (std::size_t j = begin; j < end; ++j) {
+      dots[t * width + (j - begin)] =
+          Avx2Dot(tests + t * test_stride, training_images.ptr(j), depth,
+                  dimension);
+    }
+  }
+
+  // Leave no dirty upper halves for the (non-VEX) caller
+  _mm256_zeroupper();
+}
+
+#endif  // STATISTICS_X86_KERNELS
+
+}  // namespace
+
+L2GemmEngine::L2GemmEngine(const PackedDataset& training_images,
+                           const SimdLevel level)
+    : training_images_(training_images),
+      level_(level),
+      dimension_(training_images.dimension()) {
+  padded_dimension_ = (dimension_ + kDepthStep - 1) / kDepthStep * kDepthStep;
+  test_block_.resize(kGemmTestBlock * padded_dimension_);
+  test_norms_.resize(kGemmTestBlock);
+}
+
+void L2GemmEngine::LoadTestBlock(const PackedDataset& test_images,
+                                 const std::size_t begin,
+                                 const std::size_t end) {
+  number_tests_ = end - begin;
+  for (std::size_t t = 0; t < number_tests_; ++t) {
+    const unsigned char* image = test_images.ptr(begin + t);
+    std::int16_t* row = test_block_.data() + t * padded_dimension_;
+    for (std::size_t d = 0; d < dimension_; ++d) {
+      row[d] = image[d];
+    }
+    for (std::size_t d = dimension_; d < padded_dimension_; ++d) {
+      row[d] = 0;
+    }
+    test_norms_[t] = test_images.squared_norms()[begin + t];
+  }
+}
+
+void L2GemmEngine::SquaredDistances(const std::size_t begin,
+                                    const std::size_t end,
+                                    std::uint32_t* distances) const {
+  // Dot products first, written in place of the distances
+#ifdef STATISTICS_X86_KERNELS
+  if (level_ == SimdLevel::kAvx2 || level_ == SimdLevel::kAvx512) {
+    Avx2Dots(test_block_.data(), number_tests_, padded_dimension_,
+             training_images_, begin, end, distances);
+  } else {
+    ScalarDots(test_block_.data(), number_tests_, padded_dimension_,
+               training_images_, begin, end, distances);
+  }
+#else
+  ScalarDots(test_block_.data(), number_tests_, padded_dimension_,
+             training_images_, begin, end, distances);
+#endif
+
+  // ||a||^2 + ||b||^2 - 2 a.b, exact in 32-bit unsigned arithmetic
+  const std::uint32_t* training_norms = training_images_.squared_norms();
+  const std::size_t width = end - begin;
+  for (std::size_t t = 0; t < number_tests_; ++t) {
+    std::uint32_t* row = distances + t * width;
+    for (std::size_t j = 0; j < width; ++j) {
+      row[j] = test_norms_[t] + training_norms[begin + j] - 2 * row[j];
+    }
+  }
+}
+}
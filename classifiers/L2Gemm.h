@@ -0,0 +1,78 @@
+/** Interface file for the batched Euclidean distance engine.  For p = 2 the
+ *  distances between a whole block of test images and a block of training
+ *  images are computed at once as
+ *
+ *      ||a - b||^2 = ||a||^2 + ||b||^2 - 2 a.b
+ *
+ *  where the squared norms are the ones cached in each PackedDataset when
+ *  it was loaded and the dot products come from a cache-blocked integer
+ *  matrix multiply.  Every term is an exact integer, so the result is
+ *  identical to summing (a - b)^2 pixel by pixel and the neighbor ranking
+ *  is unchanged.
+ *
+ *  \file statistics/classifiers/L2Gemm.h
+ *  \date 17 Oct 2026
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "imgs/statistics/classifiers/MinkowskiKernels.h"
+#include "imgs/statistics/data_readers/PackedDataset.h"
+
+namespace statistics {
+
+/// Test images multiplied against each training block at once
+constexpr std::size_t kGemmTestBlock = 32;
+
+/// Training images per block (256 x 28 x 28 bytes stays cache resident)
+constexpr std::size_t kGemmTrainingBlock = 256;
+
+class L2GemmEngine {
+ public:
+  /** Prepare an engine for one training set
+   *
+   *  \param[in] training_images  packed training images with their
+   *                              statistics (squared norms) computed
+   *  \param[in] level            instruction set to use [default is the
+   *                              widest one supported by the CPU]
+   */
+  explicit L2GemmEngine(const PackedDataset& training_images,
+                        const SimdLevel level = DetectSimdLevel());
+
+  /** Load (and widen to 16 bits, once) a block of at most kGemmTestBlock
+   *  test images; their squared norms must have been computed
+   *
+   *  \param[in] test_images  packed test images
+   *  \param[in] begin        index of the first test image of the block
+   *  \param[in] end          one past the last test image of the block
+   */
+  void LoadTestBlock(const PackedDataset& test_images, const std::size_t begin,
+                     const std::size_t end);
+
+  /** Exact squared Euclidean distances between every loaded test image and
+   *  the training images [begin, end)
+   *
+   *  \param[in]  begin      index of the first training image
+   *  \param[in]  end        one past the last training image
+   *  \param[out] distances  (test block size) x (end - begin) row-major
+   *                         matrix of squared distances
+   */
+  void SquaredDistances(const std::size_t begin, const std::size_t end,
+                        std::uint32_t* distances) const;
+
+ private:
+  const PackedDataset& training_images_;
+  SimdLevel level_;
+  std::size_t dimension_;
+
+  // Loaded test block, widened to int16 and padded to 16 pixels per row
+  std::size_t padded_dimension_;
+  std::size_t number_tests_ = 0;
+  std::vector<std::int16_t> test_block_;
+  std::vector<std::uint32_t> test_norms_;
+};
+}
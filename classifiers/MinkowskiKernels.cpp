@@ -0,0 +1,560 @@
+/** Implementation file for the vectorized Minkowski distance kernels used by
+ *  the packed k-NN classifier.
+ *
+ *  \file statistics/classifiers/MinkowskiKernels.cpp
+ *  \date 17 Oct 2026
+ */
+
+#include "imgs/statistics/classifiers/MinkowskiKernels.h"
+
+#include "imgs/statistics/classifiers/Distance.h"
+
+#include <cmath>
+#include <cstdlib>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define STATISTICS_X86_KERNELS 1
+#include <immintrin.h>
+#endif
+
+namespace statistics {
+
+namespace {
+
+// Bytes summed into 32-bit lanes before they are widened into the 64-bit
+// totals; small enough that no lane can overflow for |d|^3
+constexpr std::size_t kBlockBytes = 256;
+
+// ###################
+// %% Scalar kernels %%
+// ###################
+
+double ScalarL1(const unsigned char* a, const unsigned char* b,
+                const std::size_t n, const void*) {
+  std::uint64_t sum = 0;
+  for (std::size_t i = 0; i < n; ++i) {
+    sum += static_cast<std::uint64_t>(std::abs(a[i] - b[i]));
+  }
+  return static_cast<double>(sum);
+}
+
+double ScalarL2(const unsigned char* a, const unsigned char* b,
+                const std::size_t n, const void*) {
+  std::uint64_t sum = 0;
+  for (std::size_t i = 0; i < n; ++i) {
+    std::uint64_t d = std::abs(a[i] - b[i]);
+    sum += d * d;
+  }
+  return static_cast<double>(sum);
+}
+
+double ScalarL3(const unsigned char* a, const unsigned char* b,
+                const std::size_t n, const void*) {
+  std::uint64_t sum = 0;
+  for (std::size_t i = 0; i < n; ++i) {
+    std::uint64_t d = std::abs(a[i] - b[i]);
+    sum += d * d * d;
+  }
+  return static_cast<double>(sum);
+}
+
+// Other orders, |d|^p looked up in a table of exact integers (summed in a
+// double, as the real table would be, when n of the largest could overflow)
+double ScalarIntegerTable(const unsigned char* a, const unsigned char* b,
+                          const std::size_t n, const void* table) {
+  const std::uint64_t* powers = static_cast<const std::uint64_t*>(table);
+  if (n > UINT64_MAX / powers[255]) {
+    double sum = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+      sum += static_cast<double>(powers[std::abs(a[i] - b[i])]);
+    }
+    return sum;
+  }
+  std::uint64_t sum = 0;
+  for (std::size_t i = 0; i < n; ++i) {
+    sum += powers[std::abs(a[i] - b[i])];
+  }
+  return static_cast<double>(sum);
+}
+
+// Orders too high for 64-bit integers, |d|^p looked up in a double table
+double ScalarRealTable(const unsigned char* a, const unsigned char* b,
+                       const std::size_t n, const void* table) {
+  const double* powers = static_cast<const double*>(table);
+  double sum = 0;
+  for (std::size_t i = 0; i < n; ++i) {
+    sum += powers[std::abs(a[i] - b[i])];
+  }
+  return sum;
+}
+
+#ifdef STATISTICS_X86_KERNELS
+
+// #################
+// %% SSE2 kernels %%
+// #################
+
+__attribute__((target("sse2"))) inline __m128i AbsDiff128(__m128i a,
+                                                          __m128i b) {
+  return _mm_or_si128(_mm_subs_epu8(a, b), _mm_subs_epu8(b, a));
+}
+
+// Sum of the two 64-bit lanes
+__attribute__((target("sse2"))) inline std::uint64_t Total128(__m128i v) {
+  alignas(16) std::uint64_t lanes[2];
+  _mm_store_si128(reinterpret_cast<__m128i*>(lanes), v);
+  return lanes[0] + lanes[1];
+}
+
+// Add the unsigned 32-bit lanes of v into the 64-bit lanes of total
+__attribute__((target("sse2"))) inline __m128i Widen128(__m128i total,
+                                                        __m128i v) {
+  const __m128i zero = _mm_setzero_si128();
+  total = _mm_add_epi64(total, _mm_unpacklo_epi32(v, zero));
+  return _mm_add_epi64(total, _mm_unpackhi_epi32(v, zero));
+}
+
+__attribute__((target("sse2"))) double Sse2L1(const unsigned char* a,
+                                              const unsigned char* b,
+                                              const std::size_t n,
+                                              const void* table) {
+  __m128i total = _mm_setzero_si128();
+  std::size_t i = 0;
+  for (; i + 16 <= n; i += 16) {
+    __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+    __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+    total = _mm_add_epi64(total, _mm_sad_epu8(va, vb));
+  }
+  return static_cast<double>(Total128(total)) +
+         ScalarL1(a + i, b + i, n - i, table);
+}
+
+__attribute__((target("sse2"))) double Sse2L2(const unsigned char* a,
+                                              const unsigned char* b,
+                                              const std::size_t n,
+                                              const void* table) {
+  const __m128i zero = _mm_setzero_si128();
+  __m128i total = _mm_setzero_si128();
+  std::size_t i = 0;
+  while (i + 16 <= n) {
+    __m128i block = _mm_setzero_si128();
+    std::size_t block_end = (n - i > kBlockBytes) ? i + kBlockBytes : n;
+    for (; i + 16 <= block_end; i += 16) {
+      __m128i d = AbsDiff128(
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i)),
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i)));
+      __m128i lo = _mm_unpacklo_epi8(d, zero);
+      __m128i hi = _mm_unpackhi_epi8(d, zero);
+      block = _mm_add_epi32(block, _mm_madd_epi16(lo, lo));
+      block = _mm_add_epi32(block, _mm_madd_epi16(hi, hi));
+    }
+    total = Widen128(total, block);
+  }
+  return static_cast<double>(Total128(total)) +
+         ScalarL2(a + i, b + i, n - i, table);
+}
+
+// |d|^3 of eight 16-bit differences as eight 32-bit values in two vectors
+__attribute__((target("sse2"))) inline __m128i Cubes128(__m128i d) {
+  __m128i squares = _mm_mullo_epi16(d, d);  // at most 65025, fits 16 bits
+  __m128i lo = _mm_mullo_epi16(squares, d);
+  __m128i hi = _mm_mulhi_epu16(squares, d);
+  return _mm_add_epi32(_mm_unpacklo_epi16(lo, hi),
+                       _mm_unpackhi_epi16(lo, hi));
+}
+
+__attribute__((target("sse2"))) double Sse2L3(const unsigned char* a,
+                                              const unsigned char* b,
+                                              const std::size_t n,
+                                              const void* table) {
+  const __m128i zero = _mm_setzero_si128();
+  __m128i total = _mm_setzero_si128();
+  std::size_t i = 0;
+  while (i + 16 <= n) {
+    __m128i block = _mm_setzero_si128();
+    std::size_t block_end = (n - i > kBlockBytes) ? i + kBlockBytes : n;
+    for (; i + 16 <= block_end; i += 16) {
+      __m128i d = AbsDiff128(
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i)),
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i)));
+      block = _mm_add_epi32(block, Cubes128(_mm_unpacklo_epi8(d, zero)));
+      block = _mm_add_epi32(block, Cubes128(_mm_unpackhi_epi8(d, zero)));
+    }
+    total = Widen128(total, block);
+  }
+  return static_cast<double>(Total128(total)) +
+         ScalarL3(a + i, b + i, n - i, table);
+}
+
+// #################
+// %% AVX2 kernels %%
+// #################
+
+__attribute__((target("avx2"))) inline __m256i AbsDiff256(__m256i a,
+                                                          __m256i b) {
+  return _mm256_or_si256(_mm256_subs_epu8(a, b), _mm256_subs_epu8(b, a));
+}
+
+__attribute__((target("avx2"))) inline std::uint64_t Total256(__m256i v) {
+  alignas(32) std::uint64_t lanes[4];
+  _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), v);
+  return lanes[0] + lanes[1] + lanes[2] + lanes[3];
+}
+
+__attribute__((target("avx2"))) inline __m256i Widen256(__m256i total,
+                                                        __m256i v) {
+  const __m256i zero = _mm256_setzero_si256();
+  total = _mm256_add_epi64(total, _mm256_unpacklo_epi32(v, zero));
+  return _mm256_add_epi64(total, _mm256_unpackhi_epi32(v, zero));
+}
+
+__attribute__((target("avx2"))) double Avx2L1(const unsigned char* a,
+                                              const unsigned char* b,
+                                              const std::size_t n,
+                                              const void* table) {
+  __m256i total = _mm256_setzero_si256();
+  std::size_t i = 0;
+  for (; i + 32 <= n; i += 32) {
+    __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+    __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+    total = _mm256_add_epi64(total, _mm256_sad_epu8(va, vb));
+  }
+  // Clear the upper halves before the (non-VEX) SSE2 tail and the return,
+  // or every call pays the AVX to SSE transition penalty
+  const double vector_sum = static_cast<double>(Total256(total));
+  _mm256_zeroupper();
+  return vector_sum + Sse2L1(a + i, b + i, n - i, table);
+}
+
+__attribute__((target("avx2"))) double Avx2L2(const unsigned char* a,
+                                              const unsigned char* b,
+                                              const std::size_t n,
+                                              const void* table) {
+  const __m256i zero = _mm256_setzero_si256();
+  __m256i total = _mm256_setzero_si256();
+  std::size_t i = 0;
+  while (i + 32 <= n) {
+    __m256i block = _mm256_setzero_si256();
+    std::size_t block_end = (n - i > kBlockBytes) ? i + kBlockBytes : n;
+    for (; i + 32 <= block_end; i += 32) {
+      __m256i d = AbsDiff256(
+          _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i)),
+          _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i)));
+      __m256i lo = _mm256_unpacklo_epi8(d, zero);
+      __m256i hi = _mm256_unpackhi_epi8(d, zero);
+      block = _mm256_add_epi32(block, _mm256_madd_epi16(lo, lo));
+      block = _mm256_add_epi32(block, _mm256_madd_epi16(hi, hi));
+    }
+    total = Widen256(total, block);
+  }
+  const double vector_sum = static_cast<double>(Total256(total));
+  _mm256_zeroupper();
+  return vector_sum + Sse2L2(a + i, b + i, n - i, table);
+}
+
+__attribute__((target("avx2"))) inline __m256i Cubes256(__m256i d) {
+  __m256i squares = _mm256_mullo_epi16(d, d);
+  __m256i lo = _mm256_mullo_epi16(squares, d);
+  __m256i hi = _mm256_mulhi_epu16(squares, d);
+  return _mm256_add_epi32(_mm256_unpacklo_epi16(lo, hi),
+                          _mm256_unpackhi_epi16(lo, hi));
+}
+
+__attribute__((target("avx2"))) double Avx2L3(const unsigned char* a,
+                                              const unsigned char* b,
+                                              const std::size_t n,
+                                              const void* table) {
+  const __m256i zero = _mm256_setzero_si256();
+  __m256i total = _mm256_setzero_si256();
+  std::size_t i = 0;
+  while (i + 32 <= n) {
+    __m256i block = _mm256_setzero_si256();
+    std::size_t block_end = (n - i > kBlockBytes) ? i + kBlockBytes : n;
+    for (; i + 32 <= block_end; i += 32) {
+      __m256i d = AbsDiff256(
+          _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i)),
+          _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i)));
+      block = _mm256_add_epi32(block, Cubes256(_mm256_unpacklo_epi8(d, zero)));
+      block = _mm256_add_epi32(block, Cubes256(_mm256_unpackhi_epi8(d, zero)));
+    }
+    total = Widen256(total, block);
+  }
+  const double vector_sum = static_cast<double>(Total256(total));
+  _mm256_zeroupper();
+  return vector_sum + Sse2L3(a + i, b + i, n - i, table);
+}
+
+// ####################
+// %% AVX-512 kernels %%
+// ####################
+
+// These finish on the AVX2 kernels, whose vzeroupper before the SSE2 tail
+// and the return also clears the upper state left by the 512-bit loops
+#define STATISTICS_AVX512 target("avx512f,avx512bw")
+
+__attribute__((STATISTICS_AVX512)) inline __m512i AbsDiff512(__m512i a,
+                                                             __m512i b) {
+  return _mm512_or_si512(_mm512_subs_epu8(a, b), _mm512_subs_epu8(b, a));
+}
+
+__attribute__((STATISTICS_AVX512)) inline __m512i Widen512(__m512i total,
+                                                           __m512i v) {
+  const __m512i zero = _mm512_setzero_si512();
+  total = _mm512_add_epi64(total, _mm512_unpacklo_epi32(v, zero));
+  return _mm512_add_epi64(total, _mm512_unpackhi_epi32(v, zero));
+}
+
+__attribute__((STATISTICS_AVX512)) double Avx512L1(const unsigned char* a,
+                                                   const unsigned char* b,
+                                                   const std::size_t n,
+                                                   const void* table) {
+  __m512i total = _mm512_setzero_si512();
+  std::size_t i = 0;
+  for (; i + 64 <= n; i += 64) {
+    __m512i va = _mm512_loadu_si512(a + i);
+    __m512i vb = _mm512_loadu_si512(b + i);
+    total = _mm512_add_epi64(total, _mm512_sad_epu8(va, vb));
+  }
+  return static_cast<double>(static_cast<std::uint64_t>(
+             _mm512_reduce_add_epi64(total))) +
+         Avx2L1(a + i, b + i, n - i, table);
+}
+
+__attribute__((STATISTICS_AVX512)) double Avx512L2(const unsigned char* a,
+                                                   const unsigned char* b,
+                                                   const std::size_t n,
+                                                   const void* table) {
+  const __m512i zero = _mm512_setzero_si512();
+  __m512i total = _mm512_setzero_si512();
+  std::size_t i = 0;
+  while (i + 64 <= n) {
+    __m512i block = _mm512_setzero_si512();
+    std::size_t block_end = (n - i > kBlockBytes) ? i + kBlockBytes : n;
+    for (; i + 64 <= block_end; i += 64) {
+      __m512i d =
+          AbsDiff512(_mm512_loadu_si512(a + i), _mm512_loadu_si512(b + i));
+      __m512i lo = _mm512_unpacklo_epi8(d, zero);
+      __m512i hi = _mm512_unpackhi_epi8(d, zero);
+      block = _mm512_add_epi32(block, _mm512_madd_epi16(lo, lo));
+      block = _mm512_add_epi32(block, _mm512_madd_epi16(hi, hi));
+    }
+    total = Widen512(total, block);
+  }
+  return static_cast<double>(static_cast<std::uint64_t>(
+             _mm512_reduce_add_epi64(total))) +
+         Avx2L2(a + i, b + i, n - i, table);
+}
+
+__attribute__((STATISTICS_AVX512)) inline __m512i Cubes512(__m512i d) {
+  __m512i squares = _mm512_mullo_epi16(d, d);
+  __m512i lo = _mm512_mullo_epi16(squares, d);
+  __m512i hi = _mm512_mulhi_epu16(squares, d);
+  return _mm512_add_epi32(_mm512_unpacklo_epi16(lo, hi),
+                          _mm512_unpackhi_epi16(lo, hi));
+}
+
+__attribute__((STATISTICS_AVX512)) double Avx512L3(const unsigned char* a,
+                                                   const unsigned char* b,
+                                                   const std::size_t n,
+                                                   const void* table) {
+  const __m512i zero = _mm512_setzero_si512();
+  __m512i total = _mm512_setzero_si512();
+  std::size_t i = 0;
+  while (i + 64 <= n) {
+    __m512i block = _mm512_setzero_si512();
+    std::size_t block_end = (n - i > kBlockBytes) ? i + kBlockBytes : n;
+    for (; i + 64 <= block_end; i += 64) {
+      __m512i d =
+          AbsDiff512(_mm512_loadu_si512(a + i), _mm512_loadu_si512(b + i));
+      block = _mm512_add_epi32(block, Cubes512(_mm512_unpacklo_epi8(d, zero)));
+      block = _mm512_add_epi32(block, Cubes512(_mm512_unpackhi_epi8(d, zero)));
+    }
+    total = Widen512(total, block);
+  }
+  return static_cast<double>(static_cast<std::uint64_t>(
+             _mm512_reduce_add_epi64(total))) +
+         Avx2L3(a + i, b + i, n - i, table);
+}
+
+#undef STATISTICS_AVX512
+
+#endif  // STATISTICS_X86_KERNELS
+
+// ##############################################
+// %% Compile-time specialized character kernels %%
+// ##############################################
+
+// Distance<P, 28, 28> behind the common kernel signature (n is always 784)
+template <int P>
+double CharacterPowerSum(const unsigned char* a, const unsigned char* b,
+                         const std::size_t, const void* table) {
+  return Distance<P, kCharacterRows, kCharacterCols>::PowerSum(
+      a, b, static_cast<const double*>(table));
+}
+
+}  // namespace
+
+SimdLevel DetectSimdLevel() {
+#ifdef STATISTICS_X86_KERNELS
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw")) {
+    return SimdLevel::kAvx512;
+  }
+  if (__builtin_cpu_supports("avx2")) {
+    return SimdLevel::kAvx2;
+  }
+  if (__builtin_cpu_supports("sse2")) {
+    return SimdLevel::kSse2;
+  }
+#endif
+  return SimdLevel::kScalar;
+}
+
+const char* SimdLevelName(const SimdLevel level) {
+  switch (level) {
+    case SimdLevel::kAvx512:
+      return "AVX-512";
+    case SimdLevel::kAvx2:
+      return "AVX2";
+    case SimdLevel::kSse2:
+      return "SSE2";
+    default:
+      return "scalar";
+  }
+}
+
+MinkowskiKernel::MinkowskiKernel(const double p, const int rows,
+                                 const int cols, const SimdLevel level)
+    : p_(p), level_(level) {
+#ifndef STATISTICS_X86_KERNELS
+  level_ = SimdLevel::kScalar;
+#endif
+  const int integer_order = static_cast<int>(p_);
+  const bool is_integer = (integer_order == p_);
+  const bool is_character = (rows == kCharacterRows && cols == kCharacterCols);
+
+  // Tables of |d|^p for the orders without a dedicated kernel
+  for (int d = 0; d < 256; ++d) {
+    real_table_[d] = std::pow(static_cast<double>(d), p_);
+  }
+  if (is_integer && integer_order >= 1 &&
+      integer_order <= kMaxIntegerTableOrder) {
+    static const std::array<std::uint64_t, 256>* kIntegerTables[] = {
+        nullptr,         &kPowerTable<1>, &kPowerTable<2>, &kPowerTable<3>,
+        &kPowerTable<4>, &kPowerTable<5>, &kPowerTable<6>};
+    integer_table_ = *kIntegerTables[integer_order];
+    is_integer_table_ = true;
+  }
+
+  // Runtime-length kernels, also used on the chunks of PowerSumBounded()
+  if (!is_integer || integer_order > kMaxIntegerTableOrder) {
+    runtime_sum_ = ScalarRealTable;
+  } else if (integer_order == 1) {
+    runtime_sum_ = ScalarL1;
+  } else if (integer_order == 2) {
+    runtime_sum_ = ScalarL2;
+  } else if (integer_order == 3) {
+    runtime_sum_ = ScalarL3;
+  } else {
+    runtime_sum_ = ScalarIntegerTable;
+  }
+  is_chunk_exact_ = is_integer && integer_order >= 1 &&
+                    integer_order <= kMaxExactChunkOrder;
+
+  // The vectorized exact kernels for the three common orders
+  bool is_vectorized = false;
+#ifdef STATISTICS_X86_KERNELS
+  if (is_integer && integer_order >= 1 && integer_order <= 3) {
+    static const PowerSumFunction kSse2Kernels[] = {Sse2L1, Sse2L2, Sse2L3};
+    static const PowerSumFunction kAvx2Kernels[] = {Avx2L1, Avx2L2, Avx2L3};
+    static const PowerSumFunction kAvx512Kernels[] = {Avx512L1, Avx512L2,
+                                                      Avx512L3};
+    is_vectorized = true;
+    switch (level_) {
+      case SimdLevel::kAvx512:
+        runtime_sum_ = kAvx512Kernels[integer_order - 1];
+        break;
+      case SimdLevel::kAvx2:
+        runtime_sum_ = kAvx2Kernels[integer_order - 1];
+        break;
+      case SimdLevel::kSse2:
+        runtime_sum_ = kSse2Kernels[integer_order - 1];
+        break;
+      default:
+        is_vectorized = false;
+        break;
+    }
+  }
+#endif
+  power_sum_ = runtime_sum_;
+  is_vectorized_ = is_vectorized;
+
+  // Compile-time specializations for the character geometry
+  if (!is_vectorized && is_character &&
+      (!is_integer || integer_order <= kMaxIntegerTableOrder)) {
+    static const PowerSumFunction kCharacterKernels[] = {
+        CharacterPowerSum<kRealOrder>, CharacterPowerSum<1>,
+        CharacterPowerSum<2>,          CharacterPowerSum<3>,
+        CharacterPowerSum<4>,          CharacterPowerSum<5>,
+        CharacterPowerSum<6>};
+    power_sum_ = kCharacterKernels[is_integer ? integer_order : kRealOrder];
+    is_specialized_ = true;
+  }
+}
+
+double MinkowskiKernel::PowerSumBounded(const unsigned char* a,
+                                        const unsigned char* b,
+                                        const std::size_t n,
+                                        const double bound) const {
+  // Orders whose partial sums are exact integers in a double: whole chunks
+  // through the (vectorized) runtime-length kernel
+  if (is_chunk_exact_) {
+    double sum = 0;
+    for (std::size_t i = 0; i < n; i += kAbandonChunk) {
+      std::size_t length = (n - i < kAbandonChunk) ? n - i : kAbandonChunk;
+      sum += runtime_sum_(a + i, b + i, length, integer_table_.data());
+      if (sum > bound) {
+        return sum;
+      }
+    }
+    return sum;
+  }
+
+  // Otherwise one running sum in the same order (and type) as the
+  // unbounded kernels, so a completed sum is bit-identical to theirs
+  if (is_integer_table_ && FitsIntegerPowerSum(static_cast<int>(p_), n)) {
+    std::uint64_t sum = 0;
+    for (std::size_t i = 0; i < n; i += kAbandonChunk) {
+      std::size_t end = (n - i < kAbandonChunk) ? n : i + kAbandonChunk;
+      for (std::size_t j = i; j < end; ++j) {
+        sum += integer_table_[std::abs(a[j] - b[j])];
+      }
+      if (static_cast<double>(sum) > bound) {
+        break;
+      }
+    }
+    return static_cast<double>(sum);
+  }
+
+  double sum = 0;
+  for (std::size_t i = 0; i < n; i += kAbandonChunk) {
+    std::size_t end = (n - i < kAbandonChunk) ? n : i + kAbandonChunk;
+    for (std::size_t j = i; j < end; ++j) {
+      sum += real_table_[std::abs(a[j] - b[j])];
+    }
+    if (sum > bound) {
+      break;
+    }
+  }
+  return sum;
+}
+
+double MinkowskiKernel::DistanceFromPowerSum(const double power_sum) const {
+  if (p_ == 1) {
+    return power_sum;
+  } else if (p_ == 2) {
+    return std::sqrt(power_sum);
+  }
+  return std::pow(power_sum, 1.0 / p_);
+}
+}
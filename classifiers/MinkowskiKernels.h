@@ -0,0 +1,136 @@
+/** Interface file for the vectorized Minkowski distance kernels used by the
+ *  packed k-NN classifier.  Each kernel computes the p-th power of the
+ *  Lp-norm between two 8-bit images, sum(|a - b|^p), by accumulating exact
+ *  integers (|d|, d^2 and |d|^3 directly, other integer orders through a
+ *  256-entry table of |d|^p), so ranking neighbors by it reproduces the
+ *  ordering of MinkowskiDistance() without computing any std::pow() in the
+ *  inner loop.  The SSE2, AVX2 or AVX-512 variant is chosen at run time
+ *  from what the CPU supports, with a portable scalar fallback.
+ *
+ *  \file statistics/classifiers/MinkowskiKernels.h
+ *  \date 17 Oct 2026
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace statistics {
+
+/// Instruction set levels the kernels are compiled for
+enum class SimdLevel { kScalar, kSse2, kAvx2, kAvx512 };
+
+/** The widest instruction set supported by the running CPU
+ */
+SimdLevel DetectSimdLevel();
+
+/** Printable name of an instruction set level
+ */
+const char* SimdLevelName(const SimdLevel level);
+
+/** Lp-norm kernel for one order, selected once and then applied to
+ *  any number of image pairs
+ */
+class MinkowskiKernel {
+ public:
+  /// Highest order whose |d|^p table (and 28x28 sums of it) fit in 64 bits;
+  /// sums over more pixels than FitsIntegerPowerSum() allows are taken in
+  /// doubles instead
+  static constexpr int kMaxIntegerTableOrder = 6;
+
+  /// Highest order whose 28x28 power sums are exact integers in a double
+  static constexpr int kMaxExactChunkOrder = 5;
+
+  /// Pixels summed between the checks of PowerSumBounded()
+  static constexpr std::size_t kAbandonChunk = 128;
+
+  /// sum(|a - b|^p) over n pixels; table is the kernel's |d|^p table
+  using PowerSumFunction = double (*)(const unsigned char* a,
+                                      const unsigned char* b,
+                                      const std::size_t n, const void* table);
+
+  /** Select the kernel for an order, image geometry and instruction set.
+   *  Integer orders 1-3 use the vectorized kernels when the CPU has them;
+   *  otherwise 28 x 28 images use the Distance<P, 28, 28> specialization
+   *  (a loop of constant trip count) and any other geometry a
+   *  runtime-length loop.
+   *  Non-integer orders (e.g. p = 2.5) read |d|^p from a precomputed
+   *  table.
+   *
+   *  \param[in] p      the order of the Lp-norm (p >= 1)
+   *  \param[in] rows   number of rows in each image (0 if unknown)
+   *                    [default is 0]
+   *  \param[in] cols   number of columns in each image (0 if unknown)
+   *                    [default is 0]
+   *  \param[in] level  instruction set to use [default is the widest one
+   *                    supported by the CPU]
+   */
+  explicit MinkowskiKernel(const double p, const int rows = 0,
+                           const int cols = 0,
+                           const SimdLevel level = DetectSimdLevel());
+
+  double order() const { return p_; }
+  SimdLevel level() const { return level_; }
+
+  /// Whether a compile-time specialized Distance<P, Rows, Cols> was chosen
+  bool is_specialized() const { return is_specialized_; }
+
+  /// Whether an SSE2, AVX2 or AVX-512 kernel was chosen (these finish a
+  /// whole image faster than PowerSumBounded() can abandon it chunk by
+  /// chunk)
+  bool is_vectorized() const { return is_vectorized_; }
+
+  /** sum(|a - b|^p), the p-th power of the Minkowski distance (exact for
+   *  integer orders up to 5 on 28x28 images, and monotonic in the distance
+   *  for every order, so it can be used directly to rank neighbors)
+   */
+  double PowerSum(const unsigned char* a, const unsigned char* b,
+                  const std::size_t n) const {
+    return power_sum_(a, b, n,
+                      is_integer_table_
+                          ? static_cast<const void*>(integer_table_.data())
+                          : static_cast<const void*>(real_table_.data()));
+  }
+
+  /** sum(|a - b|^p), abandoned as soon as the partial sum exceeds bound.
+   *  The return value is greater than bound if and only if the complete
+   *  power sum is, and equals PowerSum() whenever it is not.
+   *
+   *  \param[in] a      first image
+   *  \param[in] b      second image
+   *  \param[in] n      number of pixels
+   *  \param[in] bound  power sum beyond which the exact value is not needed
+   *                    (e.g. that of the current k-th nearest neighbor)
+   */
+  double PowerSumBounded(const unsigned char* a, const unsigned char* b,
+                         const std::size_t n, const double bound) const;
+
+  /** Convert a power sum back to the Minkowski distance
+   */
+  double DistanceFromPowerSum(const double power_sum) const;
+
+  /** The Minkowski distance between two images of n pixels
+   */
+  double Distance(const unsigned char* a, const unsigned char* b,
+                  const std::size_t n) const {
+    return DistanceFromPowerSum(PowerSum(a, b, n));
+  }
+
+ private:
+  double p_;
+  SimdLevel level_;
+  PowerSumFunction power_sum_;
+  PowerSumFunction runtime_sum_;
+  bool is_chunk_exact_ = false;
+  bool is_integer_table_ = false;
+  bool is_specialized_ = false;
+  bool is_vectorized_ = false;
+
+  // |d|^p for every possible absolute difference d; integers while a sum
+  // of them cannot overflow, doubles beyond
+  std::array<std::uint64_t, 256> integer_table_{};
+  std::array<double, 256> real_table_{};
+};
+}
@@ -0,0 +1,58 @@
+/** Interface file for the Minkowski distance kernel on 4-bit (nibble)
+ *  packed images.  The power sum sum(|a - b|^p) is taken over the 4-bit
+ *  levels themselves, which ranks neighbors exactly like the distance
+ *  between the Quantize()d 8-bit images (every difference is scaled by the
+ *  same factor of 17).  p = 1 and p = 2 use AVX2 when the CPU has it (the
+ *  nibbles are split with a mask and a shift, then summed with psadbw or
+ *  pmaddubsw); every other order reads |d|^p from a 16-entry table.
+ *
+ *  \file statistics/classifiers/NibbleKernels.h
+ *  \date 17 Oct 2026
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+#include "imgs/statistics/classifiers/MinkowskiKernels.h"
+
+namespace statistics {
+
+class NibbleKernel {
+ public:
+  using PowerSumFunction = double (*)(const unsigned char* a,
+                                      const unsigned char* b,
+                                      const std::size_t bytes,
+                                      const double* table);
+
+  /** Select the kernel for an order
+   *
+   *  \param[in] p      the order of the Minkowski distance (at least 1)
+   *  \param[in] level  instruction set to use [default is the widest one
+   *                    supported by the CPU]
+   */
+  explicit NibbleKernel(const double p,
+                        const SimdLevel level = DetectSimdLevel());
+
+  double order() const { return p_; }
+
+  /** sum(|a - b|^p) over the 4-bit levels of two packed images (exact for
+   *  integer orders up to 11)
+   *
+   *  \param[in] a      first image
+   *  \param[in] b      second image
+   *  \param[in] bytes  number of bytes (the data set stride; the zero
+   *                    padding adds nothing)
+   */
+  double PowerSum(const unsigned char* a, const unsigned char* b,
+                  const std::size_t bytes) const {
+    return power_sum_(a, b, bytes, table_.data());
+  }
+
+ private:
+  double p_;
+  PowerSumFunction power_sum_;
+  std::array<double, 16> table_;
+};
+}
@@ -0,0 +1,370 @@
+/** Implementation file for the principal component projection and the
+ *  nearest-neighbor index in its projected space.
+ *
+ *  \file statistics/classifiers/Pca.cpp
+ *  \date 17 Oct 2026
+ */
+
+#include "imgs/statistics/classifiers/Pca.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+#include <opencv2/opencv.hpp>
+
+#include "imgs/statistics/classifiers/Serialization.h"
+#include "imgs/statistics/parallel/ThreadPool.h"
+
+namespace statistics {
+
+namespace {
+
+// File identification ("PCA1") and layout version
+constexpr std::uint32_t kPcaMagic = 0x31414350u;
+constexpr std::uint32_t kPcaVersion = 1;
+
+// Most projected coordinates of a query kept on the stack (the default 50
+// components take 200 bytes; only projections onto hundreds of components
+// spill to the heap)
+constexpr int kStackQueryFeatures = 256;
+
+// Squared L2 distance between two projections, in four independent sums so
+// that the additions pipeline
+float SquaredDistance(const float* a, const float* b, const int length) {
+  float sums[4] = {0, 0, 0, 0};
+  int j = 0;
+  for (; j + 4 <= length; j += 4) {
+    for (int l = 0; l < 4; ++l) {
+      const float difference = a[j + l] - b[j + l];
+      sums[l] += difference * difference;
+    }
+  }
+  for (; j < length; ++j) {
+    const float difference = a[j] - b[j];
+    sums[0] += difference * difference;
+  }
+  return (sums[0] + sums[1]) + (sums[2] + sums[3]);
+}
+
+// The elements of a vector whose size the reader already knows
+void WriteValues(std::ostream& stream, const std::vector<float>& values) {
+  stream.write(reinterpret_cast<const char*>(values.data()),
+               values.size() * sizeof(float));
+}
+
+bool ReadValues(std::istream& stream, std::vector<float>& values) {
+  stream.read(reinterpret_cast<char*>(values.data()),
+              values.size() * sizeof(float));
+  return static_cast<bool>(stream);
+}
+
+}  // namespace
+
+PcaProjection::PcaProjection(const PackedDataset& training_images,
+                             const PcaParameters& parameters)
+    : number_rows_(training_images.rows()),
+      number_cols_(training_images.cols()) {
+  const std::size_t dimension = training_images.dimension();
+  const std::size_t number_images = training_images.size();
+  const std::size_t number_samples =
+      std::min(parameters.training_sample, number_images);
+  if (number_samples == 0 || dimension == 0) {
+    return;
+  }
+
+  // Evenly spaced training images, one CV_32F row each
+  cv::Mat samples(static_cast<int>(number_samples),
+                  static_cast<int>(dimension), CV_32F);
+  for (std::size_t s = 0; s < number_samples; ++s) {
+    const unsigned char* pixels =
+        training_images.ptr(s * number_images / number_samples);
+    float* row = samples.ptr<float>(static_cast<int>(s));
+    for (std::size_t d = 0; d < dimension; ++d) {
+      row[d] = pixels[d];
+    }
+  }
+
+  const int components = std::max(
+      1, std::min({parameters.components, static_cast<int>(dimension),
+                   static_cast<int>(number_samples)}));
+  cv::PCA pca(samples, cv::noArray(), cv::PCA::DATA_AS_ROW, components);
+  components_ = pca.eigenvectors.rows;
+
+  mean_.resize(dimension);
+  for (std::size_t d = 0; d < dimension; ++d) {
+    mean_[d] = pca.mean.at<float>(0, static_cast<int>(d));
+  }
+  vectors_.resize(components_ * dimension);
+  variances_.resize(components_);
+  for (int j = 0; j < components_; ++j) {
+    const float* axis = pca.eigenvectors.ptr<float>(j);
+    std::copy(axis, axis + dimension, vectors_.begin() + j * dimension);
+    variances_[j] = pca.eigenvalues.at<float>(j, 0);
+  }
+
+  // Total variance (the trace of the sample covariance), for the explained
+  // fraction
+  std::vector<double> sum_squares(dimension, 0);
+  for (std::size_t s = 0; s < number_samples; ++s) {
+    const float* row = samples.ptr<float>(static_cast<int>(s));
+    for (std::size_t d = 0; d < dimension; ++d) {
+      const double difference = row[d] - mean_[d];
+      sum_squares[d] += difference * difference;
+    }
+  }
+  for (const double sum : sum_squares) {
+    total_variance_ += sum / number_samples;
+  }
+  Prepare();
+}
+
+PcaProjection::PcaProjection(const int rows, const int cols,
+                             std::vector<float> mean,
+                             std::vector<float> vectors,
+                             std::vector<float> variances,
+                             const double total_variance)
+    : number_rows_(rows),
+      number_cols_(cols),
+      components_(static_cast<int>(variances.size())),
+      mean_(std::move(mean)),
+      vectors_(std::move(vectors)),
+      variances_(std::move(variances)),
+      total_variance_(total_variance) {
+  Prepare();
+}
+
+void PcaProjection::Prepare() {
+  const std::size_t dimension = this->dimension();
+
+  // Axes transposed (pixel-major), so that projecting runs across the
+  // components in the inner loop and skips the (many) zero pixels
+  axes_.resize(vectors_.size());
+  for (int j = 0; j < components_; ++j) {
+    for (std::size_t d = 0; d < dimension; ++d) {
+      axes_[d * components_ + j] = vectors_[j * dimension + d];
+    }
+  }
+
+  mean_features_.assign(components_, 0);
+  for (int j = 0; j < components_; ++j) {
+    double sum = 0;
+    for (std::size_t d = 0; d < dimension; ++d) {
+      sum += static_cast<double>(mean_[d]) * vectors_[j * dimension + d];
+    }
+    mean_features_[j] = static_cast<float>(sum);
+  }
+}
+
+std::size_t PcaProjection::MemoryBytes() const {
+  return (mean_.capacity() + vectors_.capacity() + variances_.capacity() +
+          axes_.capacity() + mean_features_.capacity()) *
+         sizeof(float);
+}
+
+double PcaProjection::ExplainedVariance() const {
+  if (total_variance_ <= 0) {
+    return 0;
+  }
+  double explained = 0;
+  for (const float variance : variances_) {
+    explained += variance;
+  }
+  return explained / total_variance_;
+}
+
+void PcaProjection::Transform(const unsigned char* image,
+                              float* features) const {
+  // (x - mean) . v = x . v - mean . v
+  std::fill(features, features + components_, 0.0f);
+  const std::size_t dimension = this->dimension();
+  for (std::size_t d = 0; d < dimension; ++d) {
+    if (image[d] == 0) {
+      continue;
+    }
+    const float pixel = image[d];
+    const float* axes = axes_.data() + d * components_;
+    for (int j = 0; j < components_; ++j) {
+      features[j] += pixel * axes[j];
+    }
+  }
+  for (int j = 0; j < components_; ++j) {
+    features[j] -= mean_features_[j];
+  }
+}
+
+std::vector<float> PcaProjection::Transform(
+    const PackedDataset& images, const unsigned int number_threads) const {
+  std::vector<float> features(images.size() * components_);
+  ThreadPool pool(number_threads);
+  pool.ParallelFor(0, images.size(), 256,
+                   [&](std::size_t begin, std::size_t end, unsigned int) {
+                     for (std::size_t idx = begin; idx < end; ++idx) {
+                       Transform(images.ptr(idx),
+                                 features.data() + idx * components_);
+                     }
+                   });
+  return features;
+}
+
+bool WritePcaProjection(std::ostream& stream,
+                        const PcaProjection& projection) {
+  // Header: magic, version, geometry, number of components and the total
+  // variance, then the mean image, the axes and their variances
+  const std::uint32_t header[2] = {kPcaMagic, kPcaVersion};
+  const std::int32_t geometry[3] = {projection.rows(), projection.cols(),
+                                    projection.components()};
+  WriteValue(stream, header);
+  WriteValue(stream, geometry);
+  WriteValue(stream, projection.total_variance());
+  WriteValues(stream, projection.mean());
+  WriteValues(stream, projection.vectors());
+  WriteValues(stream, projection.variances());
+  return static_cast<bool>(stream);
+}
+
+bool ReadPcaProjection(std::istream& stream, PcaProjection& projection) {
+  std::uint32_t header[2] = {0, 0};
+  std::int32_t geometry[3] = {0, 0, 0};
+  double total_variance = 0;
+  if (!ReadValue(stream, header) || !ReadValue(stream, geometry) ||
+      !ReadValue(stream, total_variance) || header[0] != kPcaMagic ||
+      header[1] != kPcaVersion || geometry[0] < 0 || geometry[1] < 0 ||
+      geometry[2] < 0) {
+    return false;
+  }
+
+  const std::size_t dimension =
+      static_cast<std::size_t>(geometry[0]) * geometry[1];
+  const std::size_t components = static_cast<std::size_t>(geometry[2]);
+  // Bound the counts before allocating, as ReadVector does
+  if (dimension > kMaximumSerializedCount ||
+      components > kMaximumSerializedCount ||
+      (dimension != 0 && components > kMaximumSerializedCount / dimension)) {
+    std::cerr << "Corrupt PCA projection: " << components
+              << " components of dimension " << dimension << std::endl;
+    return false;
+  }
+  std::vector<float> mean(dimension);
+  std::vector<float> vectors(components * dimension);
+  std::vector<float> variances(components);
+  if (!ReadValues(stream, mean) || !ReadValues(stream, vectors) ||
+      !ReadValues(stream, variances)) {
+    return false;
+  }
+
+  projection = PcaProjection(geometry[0], geometry[1], std::move(mean),
+                             std::move(vectors), std::move(variances),
+                             total_variance);
+  return true;
+}
+
+bool WritePcaProjection(const std::string filename,
+                        const PcaProjection& projection) {
+  std::ofstream file(filename, std::ios::binary);
+  if (!file.is_open()) {
+    std::cerr << "Unable to open PCA projection file for writing: "
+              << filename << std::endl;
+    return false;
+  }
+  if (!WritePcaProjection(file, projection)) {
+    std::cerr << "Error writing PCA projection file: " << filename
+              << std::endl;
+    return false;
+  }
+  return true;
+}
+
+PcaProjection ReadPcaProjection(const std::string filename) {
+  // Open file
+  std::ifstream file(filename, std::ios::binary);
+  if (!file.is_open()) {
+    // Report error and terminate if file does not exist or could not be opened
+    std::cerr << "Unable to open PCA projection file: " << filename
+              << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  PcaProjection projection;
+  if (!ReadPcaProjection(file, projection)) {
+    std::cerr << "Not a PCA projection file (or truncated, or of an "
+              << "unsupported version): " << filename << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  file.close();
+
+  return projection;
+}
+
+PcaIndex::PcaIndex(const PackedDataset& training_images,
+                   const PcaProjection& projection, const double p,
+                   const std::size_t rerank)
+    : training_images_(training_images),
+      projection_(projection),
+      kernel_(p, training_images.rows(), training_images.cols()),
+      rerank_(rerank) {
+  if (training_images.dimension() != projection.dimension()) {
+    std::cerr << "PCA projection and training image sizes differ!"
+              << std::endl;
+    training_images_ = PackedDataset();
+    return;
+  }
+  features_ = projection_.Transform(training_images_);
+}
+
+std::size_t PcaIndex::MemoryBytes() const {
+  return features_.capacity() * sizeof(float) + projection_.MemoryBytes();
+}
+
+void PcaIndex::Nearest(const unsigned char* image, TopK& neighbors,
+                       KnnStatistics& statistics) const {
+  const std::size_t number_training = size();
+  const int components = projection_.components();
+  statistics.candidates += number_training;
+
+  // The query's coordinates on the stack, or in a per-worker buffer for
+  // unusually many components, so no query allocates
+  float stack_query[kStackQueryFeatures];
+  thread_local std::vector<float> heap_query;
+  float* query = stack_query;
+  if (components > kStackQueryFeatures) {
+    heap_query.resize(components);
+    query = heap_query.data();
+  }
+  projection_.Transform(image, query);
+
+  if (rerank_ == 0) {
+    for (std::size_t i = 0; i < number_training; ++i) {
+      neighbors.Push(SquaredDistance(query,
+                                     features_.data() + i * components,
+                                     components),
+                     i);
+    }
+    statistics.skipped += number_training;
+    return;
+  }
+
+  // The nearest candidates in the projected space, then their exact power
+  // sums in pixel space (the shortlist reuses a per-worker buffer)
+  thread_local TopK candidates;
+  candidates.Reset(static_cast<int>(std::max(rerank_, neighbors.k())));
+  for (std::size_t i = 0; i < number_training; ++i) {
+    candidates.Push(SquaredDistance(query,
+                                    features_.data() + i * components,
+                                    components),
+                    i);
+  }
+  for (const auto& candidate : candidates) {
+    neighbors.Push(kernel_.PowerSum(image,
+                                    training_images_.ptr(candidate.index),
+                                    training_images_.dimension()),
+                   candidate.index);
+  }
+  statistics.completed += candidates.size();
+  statistics.skipped += number_training - candidates.size();
+}
+}
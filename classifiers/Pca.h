@@ -0,0 +1,225 @@
+/** Interface file for a principal component projection of packed images,
+ *  and a nearest-neighbor index that searches in the projected space.
+ *
+ *  Most of the variance of character images lies in a few dozen principal
+ *  components, so the squared L2 distance between their projections onto
+ *  those components approximates the pixel-space L2 distance at a fraction
+ *  of the cost (50 products per training image instead of 784).  The
+ *  projection is learned once from the training images (cv::PCA on an
+ *  evenly spaced sample), can be written to and read back from a file so
+ *  that test images are projected with exactly the components the model
+ *  was built with, and is then applied to every test image.
+ *
+ *  Optionally the index re-ranks the nearest candidates of the projected
+ *  search by their exact power sums in pixel space, which restores the
+ *  pixel-space ordering of the final k neighbors for any Minkowski order.
+ *
+ *  \file statistics/classifiers/Pca.h
+ *  \date 17 Oct 2026
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "imgs/statistics/classifiers/MinkowskiKernels.h"
+#include "imgs/statistics/classifiers/PrunedSearch.h"
+#include "imgs/statistics/classifiers/TopK.h"
+#include "imgs/statistics/data_readers/PackedDataset.h"
+
+namespace statistics {
+
+/** Learning parameters of a principal component projection
+ */
+struct PcaParameters {
+  /// Number of principal components kept (features per projected image)
+  int components = 50;
+
+  /// Training images the components are learned from (evenly spaced
+  /// through the training set; all of them if there are fewer)
+  std::size_t training_sample = 20000;
+};
+
+class PcaProjection {
+ public:
+  /** Construct an empty projection
+   */
+  PcaProjection() = default;
+
+  /** Learn the principal components of a training set
+   *
+   *  \param[in] training_images  packed training images
+   *  \param[in] parameters       learning parameters [default is 50
+   *                              components from 20000 images]
+   */
+  explicit PcaProjection(const PackedDataset& training_images,
+                         const PcaParameters& parameters = PcaParameters());
+
+  /** Construct a projection from previously learned components (e.g. as
+   *  read back from a file)
+   *
+   *  \param[in] rows        image rows the projection applies to
+   *  \param[in] cols        image columns the projection applies to
+   *  \param[in] mean        mean image (rows * cols values)
+   *  \param[in] vectors     components x (rows * cols) principal axes, one
+   *                         unit vector per row, largest variance first
+   *  \param[in] variances   variance along each principal axis
+   *  \param[in] total_variance  total variance of the training pixels
+   */
+  PcaProjection(const int rows, const int cols, std::vector<float> mean,
+                std::vector<float> vectors, std::vector<float> variances,
+                const double total_variance);
+
+  bool empty() const { return components_ == 0; }
+  int rows() const { return number_rows_; }
+  int cols() const { return number_cols_; }
+  std::size_t dimension() const {
+    return static_cast<std::size_t>(number_rows_) * number_cols_;
+  }
+  int components() const { return components_; }
+
+  const std::vector<float>& mean() const { return mean_; }
+  const std::vector<float>& vectors() const { return vectors_; }
+  const std::vector<float>& variances() const { return variances_; }
+  double total_variance() const { return total_variance_; }
+
+  /// Bytes held by the mean, the axes (in both layouts) and the variances
+  std::size_t MemoryBytes() const;
+
+  /// Fraction of the training pixels' variance the kept components explain
+  double ExplainedVariance() const;
+
+  /** Project one image
+   *
+   *  \param[in]  image     the image (dimension() pixels)
+   *  \param[out] features  its components() coordinates along the
+   *                        principal axes
+   */
+  void Transform(const unsigned char* image, float* features) const;
+
+  /** Project every image of a data set
+   *
+   *  \param[in] images          packed images of this projection's size
+   *  \param[in] number_threads  threads to project with (0 uses one per
+   *                             hardware thread) [default is 0]
+   *  \return                    images.size() x components() coordinates
+   */
+  std::vector<float> Transform(const PackedDataset& images,
+                               const unsigned int number_threads = 0) const;
+
+ private:
+  // Derive the projection tables from the mean and the axes
+  void Prepare();
+
+  int number_rows_ = 0;
+  int number_cols_ = 0;
+  int components_ = 0;
+  std::vector<float> mean_;
+  std::vector<float> vectors_;
+  std::vector<float> variances_;
+  double total_variance_ = 0;
+
+  // The axes pixel-major (dimension() rows of components_ values), and the
+  // projection of the mean image, subtracted from every projection so that
+  // the pixels need no centering
+  std::vector<float> axes_;
+  std::vector<float> mean_features_;
+};
+
+/** Write a projection to a binary file
+ *
+ *  \param[in] filename    path of the file to (over)write
+ *  \param[in] projection  the learned projection
+ *  \return                whether the file was written completely
+ */
+bool WritePcaProjection(const std::string filename,
+                        const PcaProjection& projection);
+
+/** Read a projection written by WritePcaProjection()
+ *
+ *  \param[in] filename  path of the file to read
+ *  \return              the projection
+ */
+PcaProjection ReadPcaProjection(const std::string filename);
+
+/** Write a projection to a binary stream (e.g. inside a model file), in
+ *  the layout of WritePcaProjection()
+ *
+ *  \return  whether the stream is still good
+ */
+bool WritePcaProjection(std::ostream& stream, const PcaProjection& projection);
+
+/** Read a projection written by WritePcaProjection() from a binary stream
+ *
+ *  \param[in]  stream      binary stream positioned at the projection
+ *  \param[out] projection  the projection read (unchanged on failure)
+ *  \return                 whether a complete projection was read
+ */
+bool ReadPcaProjection(std::istream& stream, PcaProjection& projection);
+
+class PcaIndex {
+ public:
+  /** Construct an empty index
+   */
+  PcaIndex() = default;
+
+  /** Project a training set to build the index over
+   *
+   *  \param[in] training_images  packed training images (and labels); the
+   *                              pixels are shared with, not copied from,
+   *                              the data set
+   *  \param[in] projection       the projection to search in (usually
+   *                              learned from the same training images)
+   *  \param[in] p                the order of the Minkowski distance the
+   *                              re-rank uses (at least 1) [default is 2]
+   *  \param[in] rerank           number of projected-space candidates
+   *                              re-ranked by their exact pixel-space power
+   *                              sums (at least k are used); 0 ranks by the
+   *                              projected squared L2 distance alone
+   *                              [default is 0]
+   */
+  PcaIndex(const PackedDataset& training_images,
+           const PcaProjection& projection, const double p = 2,
+           const std::size_t rerank = 0);
+
+  const PackedDataset& training_images() const { return training_images_; }
+  const PcaProjection& projection() const { return projection_; }
+  double order() const { return kernel_.order(); }
+  std::size_t size() const { return training_images_.size(); }
+  bool empty() const { return training_images_.empty(); }
+  std::size_t rerank() const { return rerank_; }
+
+  /// Change the number of re-ranked candidates (0 turns the re-rank off)
+  void set_rerank(const std::size_t rerank) { rerank_ = rerank; }
+
+  /// Bytes held by the projected training features and the projection
+  std::size_t MemoryBytes() const;
+
+  /** Offer the (approximately) nearest training images of an image to its
+   *  selection: exact power sums when re-ranking, otherwise the squared L2
+   *  distances between the projections
+   *
+   *  \param[in]     image       the image to search for
+   *  \param[in,out] neighbors   the k nearest so far
+   *  \param[in,out] statistics  counts to add this search's to (completed
+   *                             are the pixel-space comparisons, skipped
+   *                             the training images only compared in the
+   *                             projected space)
+   */
+  void Nearest(const unsigned char* image, TopK& neighbors,
+               KnnStatistics& statistics) const;
+
+ private:
+  PackedDataset training_images_;
+  PcaProjection projection_;
+  MinkowskiKernel kernel_{2};
+  std::size_t rerank_ = 0;
+
+  // Projected training images, components() values each
+  std::vector<float> features_;
+};
+}
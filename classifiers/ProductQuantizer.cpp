@@ -0,0 +1,206 @@
+/** Implementation file for the product-quantized training store.
+ *
+ *  \file statistics/classifiers/ProductQuantizer.cpp
+ *  \date 17 Oct 2026
+ */
+
+#include "imgs/statistics/classifiers/ProductQuantizer.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "imgs/statistics/parallel/ThreadPool.h"
+
+namespace statistics {
+
+namespace {
+
+// Largest codebook addressable by a one-byte code
+constexpr int kMaximumCentroids = 256;
+
+// Largest integer order whose powers are taken by repeated multiplication
+// rather than std::pow
+constexpr double kMaximumMultipliedOrder = 16;
+
+// Index of the centroid nearest (in squared L2) to a subspace of pixels;
+// the codebook is stored pixel-major, so the inner loop runs across the
+// centroids and vectorizes
+int NearestCentroid(const unsigned char* pixels, const float* codebook,
+                    const int number_centroids, const std::size_t length,
+                    std::vector<float>& distances) {
+  distances.assign(number_centroids, 0);
+  for (std::size_t d = 0; d < length; ++d) {
+    const float pixel = pixels[d];
+    const float* row = codebook + d * number_centroids;
+    for (int c = 0; c < number_centroids; ++c) {
+      const float difference = pixel - row[c];
+      distances[c] += difference * difference;
+    }
+  }
+  return static_cast<int>(std::min_element(distances.begin(), distances.end()) -
+                          distances.begin());
+}
+
+// Add power(|pixel - centroid|) over one subspace to the row of every
+// centroid; the order is resolved by the caller, once per table
+template <typename Power>
+void AddPowers(const unsigned char* pixels, const float* codebook,
+               const int number_centroids, const std::size_t length,
+               double* row, const Power& power) {
+  for (std::size_t d = 0; d < length; ++d) {
+    const double pixel = pixels[d];
+    const float* centroid_pixels = codebook + d * number_centroids;
+    for (int c = 0; c < number_centroids; ++c) {
+      row[c] += power(std::abs(pixel - centroid_pixels[c]));
+    }
+  }
+}
+
+// |difference|^p for an integer order, by repeated multiplication
+struct IntegerPower {
+  int order;
+  double operator()(const double difference) const {
+    double power = difference;
+    for (int i = 1; i < order; ++i) {
+      power *= difference;
+    }
+    return power;
+  }
+};
+
+}  // namespace
+
+ProductQuantizer::ProductQuantizer(const PackedDataset& training_images,
+                                   const PqParameters& parameters)
+    : number_images_(training_images.size()),
+      number_rows_(training_images.rows()),
+      number_cols_(training_images.cols()) {
+  const std::size_t dimension = training_images.dimension();
+  subspaces_ = std::max(
+      1, std::min(parameters.subspaces, static_cast<int>(dimension)));
+
+  // Codebooks are learned from evenly spaced training images
+  const std::size_t number_samples =
+      std::min(parameters.training_sample, number_images_);
+  std::vector<std::size_t> samples(number_samples);
+  for (std::size_t s = 0; s < number_samples; ++s) {
+    samples[s] = s * number_images_ / number_samples;
+  }
+  const int sampled = static_cast<int>(
+      std::min<std::size_t>(number_samples, kMaximumCentroids));
+  centroids_ = std::max(
+      1, std::min({parameters.centroids, kMaximumCentroids, sampled}));
+
+  // Subspaces as equal (to within a pixel) contiguous runs of pixels
+  offsets_.resize(subspaces_ + 1);
+  for (int m = 0; m <= subspaces_; ++m) {
+    offsets_[m] = m * dimension / subspaces_;
+  }
+  codebooks_.assign(centroids_ * dimension, 0);
+  codes_.assign(number_images_ * subspaces_, 0);
+
+  ThreadPool pool(parameters.number_threads);
+
+  // k-means per subspace (independent, so the subspaces are split across
+  // the threads), seeded with evenly spaced samples
+  pool.ParallelFor(
+      0, subspaces_, 1, [&](std::size_t begin, std::size_t end, unsigned int) {
+        std::vector<double> sums;
+        std::vector<std::size_t> counts;
+        std::vector<float> distances;
+        for (std::size_t m = begin; m < end; ++m) {
+          const std::size_t offset = offsets_[m];
+          const std::size_t length = offsets_[m + 1] - offset;
+          float* codebook = codebooks_.data() + centroids_ * offset;
+          if (number_samples == 0) {
+            continue;
+          }
+          for (int c = 0; c < centroids_; ++c) {
+            const unsigned char* pixels =
+                training_images.ptr(samples[c * number_samples / centroids_]) +
+                offset;
+            for (std::size_t d = 0; d < length; ++d) {
+              codebook[d * centroids_ + c] = pixels[d];
+            }
+          }
+
+          for (int iteration = 0; iteration < parameters.iterations;
+               ++iteration) {
+            sums.assign(centroids_ * length, 0);
+            counts.assign(centroids_, 0);
+            for (std::size_t s = 0; s < number_samples; ++s) {
+              const unsigned char* pixels =
+                  training_images.ptr(samples[s]) + offset;
+              int c = NearestCentroid(pixels, codebook, centroids_, length,
+                                      distances);
+              ++counts[c];
+              for (std::size_t d = 0; d < length; ++d) {
+                sums[c * length + d] += pixels[d];
+              }
+            }
+            // (a centroid that lost all of its samples keeps its place)
+            for (int c = 0; c < centroids_; ++c) {
+              if (counts[c] == 0) {
+                continue;
+              }
+              for (std::size_t d = 0; d < length; ++d) {
+                codebook[d * centroids_ + c] =
+                    static_cast<float>(sums[c * length + d] / counts[c]);
+              }
+            }
+          }
+        }
+      });
+
+  // Encode every training image
+  pool.ParallelFor(
+      0, number_images_, 256,
+      [&](std::size_t begin, std::size_t end, unsigned int) {
+        std::vector<float> distances;
+        for (std::size_t idx = begin; idx < end; ++idx) {
+          const unsigned char* pixels = training_images.ptr(idx);
+          unsigned char* image_code = codes_.data() + idx * subspaces_;
+          for (int m = 0; m < subspaces_; ++m) {
+            const std::size_t offset = offsets_[m];
+            image_code[m] = static_cast<unsigned char>(NearestCentroid(
+                pixels + offset, codebooks_.data() + centroids_ * offset,
+                centroids_, offsets_[m + 1] - offset, distances));
+          }
+        }
+      });
+
+  if (training_images.has_labels()) {
+    labels_ = training_images.LabelVector();
+    has_labels_ = true;
+  }
+}
+
+std::size_t ProductQuantizer::MemoryBytes() const {
+  return codes_.size() + codebooks_.size() * sizeof(float) +
+         offsets_.size() * sizeof(std::size_t) + labels_.size();
+}
+
+void ProductQuantizer::DistanceTable(const unsigned char* image,
+                                     const double p,
+                                     std::vector<double>& table) const {
+  table.assign(static_cast<std::size_t>(subspaces_) * centroids_, 0.0);
+  auto fill = [&](const auto& power) {
+    for (int m = 0; m < subspaces_; ++m) {
+      const std::size_t offset = offsets_[m];
+      AddPowers(image + offset, codebooks_.data() + centroids_ * offset,
+                centroids_, offsets_[m + 1] - offset,
+                table.data() + m * centroids_, power);
+    }
+  };
+
+  if (p == 1) {
+    fill([](const double difference) { return difference; });
+  } else if (p == 2) {
+    fill([](const double difference) { return difference * difference; });
+  } else if (p >= 1 && p <= kMaximumMultipliedOrder && p == std::floor(p)) {
+    fill(IntegerPower{static_cast<int>(p)});
+  } else {
+    fill([p](const double difference) { return std::pow(difference, p); });
+  }
+}
+}
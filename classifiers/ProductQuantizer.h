@@ -0,0 +1,123 @@
+/** Interface file for a product-quantized training store.  The pixels of
+ *  every image are split into contiguous subspaces (49 of 16 pixels for a
+ *  28 x 28 character), a codebook of up to 256 centroids is learned for
+ *  each subspace by k-means, and each training image is then stored as one
+ *  byte per subspace: the index of its nearest centroid (49 bytes instead
+ *  of 784 per character).
+ *
+ *  Distances are asymmetric: the test image keeps its exact pixels, and
+ *  one table of sum(|q - c|^p) over each subspace's pixels is built per
+ *  test image for every centroid, so the approximate power sum to a
+ *  training image is one table lookup per subspace.
+ *
+ *  \file statistics/classifiers/ProductQuantizer.h
+ *  \date 17 Oct 2026
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "imgs/statistics/data_readers/PackedDataset.h"
+
+namespace statistics {
+
+/** Training parameters of a product quantizer
+ */
+struct PqParameters {
+  /// Number of subspaces (bytes per encoded image)
+  int subspaces = 49;
+
+  /// Centroids per subspace (at most 256)
+  int centroids = 256;
+
+  /// k-means iterations per codebook
+  int iterations = 8;
+
+  /// Training images the codebooks are learned from (evenly spaced through
+  /// the training set; all of them if there are fewer)
+  std::size_t training_sample = 20000;
+
+  /// Threads for learning and encoding (0 uses one per hardware thread)
+  unsigned int number_threads = 0;
+};
+
+class ProductQuantizer {
+ public:
+  /** Construct an empty quantizer
+   */
+  ProductQuantizer() = default;
+
+  /** Learn the codebooks from a training set and encode all of it (the
+   *  training pixels are not kept)
+   *
+   *  \param[in] training_images  packed training images (and labels)
+   *  \param[in] parameters       training parameters [default is 49
+   *                              subspaces of 256 centroids]
+   */
+  explicit ProductQuantizer(const PackedDataset& training_images,
+                            const PqParameters& parameters = PqParameters());
+
+  std::size_t size() const { return number_images_; }
+  bool empty() const { return number_images_ == 0; }
+  int rows() const { return number_rows_; }
+  int cols() const { return number_cols_; }
+  std::size_t dimension() const {
+    return static_cast<std::size_t>(number_rows_) * number_cols_;
+  }
+  int subspaces() const { return subspaces_; }
+  int centroids() const { return centroids_; }
+
+  bool has_labels() const { return has_labels_; }
+  unsigned char label(const std::size_t idx) const { return labels_[idx]; }
+
+  /// Centroid index of every subspace of one training image
+  const unsigned char* code(const std::size_t idx) const {
+    return codes_.data() + idx * subspaces_;
+  }
+
+  /// Bytes held by the codes, codebooks and labels
+  std::size_t MemoryBytes() const;
+
+  /** Build the asymmetric distance table of one test image
+   *
+   *  \param[in]  image  the test image (dimension() pixels)
+   *  \param[in]  p      the order of the Minkowski distance
+   *  \param[out] table  subspaces() x centroids() power sums of the test
+   *                     image's pixels to every centroid
+   */
+  void DistanceTable(const unsigned char* image, const double p,
+                     std::vector<double>& table) const;
+
+  /** Approximate sum(|a - b|^p) between a test image (through its distance
+   *  table) and one encoded training image
+   */
+  double AsymmetricPowerSum(const double* table, const std::size_t idx) const {
+    const unsigned char* training_code = code(idx);
+    double sum = 0;
+    for (int m = 0; m < subspaces_; ++m) {
+      sum += table[m * centroids_ + training_code[m]];
+    }
+    return sum;
+  }
+
+ private:
+  std::size_t number_images_ = 0;
+  int number_rows_ = 0;
+  int number_cols_ = 0;
+  int subspaces_ = 0;
+  int centroids_ = 0;
+
+  // First pixel of every subspace (subspaces_ + 1 values), and the
+  // centroids of subspace m at codebooks_[centroids_ * offsets_[m]], one
+  // row of centroids_ values per pixel of the subspace
+  std::vector<std::size_t> offsets_;
+  std::vector<float> codebooks_;
+
+  std::vector<unsigned char> codes_;
+  std::vector<unsigned char> labels_;
+  bool has_labels_ = false;
+};
+}
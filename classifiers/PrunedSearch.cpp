@@ -0,0 +1,277 @@
+/** Implementation file for the pruned exact nearest-neighbor search.
+ *
+ *  \file statistics/classifiers/PrunedSearch.cpp
+ *  \date 17 Oct 2026
+ */
+
+#include "imgs/statistics/classifiers/PrunedSearch.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+namespace statistics {
+
+namespace {
+
+// Relative and absolute slack on every threshold, so that a candidate is
+// only rejected when its distance is certainly beyond the bound despite
+// rounding in the (floating point) thresholds
+constexpr double kRelativeSlack = 1e-9;
+constexpr double kAbsoluteSlack = 1e-6;
+
+double WithSlack(const double threshold) {
+  return threshold * (1 + kRelativeSlack) + kAbsoluteSlack;
+}
+
+}  // namespace
+
+PrunedSearch::PrunedSearch(const PackedDataset& training_images,
+                           const MinkowskiKernel& kernel)
+    : training_images_(training_images), kernel_(kernel) {
+  const std::size_t number_training = training_images.size();
+  const std::uint32_t* pixel_sums = training_images.pixel_sums();
+
+  order_.resize(number_training);
+  for (std::size_t i = 0; i < number_training; ++i) {
+    order_[i] = i;
+  }
+  std::sort(order_.begin(), order_.end(),
+            [pixel_sums](const std::size_t a, const std::size_t b) {
+              return pixel_sums[a] < pixel_sums[b] ||
+                     (pixel_sums[a] == pixel_sums[b] && a < b);
+            });
+
+  sorted_sums_.resize(number_training);
+  for (std::size_t i = 0; i < number_training; ++i) {
+    sorted_sums_[i] = pixel_sums[order_[i]];
+  }
+
+  // The norm bound is skipped for images whose squared norms wrap
+  use_norms_ = (training_images.dimension() <= kMaximumNormDimension);
+  if (use_norms_) {
+    const std::uint32_t* squared_norms = training_images.squared_norms();
+    norms_.resize(number_training);
+    for (std::size_t i = 0; i < number_training; ++i) {
+      norms_[i] = std::sqrt(static_cast<double>(squared_norms[i]));
+    }
+  }
+}
+
+std::size_t PrunedSearch::Position(const std::size_t idx) const {
+  const std::uint32_t pixel_sum = training_images_.pixel_sums()[idx];
+  std::size_t position =
+      std::lower_bound(sorted_sums_.begin(), sorted_sums_.end(), pixel_sum) -
+      sorted_sums_.begin();
+  while (order_[position] != idx) {
+    ++position;
+  }
+  return position;
+}
+
+void PrunedSearch::Insert(const std::size_t idx) {
+  // After the images of equal pixel sum, which keeps the (sum, index) order
+  const std::uint32_t pixel_sum = training_images_.pixel_sums()[idx];
+  const std::size_t position =
+      std::upper_bound(sorted_sums_.begin(), sorted_sums_.end(), pixel_sum) -
+      sorted_sums_.begin();
+  order_.insert(order_.begin() + position, idx);
+  sorted_sums_.insert(sorted_sums_.begin() + position, pixel_sum);
+  if (use_norms_) {
+    norms_.push_back(
+        std::sqrt(static_cast<double>(training_images_.squared_norms()[idx])));
+  }
+}
+
+void PrunedSearch::Remove(const std::size_t idx, const std::size_t last) {
+  const std::size_t position = Position(idx);
+  order_.erase(order_.begin() + position);
+  sorted_sums_.erase(sorted_sums_.begin() + position);
+
+  // The last image keeps its place in the order under its new index (the
+  // search only needs the order by pixel sum, not among equal sums)
+  if (idx != last) {
+    order_[Position(last)] = idx;
+  }
+  if (use_norms_) {
+    norms_[idx] = norms_[last];
+    norms_.pop_back();
+  }
+}
+
+PrunedSearch::Query PrunedSearch::MakeQuery(const PackedDataset& test_images,
+                                            const std::size_t t) const {
+  return Query{test_images.ptr(t), test_images.pixel_sums()[t],
+               test_images.row_sums(t),
+               std::sqrt(static_cast<double>(test_images.squared_norms()[t]))};
+}
+
+PrunedSearch::Query PrunedSearch::MakeQuery(const unsigned char* image,
+                                            std::uint32_t* row_sums) const {
+  const int number_rows = training_images_.rows();
+  const int number_cols = training_images_.cols();
+  std::uint32_t squared_norm = 0;
+  std::uint32_t pixel_sum = 0;
+  for (int r = 0; r < number_rows; ++r) {
+    std::uint32_t row_sum = 0;
+    for (int c = 0; c < number_cols; ++c) {
+      std::uint32_t pixel = image[r * number_cols + c];
+      squared_norm += pixel * pixel;
+      row_sum += pixel;
+    }
+    row_sums[r] = row_sum;
+    pixel_sum += row_sum;
+  }
+  return Query{image, pixel_sum, row_sums,
+               std::sqrt(static_cast<double>(squared_norm))};
+}
+
+void PrunedSearch::Update(const TopK& neighbors,
+                          Thresholds& thresholds) const {
+  const double bound = neighbors.Bound();
+  if (bound == thresholds.bound) {
+    return;
+  }
+  thresholds.bound = bound;
+
+  // For a difference x of n pixels, ||x||_1 <= n^(1 - 1/p) ||x||_p, and
+  // ||x||_2 <= ||x||_p (p <= 2) or ||x||_2 <= n^(1/2 - 1/p) ||x||_p (p > 2)
+  const double n = static_cast<double>(training_images_.dimension());
+  const double p = kernel_.order();
+  thresholds.l1 = WithSlack(n * std::pow(bound / n, 1 / p));
+  thresholds.l2 = (p <= 2) ? std::pow(bound, 1 / p)
+                           : std::pow(bound * std::pow(n, p / 2 - 1), 1 / p);
+  thresholds.l2 = WithSlack(thresholds.l2);
+}
+
+void PrunedSearch::Offer(const Query& query, const std::size_t idx,
+                         TopK& neighbors, Thresholds& thresholds,
+                         KnnStatistics& statistics) const {
+  const unsigned char* training_ptr = training_images_.ptr(idx);
+  const std::size_t number_pixels = training_images_.dimension();
+
+  // Nothing can be rejected until k neighbors are held
+  if (!neighbors.full()) {
+    neighbors.Push(kernel_.PowerSum(query.pixels, training_ptr, number_pixels),
+                   idx);
+    ++statistics.completed;
+    return;
+  }
+  Update(neighbors, thresholds);
+
+  // |sum(a) - sum(b)| <= sum over rows |rowsum(a) - rowsum(b)| <= ||a - b||_1
+  const std::uint32_t pixel_sum = training_images_.pixel_sums()[idx];
+  const double sum_difference =
+      (query.pixel_sum > pixel_sum) ? query.pixel_sum - pixel_sum
+                                    : pixel_sum - query.pixel_sum;
+  if (sum_difference > thresholds.l1) {
+    ++statistics.rejected;
+    return;
+  }
+
+  const std::uint32_t* row_sums = training_images_.row_sums(idx);
+  std::uint64_t row_difference = 0;
+  for (int r = 0; r < training_images_.rows(); ++r) {
+    row_difference += (query.row_sums[r] > row_sums[r])
+                          ? query.row_sums[r] - row_sums[r]
+                          : row_sums[r] - query.row_sums[r];
+  }
+  if (static_cast<double>(row_difference) > thresholds.l1) {
+    ++statistics.rejected;
+    return;
+  }
+
+  // | ||a||_2 - ||b||_2 | <= ||a - b||_2 (when the norms are exact)
+  if (use_norms_ && std::abs(query.norm - norms_[idx]) > thresholds.l2) {
+    ++statistics.rejected;
+    return;
+  }
+
+  const double power_sum = kernel_.PowerSumBounded(
+      query.pixels, training_ptr, number_pixels, thresholds.bound);
+  if (power_sum > thresholds.bound) {
+    ++statistics.abandoned;
+    return;
+  }
+  neighbors.Push(power_sum, idx);
+  ++statistics.completed;
+}
+
+void PrunedSearch::Nearest(const PackedDataset& test_images,
+                           const std::size_t t, TopK& neighbors,
+                           KnnStatistics& statistics) const {
+  Search(MakeQuery(test_images, t), neighbors, statistics);
+}
+
+void PrunedSearch::Nearest(const unsigned char* image, TopK& neighbors,
+                           KnnStatistics& statistics) const {
+  std::uint32_t stack_row_sums[kQueryStackRows];
+  std::vector<std::uint32_t> heap_row_sums;
+  std::uint32_t* row_sums = stack_row_sums;
+  if (training_images_.rows() > kQueryStackRows) {
+    heap_row_sums.resize(training_images_.rows());
+    row_sums = heap_row_sums.data();
+  }
+  Search(MakeQuery(image, row_sums), neighbors, statistics);
+}
+
+void PrunedSearch::Search(const Query& query, TopK& neighbors,
+                          KnnStatistics& statistics) const {
+  const std::size_t number_training = order_.size();
+  statistics.candidates += number_training;
+
+  // Walk outward from the test image's pixel sum, always taking the side
+  // with the smaller difference, so that once that difference rules a
+  // candidate out it rules out every candidate left on both sides
+  std::size_t above =
+      std::lower_bound(sorted_sums_.begin(), sorted_sums_.end(),
+                       query.pixel_sum) -
+      sorted_sums_.begin();
+  std::size_t below = above;
+  std::size_t visited = 0;
+  Thresholds thresholds;
+  while (below > 0 || above < number_training) {
+    bool take_above;
+    if (below == 0) {
+      take_above = true;
+    } else if (above == number_training) {
+      take_above = false;
+    } else {
+      take_above = sorted_sums_[above] - query.pixel_sum <=
+                   query.pixel_sum - sorted_sums_[below - 1];
+    }
+    const std::size_t position = take_above ? above : below - 1;
+
+    if (neighbors.full()) {
+      Update(neighbors, thresholds);
+      const std::uint32_t pixel_sum = sorted_sums_[position];
+      const double sum_difference = take_above ? pixel_sum - query.pixel_sum
+                                               : query.pixel_sum - pixel_sum;
+      if (sum_difference > thresholds.l1) {
+        break;
+      }
+    }
+
+    Offer(query, order_[position], neighbors, thresholds, statistics);
+    ++visited;
+    if (take_above) {
+      ++above;
+    } else {
+      --below;
+    }
+  }
+  statistics.skipped += number_training - visited;
+}
+
+void PrunedSearch::NearestInRange(const PackedDataset& test_images,
+                                  const std::size_t t, const std::size_t begin,
+                                  const std::size_t end, TopK& neighbors,
+                                  KnnStatistics& statistics) const {
+  const Query query = MakeQuery(test_images, t);
+  statistics.candidates += end - begin;
+  Thresholds thresholds;
+  for (std::size_t i = begin; i < end; ++i) {
+    Offer(query, i, neighbors, thresholds, statistics);
+  }
+}
+}
@@ -0,0 +1,165 @@
+/** Interface file for the pruned exact nearest-neighbor search.  Most of the
+ *  training set is far from any given test image, so instead of computing
+ *  every power sum in full the search
+ *
+ *    - visits the training images in order of their pixel sum (their L1
+ *      norm), starting from the test image's own, and stops as soon as the
+ *      difference of the sums alone rules out every image left,
+ *    - rejects a candidate whose cheap lower bounds (from the pixel sums,
+ *      the row sums and the L2 norms cached at load time) already exceed
+ *      the current k-th nearest distance, and
+ *    - abandons a power sum part way through once it exceeds that distance.
+ *
+ *  Every bound is a true lower bound on the Minkowski distance, so exactly
+ *  the same k neighbors are found as by the full scan.
+ *
+ *  \file statistics/classifiers/PrunedSearch.h
+ *  \date 17 Oct 2026
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "imgs/statistics/classifiers/MinkowskiKernels.h"
+#include "imgs/statistics/classifiers/TopK.h"
+#include "imgs/statistics/data_readers/PackedDataset.h"
+
+namespace statistics {
+
+/** Counts of how the candidates of a pruned search were disposed of
+ */
+struct KnnStatistics {
+  /// (test, training) pairs considered
+  std::size_t candidates = 0;
+
+  /// Never visited: ruled out by the pixel-sum order of the training set
+  std::size_t skipped = 0;
+
+  /// Rejected by a lower bound without touching the pixels
+  std::size_t rejected = 0;
+
+  /// Power sum abandoned part way through
+  std::size_t abandoned = 0;
+
+  /// Power sum computed in full
+  std::size_t completed = 0;
+
+  /// Fraction of the candidates whose power sum was not computed in full
+  double PruningRate() const {
+    return (candidates == 0)
+               ? 0
+               : 1 - static_cast<double>(completed) / candidates;
+  }
+
+  void Add(const KnnStatistics& other) {
+    candidates += other.candidates;
+    skipped += other.skipped;
+    rejected += other.rejected;
+    abandoned += other.abandoned;
+    completed += other.completed;
+  }
+};
+
+class PrunedSearch {
+ public:
+  /** Index one training set for pruned searches
+   *
+   *  \param[in] training_images  packed training images with their
+   *                              statistics computed
+   *  \param[in] kernel           distance kernel of the search (both must
+   *                              outlive this object)
+   */
+  PrunedSearch(const PackedDataset& training_images,
+               const MinkowskiKernel& kernel);
+
+  /** Offer the whole training set, nearest pixel sums first
+   *
+   *  \param[in]     test_images  packed test images with their statistics
+   *                              computed
+   *  \param[in]     t            index of the test image
+   *  \param[in,out] neighbors    the k nearest so far
+   *  \param[in,out] statistics   counts to add this search's to
+   */
+  void Nearest(const PackedDataset& test_images, const std::size_t t,
+               TopK& neighbors, KnnStatistics& statistics) const;
+
+  /** Offer the whole training set to one image given by its pixels alone
+   *  (its pixel sum, row sums and norm are computed here, without
+   *  allocating for images of up to kQueryStackRows rows)
+   *
+   *  \param[in]     image       the test image (the training geometry)
+   *  \param[in,out] neighbors   the k nearest so far
+   *  \param[in,out] statistics  counts to add this search's to
+   */
+  void Nearest(const unsigned char* image, TopK& neighbors,
+               KnnStatistics& statistics) const;
+
+  /** Offer the training images [begin, end) in index order (e.g. one shard
+   *  of the training set), with the same bounds and early abandoning
+   */
+  void NearestInRange(const PackedDataset& test_images, const std::size_t t,
+                      const std::size_t begin, const std::size_t end,
+                      TopK& neighbors, KnnStatistics& statistics) const;
+
+  /** Index a training image just appended to the training set (whose
+   *  statistics must already be computed), without re-sorting
+   *
+   *  \param[in] idx  index of the new image, the training set's last
+   */
+  void Insert(const std::size_t idx);
+
+  /** Drop a training image from the index ahead of its removal from the
+   *  training set, where the last image is then moved into its place
+   *
+   *  \param[in] idx   index of the image being removed
+   *  \param[in] last  index of the training set's last image (idx itself
+   *                   when the last image is the one removed)
+   */
+  void Remove(const std::size_t idx, const std::size_t last);
+
+ private:
+  // Lower bound thresholds implied by the current k-th nearest power sum
+  struct Thresholds {
+    double bound = -1;
+    double l1 = 0;
+    double l2 = 0;
+  };
+
+  // Summary of the test image being searched for
+  struct Query {
+    const unsigned char* pixels;
+    std::uint32_t pixel_sum;
+    const std::uint32_t* row_sums;
+    double norm;
+  };
+
+  // Rows whose sums a single-image query keeps on the stack
+  static constexpr int kQueryStackRows = 64;
+
+  Query MakeQuery(const PackedDataset& test_images, const std::size_t t) const;
+  Query MakeQuery(const unsigned char* image, std::uint32_t* row_sums) const;
+  void Search(const Query& query, TopK& neighbors,
+              KnnStatistics& statistics) const;
+  void Update(const TopK& neighbors, Thresholds& thresholds) const;
+  void Offer(const Query& query, const std::size_t idx, TopK& neighbors,
+             Thresholds& thresholds, KnnStatistics& statistics) const;
+
+  const PackedDataset& training_images_;
+  const MinkowskiKernel& kernel_;
+
+  // Position in order_ of a training index, found among its pixel sum's
+  // entries
+  std::size_t Position(const std::size_t idx) const;
+
+  // Training indexes sorted by pixel sum, and the sums in that order
+  std::vector<std::size_t> order_;
+  std::vector<std::uint32_t> sorted_sums_;
+
+  // L2 norm of every training image, unless the squared norms wrap
+  bool use_norms_ = true;
+  std::vector<double> norms_;
+};
+}
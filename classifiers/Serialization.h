@@ -0,0 +1,61 @@
+/** Interface file for the raw binary reading and writing of the model
+ *  structures (indexes, projections) to and from streams.  Values are
+ *  written in the machine's own byte order, and vectors as a 64-bit count
+ *  followed by their elements, so only trivially copyable element types
+ *  may be used.
+ *
+ *  \file statistics/classifiers/Serialization.h
+ *  \date 17 Oct 2026
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <type_traits>
+#include <vector>
+
+namespace statistics {
+
+/// Largest vector a reader accepts, so that a corrupt count fails the read
+/// instead of exhausting memory
+constexpr std::uint64_t kMaximumSerializedCount = std::uint64_t(1) << 36;
+
+template <typename T>
+void WriteValue(std::ostream& stream, const T& value) {
+  static_assert(std::is_trivially_copyable<T>::value,
+                "only trivially copyable values can be written");
+  stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+bool ReadValue(std::istream& stream, T& value) {
+  static_assert(std::is_trivially_copyable<T>::value,
+                "only trivially copyable values can be read");
+  stream.read(reinterpret_cast<char*>(&value), sizeof(T));
+  return static_cast<bool>(stream);
+}
+
+template <typename T>
+void WriteVector(std::ostream& stream, const std::vector<T>& values) {
+  static_assert(std::is_trivially_copyable<T>::value,
+                "only trivially copyable values can be written");
+  WriteValue(stream, static_cast<std::uint64_t>(values.size()));
+  stream.write(reinterpret_cast<const char*>(values.data()),
+               values.size() * sizeof(T));
+}
+
+template <typename T>
+bool ReadVector(std::istream& stream, std::vector<T>& values) {
+  static_assert(std::is_trivially_copyable<T>::value,
+                "only trivially copyable values can be read");
+  std::uint64_t count = 0;
+  if (!ReadValue(stream, count) || count > kMaximumSerializedCount) {
+    return false;
+  }
+  values.resize(count);
+  stream.read(reinterpret_cast<char*>(values.data()), count * sizeof(T));
+  return static_cast<bool>(stream);
+}
+}
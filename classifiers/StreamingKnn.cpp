@@ -0,0 +1,121 @@
+/** Implementation file for k-NN classification against a training set
+ *  streamed from disk one block at a time.
+ *
+ *  \file statistics/classifiers/StreamingKnn.cpp
+ *  \date 17 Oct 2026
+ */
+
+#include "imgs/statistics/classifiers/StreamingKnn.h"
+
+#include <algorithm>
+#include <future>
+#include <iostream>
+#include <memory>
+
+#include "imgs/statistics/classifiers/MinkowskiKernels.h"
+#include "imgs/statistics/classifiers/TiledSearch.h"
+#include "imgs/statistics/classifiers/TopK.h"
+#include "imgs/statistics/parallel/ThreadPool.h"
+
+namespace statistics {
+
+std::vector<unsigned char> StreamKnn(const PackedDataset& test_images,
+                                     IdxChunkReader& training_chunks,
+                                     const int k, const double p,
+                                     const KnnOptions& options) {
+  // Argument checking
+  if (training_chunks.empty()) {
+    std::cerr << "No training images to stream!" << std::endl;
+    return {};
+  }
+  if (test_images.rows() != training_chunks.rows() ||
+      test_images.cols() != training_chunks.cols()) {
+    std::cerr << "Test and training images differ in size!" << std::endl;
+    return {};
+  }
+  if (k < 1 || static_cast<std::size_t>(k) > training_chunks.size()) {
+    std::cerr << "k must be between 1 and the number of training images!"
+              << std::endl;
+    return {};
+  }
+  if (p < 1) {
+    std::cerr << "The Minkowski order p must be at least 1!" << std::endl;
+    return {};
+  }
+
+  const MinkowskiKernel kernel(p, test_images.rows(), test_images.cols());
+  const std::size_t number_tests = test_images.size();
+  std::vector<TopK> neighbors(number_tests, TopK(k));
+  std::vector<unsigned char> training_labels;
+  training_labels.reserve(training_chunks.size());
+
+  const unsigned int number_threads = (options.number_threads == 0)
+                                          ? ThreadPool::HardwareThreads()
+                                          : options.number_threads;
+  std::unique_ptr<ThreadPool> pool;
+  if (number_threads > 1) {
+    pool.reset(new ThreadPool(number_threads));
+  }
+  std::vector<KnnStatistics> worker_statistics(std::max(number_threads, 1u));
+
+  // Double buffering: while one block is searched, the next is read into
+  // the other on a second thread
+  PackedDataset chunks[2] = {training_chunks.MakeChunk(),
+                             training_chunks.MakeChunk()};
+  training_chunks.Rewind();
+  std::size_t number_chunk = training_chunks.ReadChunk(chunks[0]);
+  std::size_t base = 0;
+  for (int current = 0; number_chunk > 0; current = 1 - current) {
+    std::future<std::size_t> next =
+        std::async(std::launch::async, [&training_chunks, &chunks, current] {
+          return training_chunks.ReadChunk(chunks[1 - current]);
+        });
+
+    const PackedDataset& chunk = chunks[current];
+    training_labels.insert(training_labels.end(), chunk.labels(),
+                           chunk.labels() + number_chunk);
+    if (pool) {
+      pool->ParallelFor(
+          0, number_tests, kTileTestImages,
+          [&](std::size_t begin, std::size_t end, unsigned int worker) {
+            TiledNearest(test_images, begin, end, chunk, number_chunk, base,
+                         kernel, neighbors.data() + begin,
+                         worker_statistics[worker]);
+          });
+    } else {
+      for (std::size_t begin = 0; begin < number_tests;
+           begin += kTileTestImages) {
+        TiledNearest(test_images, begin,
+                     std::min(begin + kTileTestImages, number_tests), chunk,
+                     number_chunk, base, kernel, neighbors.data() + begin,
+                     worker_statistics[0]);
+      }
+    }
+
+    base += number_chunk;
+    number_chunk = next.get();
+  }
+  if (base != training_chunks.size()) {
+    std::cerr << "Only " << base << " of " << training_chunks.size()
+              << " training images could be streamed!" << std::endl;
+    return {};
+  }
+
+  // Majority vote of each test image's k nearest
+  std::vector<unsigned char> labels(number_tests);
+  for (std::size_t t = 0; t < number_tests; ++t) {
+    LabelHistogram label_counts;
+    for (const auto& neighbor : neighbors[t]) {
+      label_counts.Add(training_labels[neighbor.index]);
+    }
+    labels[t] = label_counts.MostCommon();
+  }
+
+  if (options.statistics != nullptr) {
+    for (const auto& statistics : worker_statistics) {
+      options.statistics->Add(statistics);
+    }
+  }
+  return labels;
+}
+}
@@ -0,0 +1,57 @@
+/** Interface file for k-NN classification against a training set streamed
+ *  from disk one block at a time.
+ *
+ *  A training set too large for memory is read block by block with an
+ *  IdxChunkReader.  Every test image keeps its k nearest so far (by the
+ *  same power sums and tie order as the in-memory search) from block to
+ *  block, so after the last block they are exactly the k nearest of the
+ *  whole training set and the classification is exactly that of Knn().
+ *  The blocks are double buffered: the next block is read on a second
+ *  thread while the current one is searched.
+ *
+ *  The memory held is two blocks of training images, the test images, the
+ *  k nearest of each test image, and one label byte per training image
+ *  (for the final vote), independent of the training set's pixels.
+ *
+ *  \file statistics/classifiers/StreamingKnn.h
+ *  \date 17 Oct 2026
+ */
+
+#pragma once
+
+#include <vector>
+
+#include "imgs/statistics/classifiers/Knn.h"
+#include "imgs/statistics/data_readers/IdxChunkReader.h"
+#include "imgs/statistics/data_readers/PackedDataset.h"
+
+namespace statistics {
+
+/** Perform k-NN classification against a streamed training set
+ *
+ *  \param[in]     test_images      packed data set containing the images to
+ *                                  be classified (labels, if any, are
+ *                                  ignored)
+ *  \param[in,out] training_chunks  reader of the training image and label
+ *                                  files, which is rewound and read to the
+ *                                  end
+ *  \param[in]     k                the number of neighbors to be considered
+ *                                  in the majority vote for class
+ *                                  assignment
+ *  \param[in]     p                the order to use in the computation of
+ *                                  the Lp-norm (Minkowski distance)
+ *                                  [default is 2]
+ *  \param[in]     options          execution options; only the threads
+ *                                  (which split each block's search across
+ *                                  the test images) and the statistics
+ *                                  apply [default is serial]
+ *  \return                         vector containing the enumerated labels
+ *                                  for each of the classified test images
+ *                                  (empty, with a message, if the training
+ *                                  files could not be streamed)
+ */
+std::vector<unsigned char> StreamKnn(const PackedDataset& test_images,
+                                     IdxChunkReader& training_chunks,
+                                     const int k, const double p = 2,
+                                     const KnnOptions& options = KnnOptions());
+}
@@ -0,0 +1,49 @@
+/** Implementation file for the cache-tiled exact nearest-neighbor search.
+ *
+ *  \file statistics/classifiers/TiledSearch.cpp
+ *  \date 17 Oct 2026
+ */
+
+#include "imgs/statistics/classifiers/TiledSearch.h"
+
+#include <algorithm>
+
+namespace statistics {
+
+void TiledNearest(const PackedDataset& test_images, const std::size_t begin,
+                  const std::size_t end, const PackedDataset& training_images,
+                  const std::size_t number_training, const std::size_t base,
+                  const MinkowskiKernel& kernel, TopK* neighbors,
+                  KnnStatistics& statistics) {
+  const std::size_t number_pixels = training_images.dimension();
+  const std::size_t tile_size = std::max<std::size_t>(
+      kTileTrainingBytes / std::max<std::size_t>(training_images.stride(), 1),
+      1);
+  const bool abandon = !kernel.is_vectorized();
+
+  for (std::size_t tile_begin = 0; tile_begin < number_training;
+       tile_begin += tile_size) {
+    const std::size_t tile_end =
+        std::min(tile_begin + tile_size, number_training);
+    for (std::size_t t = begin; t < end; ++t) {
+      const unsigned char* test_ptr = test_images.ptr(t);
+      TopK& selection = neighbors[t - begin];
+      for (std::size_t i = tile_begin; i < tile_end; ++i) {
+        const double bound = selection.Bound();
+        const double power_sum =
+            abandon ? kernel.PowerSumBounded(test_ptr, training_images.ptr(i),
+                                             number_pixels, bound)
+                    : kernel.PowerSum(test_ptr, training_images.ptr(i),
+                                      number_pixels);
+        if (abandon && power_sum > bound) {
+          ++statistics.abandoned;
+          continue;
+        }
+        ++statistics.completed;
+        selection.Push(power_sum, base + i);
+      }
+    }
+  }
+  statistics.candidates += (end - begin) * number_training;
+}
+}
@@ -0,0 +1,157 @@
+/** Interface file for the bounded nearest-neighbor selection used by the
+ *  packed k-NN classifier.  TopK keeps only the k nearest candidates seen
+ *  so far in a small sorted buffer that is allocated once and reused for
+ *  every test image, so a query needs O(k) memory and no heap allocation,
+ *  and LabelHistogram replaces the per-query std::map of the majority vote
+ *  with a flat array of counts.
+ *
+ *  \file statistics/classifiers/TopK.h
+ *  \date 17 Oct 2026
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+namespace statistics {
+
+/** A training image and its distance to the current test image (for the
+ *  packed classifier, the power sum sum(|a - b|^p), which ranks exactly
+ *  like the distance)
+ */
+struct Neighbor {
+  double distance;
+  std::size_t index;
+};
+
+/** Strict total order on neighbors: nearest first, with the lower training
+ *  index breaking distance ties, so that every execution mode selects the
+ *  same k neighbors
+ */
+inline bool NearerThan(const Neighbor& a, const Neighbor& b) {
+  return a.distance < b.distance ||
+         (a.distance == b.distance && a.index < b.index);
+}
+
+class TopK {
+ public:
+  /** Construct an empty selection of (at most) k neighbors
+   *
+   *  \param[in] k  number of neighbors to keep [default is 1]
+   */
+  explicit TopK(const int k = 1) { Reset(k); }
+
+  /** Empty the selection and set the number of neighbors to keep; the
+   *  buffer is only reallocated when k grows
+   */
+  void Reset(const int k) {
+    k_ = static_cast<std::size_t>(k);
+    if (neighbors_.size() < k_) {
+      neighbors_.resize(k_);
+    }
+    size_ = 0;
+  }
+
+  /** Empty the selection, keeping k
+   */
+  void Clear() { size_ = 0; }
+
+  std::size_t k() const { return k_; }
+  std::size_t size() const { return size_; }
+  bool full() const { return size_ == k_; }
+
+  /// The k-th smallest distance so far (infinity until k are held); any
+  /// candidate farther than this can be rejected
+  double Bound() const {
+    return full() ? neighbors_[k_ - 1].distance
+                  : std::numeric_limits<double>::infinity();
+  }
+
+  /** Offer a candidate; it is kept if it is among the k nearest so far
+   *
+   *  \param[in] distance  distance (or power sum) to the candidate
+   *  \param[in] index     training index of the candidate
+   *  \return              whether the candidate was kept
+   */
+  bool Push(const double distance, const std::size_t index) {
+    const Neighbor candidate{distance, index};
+    if (full() && !NearerThan(candidate, neighbors_[k_ - 1])) {
+      return false;
+    }
+
+    // Insertion into the sorted buffer, shifting farther neighbors back
+    std::size_t position = full() ? k_ - 1 : size_++;
+    while (position > 0 && NearerThan(candidate, neighbors_[position - 1])) {
+      neighbors_[position] = neighbors_[position - 1];
+      --position;
+    }
+    neighbors_[position] = candidate;
+    return true;
+  }
+
+  /** Offer every neighbor of another selection (e.g. of a training shard)
+   */
+  void Merge(const TopK& other) {
+    for (const auto& neighbor : other) {
+      Push(neighbor.distance, neighbor.index);
+    }
+  }
+
+  /// The neighbors held, nearest first
+  const Neighbor* begin() const { return neighbors_.data(); }
+  const Neighbor* end() const { return neighbors_.data() + size_; }
+  const Neighbor& operator[](const std::size_t idx) const {
+    return neighbors_[idx];
+  }
+
+ private:
+  std::size_t k_ = 0;
+  std::size_t size_ = 0;
+  std::vector<Neighbor> neighbors_;
+};
+
+/** Flat histogram of 8-bit label enumerations for the majority vote
+ */
+class LabelHistogram {
+ public:
+  /** Count one vote
+   */
+  void Add(const unsigned char label) { ++counts_[label]; }
+
+  /** The most common label, ties going to the smallest label (the same
+   *  choice as iterating a std::map of counts in key order)
+   */
+  unsigned char MostCommon() const {
+    unsigned char most_common_label = 0;
+    int max_count = 0;
+    for (std::size_t label = 0; label < counts_.size(); ++label) {
+      if (counts_[label] > max_count) {
+        max_count = counts_[label];
+        most_common_label = static_cast<unsigned char>(label);
+      }
+    }
+    return most_common_label;
+  }
+
+ private:
+  std::array<int, 256> counts_{};
+};
+
+/** Majority vote of a selection's labels (ties go to the smallest label)
+ *
+ *  \param[in] neighbors        the k nearest neighbors
+ *  \param[in] training_images  the labeled data set (anything with
+ *                              label(index)) the neighbors index into
+ */
+template <typename Dataset>
+unsigned char Vote(const TopK& neighbors, const Dataset& training_images) {
+  LabelHistogram label_counts;
+  for (const auto& neighbor : neighbors) {
+    label_counts.Add(training_images.label(neighbor.index));
+  }
+  return label_counts.MostCommon();
+}
+}
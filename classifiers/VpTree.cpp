@@ -0,0 +1,207 @@
+/** Implementation file for the exact metric index over a packed training set.
+ *
+ *  \file statistics/classifiers/VpTree.cpp
+ *  \date 17 Oct 2026
+ */
+
+#include "imgs/statistics/classifiers/VpTree.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "imgs/statistics/classifiers/Serialization.h"
+
+namespace statistics {
+
+namespace {
+
+// Slack on the search radius, so that rounding in the floating point
+// distances can never exclude a training image at (or tied with) the k-th
+// nearest distance
+constexpr double kRelativeSlack = 1e-9;
+constexpr double kAbsoluteSlack = 1e-6;
+
+// Deterministic choice of vantage images (a small linear congruential
+// generator, so that the same training set always gives the same tree)
+std::size_t NextRandom(std::uint32_t& random, const std::size_t range) {
+  random = random * 1664525u + 1013904223u;
+  return static_cast<std::size_t>(random >> 8) % range;
+}
+
+}  // namespace
+
+VpTree::VpTree(const PackedDataset& training_images, const double p)
+    : training_images_(training_images),
+      kernel_(p, training_images.rows(), training_images.cols()) {
+  items_.resize(training_images.size());
+  for (std::size_t i = 0; i < items_.size(); ++i) {
+    items_[i] = i;
+  }
+  nodes_.reserve(2 * items_.size() / kVpTreeLeafSize + 1);
+
+  std::vector<Neighbor> distances;
+  std::uint32_t random = 0x9e3779b9u;
+  if (!items_.empty()) {
+    Build(0, items_.size(), distances, random);
+  }
+}
+
+std::int32_t VpTree::Build(const std::size_t begin, const std::size_t end,
+                           std::vector<Neighbor>& distances,
+                           std::uint32_t& random) {
+  const std::int32_t node = static_cast<std::int32_t>(nodes_.size());
+  nodes_.push_back(Node{begin, end, 0, -1, -1});
+  if (end - begin <= kVpTreeLeafSize) {
+    return node;
+  }
+
+  // Vantage image first, then the rest split at the median distance to it
+  std::swap(items_[begin], items_[begin + NextRandom(random, end - begin)]);
+  const unsigned char* vantage = training_images_.ptr(items_[begin]);
+  const std::size_t number_pixels = training_images_.dimension();
+
+  distances.resize(end - begin - 1);
+  for (std::size_t i = begin + 1; i < end; ++i) {
+    distances[i - begin - 1] = Neighbor{
+        kernel_.PowerSum(vantage, training_images_.ptr(items_[i]),
+                         number_pixels),
+        items_[i]};
+  }
+  const std::size_t half = distances.size() / 2;
+  std::nth_element(distances.begin(), distances.begin() + half,
+                   distances.end(), NearerThan);
+  for (std::size_t i = 0; i < distances.size(); ++i) {
+    items_[begin + 1 + i] = distances[i].index;
+  }
+
+  const std::size_t middle = begin + 1 + half;
+  const double radius = kernel_.DistanceFromPowerSum(distances[half].distance);
+
+  // (distances is free for reuse: the split is recorded in items_)
+  const std::int32_t inside = Build(begin + 1, middle, distances, random);
+  const std::int32_t outside = Build(middle, end, distances, random);
+  nodes_[node].radius = radius;
+  nodes_[node].inside = inside;
+  nodes_[node].outside = outside;
+  return node;
+}
+
+std::size_t VpTree::MemoryBytes() const {
+  return items_.capacity() * sizeof(std::size_t) +
+         nodes_.capacity() * sizeof(Node);
+}
+
+void VpTree::Save(std::ostream& stream) const {
+  WriteValue(stream, order());
+  WriteVector(stream, items_);
+  WriteVector(stream, nodes_);
+}
+
+bool VpTree::Load(std::istream& stream,
+                  const PackedDataset& training_images) {
+  *this = VpTree();
+  double p = 2;
+  std::vector<std::size_t> items;
+  std::vector<Node> nodes;
+  if (!ReadValue(stream, p) || !ReadVector(stream, items) ||
+      !ReadVector(stream, nodes) || items.size() != training_images.size()) {
+    return false;
+  }
+  for (const auto item : items) {
+    if (item >= training_images.size()) {
+      return false;
+    }
+  }
+  // Children are built after their parent, so a child must be a later node
+  // (which also rules out cycles); a leaf has no children, an inner node two
+  // and a vantage image
+  const auto is_child = [&](const std::int32_t child,
+                            const std::size_t parent) {
+    return child >= 0 && static_cast<std::size_t>(child) > parent &&
+           static_cast<std::size_t>(child) < nodes.size();
+  };
+  for (std::size_t n = 0; n < nodes.size(); ++n) {
+    const Node& node = nodes[n];
+    if (node.begin > node.end || node.end > items.size()) {
+      return false;
+    }
+    const bool leaf = (node.inside == -1 && node.outside == -1);
+    if (!leaf && (!is_child(node.inside, n) || !is_child(node.outside, n) ||
+                  node.begin == node.end)) {
+      return false;
+    }
+  }
+
+  training_images_ = training_images;
+  kernel_ = MinkowskiKernel(p, training_images.rows(), training_images.cols());
+  items_ = std::move(items);
+  nodes_ = std::move(nodes);
+  return true;
+}
+
+double VpTree::Reach(const TopK& neighbors) const {
+  return kernel_.DistanceFromPowerSum(neighbors.Bound()) *
+             (1 + kRelativeSlack) +
+         kAbsoluteSlack;
+}
+
+void VpTree::Offer(const unsigned char* image, const std::size_t item,
+                   TopK& neighbors, KnnStatistics& statistics) const {
+  const double bound = neighbors.Bound();
+  const double power_sum = kernel_.PowerSumBounded(
+      image, training_images_.ptr(item), training_images_.dimension(), bound);
+  if (power_sum > bound) {
+    ++statistics.abandoned;
+    return;
+  }
+  neighbors.Push(power_sum, item);
+  ++statistics.completed;
+}
+
+void VpTree::Search(const std::int32_t node_index, const unsigned char* image,
+                    TopK& neighbors, KnnStatistics& statistics) const {
+  const Node& node = nodes_[node_index];
+  if (node.inside < 0) {
+    for (std::size_t i = node.begin; i < node.end; ++i) {
+      Offer(image, items_[i], neighbors, statistics);
+    }
+    return;
+  }
+
+  // The vantage image's exact distance steers the rest of the search
+  const std::size_t vantage = items_[node.begin];
+  const double power_sum = kernel_.PowerSum(
+      image, training_images_.ptr(vantage), training_images_.dimension());
+  neighbors.Push(power_sum, vantage);
+  ++statistics.completed;
+  const double distance = kernel_.DistanceFromPowerSum(power_sum);
+
+  // Nearer side first, so the reach has shrunk before the farther side
+  if (distance < node.radius) {
+    if (distance - Reach(neighbors) <= node.radius) {
+      Search(node.inside, image, neighbors, statistics);
+    }
+    if (distance + Reach(neighbors) >= node.radius) {
+      Search(node.outside, image, neighbors, statistics);
+    }
+  } else {
+    if (distance + Reach(neighbors) >= node.radius) {
+      Search(node.outside, image, neighbors, statistics);
+    }
+    if (distance - Reach(neighbors) <= node.radius) {
+      Search(node.inside, image, neighbors, statistics);
+    }
+  }
+}
+
+void VpTree::Nearest(const unsigned char* image, TopK& neighbors,
+                     KnnStatistics& statistics) const {
+  const std::size_t compared = statistics.completed + statistics.abandoned;
+  statistics.candidates += items_.size();
+  if (!nodes_.empty()) {
+    Search(0, image, neighbors, statistics);
+  }
+  statistics.skipped += items_.size() -
+                        (statistics.completed + statistics.abandoned - compared);
+}
+}
@@ -0,0 +1,111 @@
+/** Interface file for an exact metric index over a packed training set.
+ *  A vantage point tree splits the training images recursively by their
+ *  Minkowski distance to a chosen vantage image: those within the median
+ *  distance mu go inside, the rest outside.  Since every Lp distance with
+ *  p >= 1 obeys the triangle inequality, a query at distance d from the
+ *  vantage image only needs the inside subtree if d - tau <= mu and the
+ *  outside subtree if d + tau >= mu, where tau is its current k-th nearest
+ *  distance, so most of the training set is never compared against.
+ *
+ *  The neighbors found are exactly those of the linear scan, including the
+ *  lower-index tie breaking, so the classification is unchanged.
+ *
+ *  \file statistics/classifiers/VpTree.h
+ *  \date 17 Oct 2026
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <vector>
+
+#include "imgs/statistics/classifiers/MinkowskiKernels.h"
+#include "imgs/statistics/classifiers/PrunedSearch.h"
+#include "imgs/statistics/classifiers/TopK.h"
+#include "imgs/statistics/data_readers/PackedDataset.h"
+
+namespace statistics {
+
+/// Largest subset of training images stored as a leaf and scanned linearly
+constexpr std::size_t kVpTreeLeafSize = 16;
+
+class VpTree {
+ public:
+  /** Construct an empty index
+   */
+  VpTree() = default;
+
+  /** Build the index over a training set
+   *
+   *  \param[in] training_images  packed training images (and labels); the
+   *                              pixels are shared with, not copied from,
+   *                              the data set
+   *  \param[in] p                the order of the Minkowski distance the
+   *                              index is built for (at least 1)
+   *                              [default is 2]
+   */
+  explicit VpTree(const PackedDataset& training_images, const double p = 2);
+
+  const PackedDataset& training_images() const { return training_images_; }
+  double order() const { return kernel_.order(); }
+  std::size_t size() const { return items_.size(); }
+  bool empty() const { return items_.empty(); }
+
+  /// Bytes held by the index itself (not counting the shared pixels)
+  std::size_t MemoryBytes() const;
+
+  /** Write the index (not the training images) to a binary stream
+   */
+  void Save(std::ostream& stream) const;
+
+  /** Replace the index with one written by Save()
+   *
+   *  \param[in] stream           binary stream positioned at the index
+   *  \param[in] training_images  the training images the index was built
+   *                              over
+   *  \return                     whether a consistent index was read (the
+   *                              index is left empty otherwise)
+   */
+  bool Load(std::istream& stream, const PackedDataset& training_images);
+
+  /** Offer the training images that can be among the k nearest of an image
+   *  to its selection (power sums, as in the linear scan)
+   *
+   *  \param[in]     image       the image to search for
+   *  \param[in,out] neighbors   the k nearest so far
+   *  \param[in,out] statistics  counts to add this search's to (skipped
+   *                             are the training images never compared)
+   */
+  void Nearest(const unsigned char* image, TopK& neighbors,
+               KnnStatistics& statistics) const;
+
+ private:
+  // Images [begin, end) of items_; a leaf when inside < 0, otherwise
+  // items_[begin] is the vantage image and the inside (outside) subtree
+  // holds the rest of the images within (beyond) radius of it
+  struct Node {
+    std::size_t begin;
+    std::size_t end;
+    double radius;
+    std::int32_t inside;
+    std::int32_t outside;
+  };
+
+  std::int32_t Build(const std::size_t begin, const std::size_t end,
+                     std::vector<Neighbor>& distances,
+                     std::uint32_t& random);
+  void Search(const std::int32_t node, const unsigned char* image,
+              TopK& neighbors, KnnStatistics& statistics) const;
+  void Offer(const unsigned char* image, const std::size_t item,
+             TopK& neighbors, KnnStatistics& statistics) const;
+  double Reach(const TopK& neighbors) const;
+
+  PackedDataset training_images_;
+  MinkowskiKernel kernel_{2};
+  std::vector<std::size_t> items_;
+  std::vector<Node> nodes_;
+};
+}
@@ -0,0 +1,70 @@
+/** Implementation file for a bit-packed binary image data set.
+ *
+ *  \file statistics/data_readers/BinaryDataset.cpp
+ *  \date 17 Oct 2026
+ */
+
+#include "imgs/statistics/data_readers/BinaryDataset.h"
+
+namespace statistics {
+
+namespace {
+
+// Bits per storage word
+constexpr std::size_t kWordBits = 64;
+
+}  // namespace
+
+BinaryDataset::BinaryDataset(const std::size_t number_images,
+                             const int number_rows, const int number_cols)
+    : number_images_(number_images),
+      number_rows_(number_rows),
+      number_cols_(number_cols) {
+  words_ = (dimension() + kWordBits - 1) / kWordBits;
+  bits_.assign(number_images_ * words_, 0);
+  labels_.assign(number_images_, 0);
+}
+
+std::vector<unsigned char> BinaryDataset::LabelVector() const {
+  if (!has_labels_) {
+    return {};
+  }
+  return labels_;
+}
+
+bool IsBinary(const PackedDataset& images) {
+  const std::size_t dimension = images.dimension();
+  for (std::size_t idx = 0; idx < images.size(); ++idx) {
+    const unsigned char* pixels = images.ptr(idx);
+    for (std::size_t d = 0; d < dimension; ++d) {
+      if (pixels[d] != 0 && pixels[d] != 255) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+BinaryDataset PackBinary(const PackedDataset& images,
+                         const unsigned char threshold) {
+  BinaryDataset binary(images.size(), images.rows(), images.cols());
+  const std::size_t dimension = images.dimension();
+  for (std::size_t idx = 0; idx < images.size(); ++idx) {
+    const unsigned char* pixels = images.ptr(idx);
+    std::uint64_t* bits = binary.ptr(idx);
+    for (std::size_t d = 0; d < dimension; ++d) {
+      if (pixels[d] >= threshold) {
+        bits[d / kWordBits] |= std::uint64_t{1} << (d % kWordBits);
+      }
+    }
+  }
+
+  if (images.has_labels()) {
+    for (std::size_t idx = 0; idx < images.size(); ++idx) {
+      binary.labels()[idx] = images.label(idx);
+    }
+    binary.set_has_labels(true);
+  }
+  return binary;
+}
+}
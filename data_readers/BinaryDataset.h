@@ -0,0 +1,102 @@
+/** Interface file for a bit-packed binary image data set.  Thresholded
+ *  characters (such as the 0/255 output of AutoExtractCharacters) carry one
+ *  bit of information per pixel, so each image is stored as a row of
+ *  uint64 words, one bit per pixel (13 words for a 28 x 28 character: 8x
+ *  smaller than the packed 8-bit row and 64x smaller than a row of
+ *  doubles).  For two binary images every Minkowski distance is a fixed
+ *  power of the Hamming distance, so they rank neighbors identically and
+ *  the Hamming distance can be computed with a popcount per word.
+ *
+ *  \file statistics/data_readers/BinaryDataset.h
+ *  \date 17 Oct 2026
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "imgs/statistics/data_readers/PackedDataset.h"
+
+namespace statistics {
+
+/// Pixels at or above this value are set bits
+constexpr unsigned char kBinaryThreshold = 128;
+
+class BinaryDataset {
+ public:
+  /** Construct an empty data set
+   */
+  BinaryDataset() = default;
+
+  /** Allocate a data set of all-zero images (and labels)
+   *
+   *  \param[in] number_images  number of images in the data set
+   *  \param[in] number_rows    number of rows in each image
+   *  \param[in] number_cols    number of columns in each image
+   */
+  BinaryDataset(const std::size_t number_images, const int number_rows,
+                const int number_cols);
+
+  std::size_t size() const { return number_images_; }
+  bool empty() const { return number_images_ == 0; }
+  int rows() const { return number_rows_; }
+  int cols() const { return number_cols_; }
+
+  /// Number of pixels (bits) in each image
+  std::size_t dimension() const {
+    return static_cast<std::size_t>(number_rows_) * number_cols_;
+  }
+
+  /// Number of uint64 words per image (the unused high bits are zero)
+  std::size_t words() const { return words_; }
+
+  std::uint64_t* ptr(const std::size_t idx) {
+    return bits_.data() + idx * words_;
+  }
+  const std::uint64_t* ptr(const std::size_t idx) const {
+    return bits_.data() + idx * words_;
+  }
+
+  bool has_labels() const { return has_labels_; }
+  unsigned char* labels() { return labels_.data(); }
+  const unsigned char* labels() const { return labels_.data(); }
+  unsigned char label(const std::size_t idx) const { return labels_[idx]; }
+  void set_has_labels(const bool has_labels) { has_labels_ = has_labels; }
+
+  /** Copy the labels into a std::vector (e.g. for ConfusionMatrix)
+   */
+  std::vector<unsigned char> LabelVector() const;
+
+  /// Bytes held by the bits and labels
+  std::size_t MemoryBytes() const {
+    return bits_.size() * sizeof(std::uint64_t) + labels_.size();
+  }
+
+ private:
+  std::size_t number_images_ = 0;
+  int number_rows_ = 0;
+  int number_cols_ = 0;
+  std::size_t words_ = 0;
+  std::vector<std::uint64_t> bits_;
+  std::vector<unsigned char> labels_;
+  bool has_labels_ = false;
+};
+
+/** Whether every pixel of a packed data set is 0 or 255, i.e. whether the
+ *  binary representation loses nothing
+ */
+bool IsBinary(const PackedDataset& images);
+
+/** Pack (and threshold) the images of a packed data set one bit per pixel,
+ *  keeping their labels
+ *
+ *  \param[in] images     packed data set
+ *  \param[in] threshold  pixels at or above it become set bits [default is
+ *                        kBinaryThreshold]
+ *  \return               the bit-packed data set
+ */
+BinaryDataset PackBinary(const PackedDataset& images,
+                         const unsigned char threshold = kBinaryThreshold);
+}
@@ -0,0 +1,324 @@
+/** Implementation file for a chunked, run-length compressed container of
+ *  IDX (MNIST-format) data.
+ *
+ *  \file statistics/data_readers/CompressedIdxFile.cpp
+ *  \date 17 Oct 2026
+ */
+
+#include "imgs/statistics/data_readers/CompressedIdxFile.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#include "imgs/statistics/parallel/ThreadPool.h"
+
+namespace statistics {
+
+namespace {
+
+// Magic number of the container ("IDXR"), and the IDX data type code of
+// unsigned bytes
+constexpr std::uint32_t kContainerMagic = 0x49445852;
+constexpr std::uint32_t kUnsignedByteType = 0x08;
+
+// Longest literal and repeated runs one control byte describes, and the
+// shortest run worth repeating
+constexpr std::size_t kMaximumLiteral = 128;
+constexpr std::size_t kMaximumRepeat = 130;
+constexpr std::size_t kMinimumRepeat = 3;
+
+// Big-endian header fields
+void AppendField(std::vector<unsigned char>& bytes, const std::uint32_t value) {
+  for (int shift = 24; shift >= 0; shift -= 8) {
+    bytes.push_back(static_cast<unsigned char>(value >> shift));
+  }
+}
+
+void AppendField64(std::vector<unsigned char>& bytes,
+                   const std::uint64_t value) {
+  AppendField(bytes, static_cast<std::uint32_t>(value >> 32));
+  AppendField(bytes, static_cast<std::uint32_t>(value));
+}
+
+std::uint32_t Field(const unsigned char* bytes) {
+  return (std::uint32_t(bytes[0]) << 24) | (std::uint32_t(bytes[1]) << 16) |
+         (std::uint32_t(bytes[2]) << 8) | std::uint32_t(bytes[3]);
+}
+
+std::uint64_t Field64(const unsigned char* bytes) {
+  return (std::uint64_t(Field(bytes)) << 32) | Field(bytes + 4);
+}
+
+// Append the run-length code of count bytes
+void Encode(const unsigned char* input, const std::size_t count,
+            std::vector<unsigned char>& output) {
+  std::size_t literal_begin = 0;
+  std::size_t position = 0;
+  auto flush_literals = [&](const std::size_t end) {
+    while (literal_begin < end) {
+      const std::size_t length =
+          std::min(end - literal_begin, kMaximumLiteral);
+      output.push_back(static_cast<unsigned char>(length - 1));
+      output.insert(output.end(), input + literal_begin,
+                    input + literal_begin + length);
+      literal_begin += length;
+    }
+  };
+
+  while (position < count) {
+    std::size_t run = 1;
+    while (position + run < count && run < kMaximumRepeat &&
+           input[position + run] == input[position]) {
+      ++run;
+    }
+    if (run >= kMinimumRepeat) {
+      flush_literals(position);
+      output.push_back(static_cast<unsigned char>(run + 125));
+      output.push_back(input[position]);
+      position += run;
+      literal_begin = position;
+    } else {
+      position += run;
+    }
+  }
+  flush_literals(count);
+}
+
+// Decode a run-length code that must fill exactly count bytes
+bool DecodeRuns(const unsigned char* input, const std::size_t input_bytes,
+                unsigned char* output, const std::size_t count) {
+  const unsigned char* end = input + input_bytes;
+  std::size_t position = 0;
+  while (input < end) {
+    const unsigned char control = *input++;
+    if (control < 128) {
+      const std::size_t length = control + 1u;
+      if (length > static_cast<std::size_t>(end - input) ||
+          length > count - position) {
+        return false;
+      }
+      std::memcpy(output + position, input, length);
+      input += length;
+      position += length;
+    } else {
+      const std::size_t length = control - 125u;
+      if (input == end || length > count - position) {
+        return false;
+      }
+      std::memset(output + position, *input++, length);
+      position += length;
+    }
+  }
+  return position == count;
+}
+
+}  // namespace
+
+CompressedIdxFile::CompressedIdxFile(const std::string filename,
+                                     const int number_dimensions) {
+  std::ifstream file(filename, std::ios::binary);
+  if (!file.is_open()) {
+    std::cerr << "Unable to open compressed IDX file: " << filename
+              << std::endl;
+    return;
+  }
+  file.seekg(0, std::ios::end);
+  const std::size_t length = static_cast<std::size_t>(file.tellg());
+  file.seekg(0, std::ios::beg);
+  auto bytes = std::make_shared<std::vector<unsigned char>>(length);
+  file.read(reinterpret_cast<char*>(bytes->data()), length);
+  if (!file) {
+    std::cerr << "Error reading compressed IDX file: " << filename
+              << std::endl;
+    return;
+  }
+  const unsigned char* data = bytes->data();
+
+  // Container magic, IDX magic, dimensions and chunk length
+  const std::size_t header_bytes = 4 * (3 + number_dimensions);
+  if (number_dimensions < 1 || number_dimensions > 3 ||
+      length < header_bytes || Field(data) != kContainerMagic ||
+      Field(data + 4) != ((kUnsignedByteType << 8) | number_dimensions) ||
+      Field(data + header_bytes - 4) == 0) {
+    std::cerr << "Not a compressed IDX file of unsigned bytes in "
+              << number_dimensions << " dimension(s): " << filename
+              << std::endl;
+    return;
+  }
+  std::uint32_t dimensions[3] = {0, 1, 1};
+  for (int d = 0; d < number_dimensions; ++d) {
+    dimensions[d] = Field(data + 8 + 4 * d);
+  }
+  const std::size_t chunk_items = Field(data + header_bytes - 4);
+  const std::size_t number_chunks =
+      (dimensions[0] + chunk_items - 1) / chunk_items;
+
+  // The chunk table: nondecreasing end offsets, the last at the file's end
+  const std::size_t data_offset = header_bytes + 8 * number_chunks;
+  bool valid = dimensions[1] <= INT32_MAX && dimensions[2] <= INT32_MAX &&
+               data_offset <= length;
+  std::vector<std::uint64_t> chunk_ends(valid ? number_chunks : 0);
+  for (std::size_t c = 0; valid && c < number_chunks; ++c) {
+    chunk_ends[c] = Field64(data + header_bytes + 8 * c);
+    valid = chunk_ends[c] <= length - data_offset &&
+            (c == 0 || chunk_ends[c] >= chunk_ends[c - 1]);
+  }
+  const std::size_t data_bytes =
+      (valid && number_chunks > 0) ? chunk_ends.back() : 0;
+  if (!valid || data_bytes != length - data_offset) {
+    std::cerr << "Compressed IDX file is corrupt: " << filename << std::endl;
+    return;
+  }
+
+  bytes_ = std::move(bytes);
+  data_offset_ = data_offset;
+  chunk_ends_ = std::move(chunk_ends);
+  number_items_ = dimensions[0];
+  number_rows_ = static_cast<int>(dimensions[1]);
+  number_cols_ = static_cast<int>(dimensions[2]);
+  chunk_items_ = chunk_items;
+}
+
+std::size_t CompressedIdxFile::DecodeChunk(const std::size_t chunk,
+                                           unsigned char* items) const {
+  if (chunk >= number_chunks()) {
+    return 0;
+  }
+  const std::size_t begin = (chunk == 0) ? 0 : chunk_ends_[chunk - 1];
+  const std::size_t count =
+      std::min(chunk_items_, number_items_ - chunk * chunk_items_);
+  if (!DecodeRuns(bytes_->data() + data_offset_ + begin,
+                  chunk_ends_[chunk] - begin, items, count * item_bytes())) {
+    std::cerr << "Compressed IDX chunk " << chunk << " is corrupt!"
+              << std::endl;
+    return 0;
+  }
+  return count;
+}
+
+bool CompressedIdxFile::Decode(unsigned char* items, const std::size_t stride,
+                               const unsigned int number_threads) const {
+  const std::size_t dimension = item_bytes();
+  std::atomic<bool> decoded(true);
+  ThreadPool pool(std::min<std::size_t>(
+      (number_threads == 0) ? ThreadPool::HardwareThreads() : number_threads,
+      std::max<std::size_t>(number_chunks(), 1)));
+  std::vector<std::vector<unsigned char>> scratch(pool.size());
+  pool.ParallelFor(
+      0, number_chunks(), 1,
+      [&](std::size_t begin, std::size_t end, unsigned int worker) {
+        for (std::size_t c = begin; c < end; ++c) {
+          unsigned char* first = items + c * chunk_items_ * stride;
+
+          // Contiguous items decode in place; padded ones are spread out
+          // from a chunk decoded back to back
+          if (stride == dimension) {
+            if (DecodeChunk(c, first) == 0) {
+              decoded = false;
+            }
+            continue;
+          }
+          scratch[worker].resize(chunk_items_ * dimension);
+          const std::size_t count = DecodeChunk(c, scratch[worker].data());
+          if (count == 0) {
+            decoded = false;
+          }
+          for (std::size_t i = 0; i < count; ++i) {
+            std::memcpy(first + i * stride,
+                        scratch[worker].data() + i * dimension, dimension);
+          }
+        }
+      });
+  return decoded;
+}
+
+bool IsCompressedIdxFile(const std::string filename) {
+  std::ifstream file(filename, std::ios::binary);
+  unsigned char magic[4] = {0, 0, 0, 0};
+  file.read(reinterpret_cast<char*>(magic), sizeof(magic));
+  return file && Field(magic) == kContainerMagic;
+}
+
+bool WriteCompressedIdxFile(const std::string filename,
+                            const unsigned char* items,
+                            const std::size_t number_items,
+                            const int number_rows, const int number_cols,
+                            const std::size_t stride,
+                            const int number_dimensions,
+                            const std::size_t chunk_items) {
+  if (chunk_items == 0 || number_dimensions < 1 || number_dimensions > 3) {
+    std::cerr << "Compressed IDX files need 1 to 3 dimensions and at least "
+              << "one item per chunk!" << std::endl;
+    return false;
+  }
+
+  // Header
+  std::vector<unsigned char> header;
+  AppendField(header, kContainerMagic);
+  AppendField(header, (kUnsignedByteType << 8) | number_dimensions);
+  const std::uint32_t dimensions[3] = {
+      static_cast<std::uint32_t>(number_items),
+      static_cast<std::uint32_t>(number_rows),
+      static_cast<std::uint32_t>(number_cols)};
+  for (int d = 0; d < number_dimensions; ++d) {
+    AppendField(header, dimensions[d]);
+  }
+  AppendField(header, static_cast<std::uint32_t>(chunk_items));
+
+  // Every chunk compressed on its own, with its end offset in the table
+  const std::size_t dimension =
+      static_cast<std::size_t>(number_rows) * number_cols;
+  std::vector<unsigned char> data;
+  std::vector<unsigned char> table;
+  std::vector<unsigned char> chunk;
+  for (std::size_t first = 0; first < number_items; first += chunk_items) {
+    const std::size_t count = std::min(chunk_items, number_items - first);
+    chunk.resize(count * dimension);
+    for (std::size_t i = 0; i < count; ++i) {
+      std::memcpy(chunk.data() + i * dimension, items + (first + i) * stride,
+                  dimension);
+    }
+    Encode(chunk.data(), chunk.size(), data);
+    AppendField64(table, data.size());
+  }
+
+  std::ofstream file(filename, std::ios::binary);
+  if (!file.is_open()) {
+    std::cerr << "Unable to open compressed IDX file for writing: "
+              << filename << std::endl;
+    return false;
+  }
+  file.write(reinterpret_cast<const char*>(header.data()), header.size());
+  file.write(reinterpret_cast<const char*>(table.data()), table.size());
+  file.write(reinterpret_cast<const char*>(data.data()), data.size());
+  if (!file) {
+    std::cerr << "Error writing compressed IDX file: " << filename
+              << std::endl;
+    return false;
+  }
+  return true;
+}
+
+bool WriteCompressedMnistDataset(const std::string images_filename,
+                                 const std::string labels_filename,
+                                 const PackedDataset& dataset,
+                                 const std::size_t chunk_images) {
+  if (!WriteCompressedIdxFile(images_filename, dataset.ptr(0), dataset.size(),
+                              dataset.rows(), dataset.cols(),
+                              dataset.stride(), 3, chunk_images)) {
+    return false;
+  }
+  if (labels_filename.empty()) {
+    return true;
+  }
+  if (!dataset.has_labels()) {
+    std::cerr << "The data set has no labels to write!" << std::endl;
+    return false;
+  }
+  return WriteCompressedIdxFile(labels_filename, dataset.labels(),
+                                dataset.size(), 1, 1, 1, 1, chunk_images);
+}
+}
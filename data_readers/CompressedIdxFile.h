@@ -0,0 +1,163 @@
+/** Interface file for a chunked, run-length compressed container of IDX
+ *  (MNIST-format) data.
+ *
+ *  Character images are mostly uniform background, so their bytes are
+ *  long runs of one value.  The container keeps the IDX header (magic
+ *  number and dimensions) behind a magic number of its own, and splits the
+ *  items into chunks of a fixed number of images (or labels), each
+ *  compressed on its own with a PackBits-style run-length code:
+ *
+ *    - a control byte c < 128 is followed by c + 1 literal bytes, and
+ *    - a control byte c >= 128 is followed by one byte repeated c - 125
+ *      times (3 to 130).
+ *
+ *  The end offset of every chunk is stored after the header, so any chunk
+ *  can be decoded on its own: for random access to a few images, or with
+ *  the chunks decoded in parallel to load the whole data set.
+ *
+ *  An IDX file always starts with two zero bytes and a compressed one with
+ *  'I', so the two are told apart from their first bytes, and the MNIST
+ *  readers (ReadMnistDataset(), ReadMnistImages() and ReadMnistLabels())
+ *  accept either.  The mapped and chunk-streaming readers need the raw
+ *  layout and accept only IDX files.
+ *
+ *  \file statistics/data_readers/CompressedIdxFile.h
+ *  \date 17 Oct 2026
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "imgs/statistics/data_readers/PackedDataset.h"
+
+namespace statistics {
+
+/// Images (or labels) per chunk of a compressed container by default
+constexpr std::size_t kCompressedChunkItems = 1024;
+
+class CompressedIdxFile {
+ public:
+  /** Construct an empty container
+   */
+  CompressedIdxFile() = default;
+
+  /** Read a compressed container (the compressed bytes are held in memory;
+   *  nothing is decoded yet)
+   *
+   *  \param[in] filename           std::string containing the name of the
+   *                                compressed file
+   *  \param[in] number_dimensions  the dimensions its IDX data must have (3
+   *                                for images, 1 for labels)
+   *
+   *  The container is left empty, with a message, if the file cannot be
+   *  read or its header or chunk table is inconsistent.
+   */
+  CompressedIdxFile(const std::string filename, const int number_dimensions);
+
+  bool empty() const { return bytes_ == nullptr; }
+
+  /// Number of items (images or labels)
+  std::size_t size() const { return number_items_; }
+
+  /// Geometry of each image (1 x 1 for labels)
+  int rows() const { return number_rows_; }
+  int cols() const { return number_cols_; }
+
+  /// Number of bytes of each item (rows x cols)
+  std::size_t item_bytes() const {
+    return static_cast<std::size_t>(number_rows_) * number_cols_;
+  }
+
+  /// Items per chunk (the last chunk may hold fewer), and the chunks
+  std::size_t chunk_items() const { return chunk_items_; }
+  std::size_t number_chunks() const { return chunk_ends_.size(); }
+
+  /// Length of the whole file
+  std::size_t compressed_bytes() const { return bytes_ ? bytes_->size() : 0; }
+
+  /** Decode one chunk
+   *
+   *  \param[in]  chunk  index of the chunk
+   *  \param[out] items  its items, back to back (chunk_items() x
+   *                     item_bytes() bytes at most)
+   *  \return            number of items decoded (0, with a message, if the
+   *                     chunk is corrupt)
+   */
+  std::size_t DecodeChunk(const std::size_t chunk, unsigned char* items) const;
+
+  /** Decode every item, the chunks in parallel
+   *
+   *  \param[out] items           the items, stride bytes apart (e.g. the
+   *                              rows of a packed data set)
+   *  \param[in]  stride          bytes from one item to the next (at least
+   *                              item_bytes())
+   *  \param[in]  number_threads  decoding threads (0 for one per hardware
+   *                              thread) [default is 0]
+   *  \return                     whether every chunk decoded
+   */
+  bool Decode(unsigned char* items, const std::size_t stride,
+              const unsigned int number_threads = 0) const;
+
+ private:
+  std::shared_ptr<std::vector<unsigned char>> bytes_;
+  std::size_t data_offset_ = 0;
+  std::vector<std::uint64_t> chunk_ends_;
+  std::size_t number_items_ = 0;
+  int number_rows_ = 1;
+  int number_cols_ = 1;
+  std::size_t chunk_items_ = 0;
+};
+
+/** Whether a file is a compressed container (rather than, e.g., IDX)
+ *
+ *  \param[in] filename  std::string containing the name of the file
+ */
+bool IsCompressedIdxFile(const std::string filename);
+
+/** Write items as a compressed container
+ *
+ *  \param[in] filename           std::string containing the name of the
+ *                                file to (over)write
+ *  \param[in] items              the first item
+ *  \param[in] number_items       number of items
+ *  \param[in] number_rows        rows of each item (1 for labels)
+ *  \param[in] number_cols        columns of each item (1 for labels)
+ *  \param[in] stride             bytes from one item to the next
+ *  \param[in] number_dimensions  3 for images, 1 for labels
+ *  \param[in] chunk_items        items per chunk [default is
+ *                                kCompressedChunkItems]
+ *  \return                       whether the file was written completely
+ */
+bool WriteCompressedIdxFile(const std::string filename,
+                            const unsigned char* items,
+                            const std::size_t number_items,
+                            const int number_rows, const int number_cols,
+                            const std::size_t stride,
+                            const int number_dimensions,
+                            const std::size_t chunk_items =
+                                kCompressedChunkItems);
+
+/** Write the images and labels of a packed data set as compressed
+ *  containers, readable again with ReadMnistDataset()
+ *
+ *  \param[in] images_filename  std::string containing the name of the file
+ *                              to (over)write with the images
+ *  \param[in] labels_filename  std::string containing the name of the file
+ *                              to (over)write with the labels (an empty
+ *                              string writes the images only)
+ *  \param[in] dataset          the packed data set to write
+ *  \param[in] chunk_images     images per chunk [default is
+ *                              kCompressedChunkItems]
+ *  \return                     whether every file was written completely
+ */
+bool WriteCompressedMnistDataset(const std::string images_filename,
+                                 const std::string labels_filename,
+                                 const PackedDataset& dataset,
+                                 const std::size_t chunk_images =
+                                     kCompressedChunkItems);
+}
@@ -7,4 +7,10 @@
 
 #pragma once
 
+#include "imgs/statistics/data_readers/BinaryDataset.h"
+#include "imgs/statistics/data_readers/IdxChunkReader.h"
+#include "imgs/statistics/data_readers/ImageDirectoryLoader.h"
+#include "imgs/statistics/data_readers/LabeledCharacters.h"
 #include "imgs/statistics/data_readers/Mnist.h"
+#include "imgs/statistics/data_readers/NibbleDataset.h"
+#include "imgs/statistics/data_readers/PackedDataset.h"
@@ -0,0 +1,202 @@
+/** Implementation file for reading an IDX (MNIST-format) image and label
+ *  file pair one fixed-size block of images at a time.
+ *
+ *  \file statistics/data_readers/IdxChunkReader.cpp
+ *  \date 17 Oct 2026
+ */
+
+#include "imgs/statistics/data_readers/IdxChunkReader.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace statistics {
+
+namespace {
+
+// IDX magic numbers: unsigned byte data of three and of one dimension
+constexpr std::uint32_t kImagesMagic = 0x00000803;
+constexpr std::uint32_t kLabelsMagic = 0x00000801;
+
+// Bytes of the image and label file headers
+constexpr std::size_t kImagesHeaderBytes = 16;
+constexpr std::size_t kLabelsHeaderBytes = 8;
+
+// Read count bytes at offset, retrying short reads
+bool ReadFully(const int descriptor, void* buffer, const std::size_t count,
+               const std::size_t offset) {
+  unsigned char* bytes = static_cast<unsigned char*>(buffer);
+  std::size_t done = 0;
+  while (done < count) {
+    const ssize_t result =
+        pread(descriptor, bytes + done, count - done, offset + done);
+    if (result <= 0) {
+      return false;
+    }
+    done += static_cast<std::size_t>(result);
+  }
+  return true;
+}
+
+// Read an IDX header of count big-endian 32-bit fields
+bool ReadHeader(const int descriptor, std::uint32_t* fields, const int count) {
+  if (!ReadFully(descriptor, fields, 4 * count, 0)) {
+    return false;
+  }
+  for (int f = 0; f < count; ++f) {
+    fields[f] = __builtin_bswap32(fields[f]);
+  }
+  return true;
+}
+
+// Length of an open file
+std::size_t FileLength(const int descriptor) {
+  struct stat status;
+  return (fstat(descriptor, &status) == 0)
+             ? static_cast<std::size_t>(status.st_size)
+             : 0;
+}
+
+}  // namespace
+
+IdxChunkReader::IdxChunkReader(const std::string images_filename,
+                               const std::string labels_filename,
+                               const std::size_t chunk_images)
+    : chunk_images_(chunk_images) {
+  if (chunk_images_ == 0) {
+    std::cerr << "Chunks must hold at least one image!" << std::endl;
+    return;
+  }
+  const int images_descriptor = open(images_filename.c_str(), O_RDONLY);
+  if (images_descriptor < 0) {
+    std::cerr << "Unable to open MNIST images file: " << images_filename
+              << std::endl;
+    return;
+  }
+  const int labels_descriptor = open(labels_filename.c_str(), O_RDONLY);
+  if (labels_descriptor < 0) {
+    std::cerr << "Unable to open MNIST labels file: " << labels_filename
+              << std::endl;
+    close(images_descriptor);
+    return;
+  }
+
+  // Both headers must describe exactly their files' contents, and the same
+  // number of items
+  std::uint32_t images_header[4];
+  std::uint32_t labels_header[2];
+  const bool valid =
+      ReadHeader(images_descriptor, images_header, 4) &&
+      ReadHeader(labels_descriptor, labels_header, 2) &&
+      images_header[0] == kImagesMagic && labels_header[0] == kLabelsMagic &&
+      images_header[1] == labels_header[1] &&
+      images_header[2] <= INT32_MAX && images_header[3] <= INT32_MAX &&
+      kImagesHeaderBytes + static_cast<std::uint64_t>(images_header[1]) *
+                               images_header[2] * images_header[3] ==
+          FileLength(images_descriptor) &&
+      kLabelsHeaderBytes + labels_header[1] == FileLength(labels_descriptor);
+  if (!valid) {
+    std::cerr << "Invalid or mismatched MNIST files: " << images_filename
+              << ", " << labels_filename << std::endl;
+    close(images_descriptor);
+    close(labels_descriptor);
+    return;
+  }
+
+  images_descriptor_ = images_descriptor;
+  labels_descriptor_ = labels_descriptor;
+  number_images_ = images_header[1];
+  number_rows_ = static_cast<int>(images_header[2]);
+  number_cols_ = static_cast<int>(images_header[3]);
+  posix_fadvise(images_descriptor_, 0, 0, POSIX_FADV_SEQUENTIAL);
+  ReadAhead(0);
+}
+
+IdxChunkReader::~IdxChunkReader() {
+  if (images_descriptor_ >= 0) {
+    close(images_descriptor_);
+    close(labels_descriptor_);
+  }
+}
+
+IdxChunkReader::IdxChunkReader(IdxChunkReader&& other) noexcept {
+  *this = std::move(other);
+}
+
+IdxChunkReader& IdxChunkReader::operator=(IdxChunkReader&& other) noexcept {
+  std::swap(images_descriptor_, other.images_descriptor_);
+  std::swap(labels_descriptor_, other.labels_descriptor_);
+  std::swap(number_images_, other.number_images_);
+  std::swap(number_rows_, other.number_rows_);
+  std::swap(number_cols_, other.number_cols_);
+  std::swap(chunk_images_, other.chunk_images_);
+  std::swap(position_, other.position_);
+  return *this;
+}
+
+PackedDataset IdxChunkReader::MakeChunk() const {
+  return PackedDataset(chunk_images_, number_rows_, number_cols_);
+}
+
+std::size_t IdxChunkReader::ReadChunk(PackedDataset& chunk) {
+  if (empty() || position_ >= number_images_) {
+    return 0;
+  }
+  if (chunk.size() < chunk_images_ || chunk.rows() != number_rows_ ||
+      chunk.cols() != number_cols_) {
+    std::cerr << "The chunk does not match the reader!" << std::endl;
+    return 0;
+  }
+  const std::size_t count =
+      std::min(chunk_images_, number_images_ - position_);
+  ReadAhead(position_ + count);
+
+  // The block's images arrive back to back at the start of the chunk, and
+  // are then moved out to their padded rows from the last one back (each
+  // moves up, over images already moved)
+  const std::size_t dimension = chunk.dimension();
+  const std::size_t stride = chunk.stride();
+  unsigned char* pixels = chunk.ptr(0);
+  if (!ReadFully(images_descriptor_, pixels, count * dimension,
+                 kImagesHeaderBytes + position_ * dimension) ||
+      !ReadFully(labels_descriptor_, chunk.labels(), count,
+                 kLabelsHeaderBytes + position_)) {
+    std::cerr << "Error reading MNIST images " << position_ << " to "
+              << position_ + count << std::endl;
+    return 0;
+  }
+  if (stride != dimension) {
+    for (std::size_t i = count; i-- > 0;) {
+      std::memmove(pixels + i * stride, pixels + i * dimension, dimension);
+      std::memset(pixels + i * stride + dimension, 0, stride - dimension);
+    }
+  }
+  position_ += count;
+  return count;
+}
+
+void IdxChunkReader::Rewind() {
+  position_ = 0;
+  ReadAhead(0);
+}
+
+void IdxChunkReader::ReadAhead(const std::size_t idx) const {
+  if (idx >= number_images_) {
+    return;
+  }
+  const std::size_t dimension =
+      static_cast<std::size_t>(number_rows_) * number_cols_;
+  const std::size_t count = std::min(chunk_images_, number_images_ - idx);
+  posix_fadvise(images_descriptor_, kImagesHeaderBytes + idx * dimension,
+                count * dimension, POSIX_FADV_WILLNEED);
+  posix_fadvise(labels_descriptor_, kLabelsHeaderBytes + idx, count,
+                POSIX_FADV_WILLNEED);
+}
+}
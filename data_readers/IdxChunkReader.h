@@ -0,0 +1,94 @@
+/** Interface file for reading an IDX (MNIST-format) image and label file
+ *  pair one fixed-size block of images at a time.
+ *
+ *  Only one block's pixels and labels are ever held in memory, so a data
+ *  set larger than the machine's memory can be streamed through with a
+ *  bounded footprint.  Each block is read with one positioned read of its
+ *  images and one of its labels straight into a packed data set (the rows
+ *  are then spread out to the packed stride in place), and the kernel is
+ *  told to read the following block ahead while the current one is used.
+ *
+ *  \file statistics/data_readers/IdxChunkReader.h
+ *  \date 17 Oct 2026
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+#include "imgs/statistics/data_readers/PackedDataset.h"
+
+namespace statistics {
+
+class IdxChunkReader {
+ public:
+  /** Construct a reader with nothing to read
+   */
+  IdxChunkReader() = default;
+
+  /** Open an IDX image and label file pair
+   *
+   *  \param[in] images_filename  std::string containing the name of the
+   *                              IDX file of images
+   *  \param[in] labels_filename  std::string containing the name of the
+   *                              IDX file of their labels
+   *  \param[in] chunk_images     number of images in each block (the last
+   *                              may hold fewer)
+   *
+   *  The reader is left empty, with a message, if either file cannot be
+   *  opened, a header does not match its file's length, or the files hold
+   *  different numbers of items.
+   */
+  IdxChunkReader(const std::string images_filename,
+                 const std::string labels_filename,
+                 const std::size_t chunk_images);
+  ~IdxChunkReader();
+
+  IdxChunkReader(IdxChunkReader&& other) noexcept;
+  IdxChunkReader& operator=(IdxChunkReader&& other) noexcept;
+  IdxChunkReader(const IdxChunkReader&) = delete;
+  IdxChunkReader& operator=(const IdxChunkReader&) = delete;
+
+  bool empty() const { return images_descriptor_ < 0; }
+
+  /// Number of images in the whole data set
+  std::size_t size() const { return number_images_; }
+  int rows() const { return number_rows_; }
+  int cols() const { return number_cols_; }
+  std::size_t chunk_images() const { return chunk_images_; }
+
+  /// Index of the first image the next ReadChunk() reads
+  std::size_t position() const { return position_; }
+
+  /** A packed data set of chunk_images() images of the right geometry to
+   *  read blocks into
+   */
+  PackedDataset MakeChunk() const;
+
+  /** Read the next block of images and labels
+   *
+   *  \param[in,out] chunk  a data set from MakeChunk(); its first images
+   *                        and labels are overwritten with the block's
+   *  \return               number of images read (0 at the end of the
+   *                        data set or, with a message, on a read error)
+   */
+  std::size_t ReadChunk(PackedDataset& chunk);
+
+  /** Start again from the first image
+   */
+  void Rewind();
+
+ private:
+  // Hint the kernel to read the block starting at image idx
+  void ReadAhead(const std::size_t idx) const;
+
+  int images_descriptor_ = -1;
+  int labels_descriptor_ = -1;
+  std::size_t number_images_ = 0;
+  int number_rows_ = 0;
+  int number_cols_ = 0;
+  std::size_t chunk_images_ = 0;
+  std::size_t position_ = 0;
+};
+}
@@ -0,0 +1,115 @@
+/** Implementation file for loading the images of a directory in parallel
+ *  through a bounded queue.
+ *
+ *  \file statistics/data_readers/ImageDirectoryLoader.cpp
+ *  \date 17 Oct 2026
+ */
+
+#include "imgs/statistics/data_readers/ImageDirectoryLoader.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <iostream>
+
+#include "imgs/statistics/parallel/ThreadPool.h"
+
+namespace fs = std::filesystem;
+
+namespace statistics {
+
+ImageDirectoryLoader::ImageDirectoryLoader(const std::string directory,
+                                           const bool color,
+                                           const unsigned int number_threads,
+                                           const std::size_t capacity)
+    : color_(color),
+      slots_(std::max<std::size_t>(capacity, 1)),
+      ready_(slots_.size(), 0) {
+  std::error_code error;
+  for (const auto& entry : fs::directory_iterator(directory, error)) {
+    if (entry.is_regular_file()) {
+      filenames_.push_back(entry.path().string());
+    }
+  }
+  if (error) {
+    std::cerr << "Unable to read the image directory: " << directory
+              << std::endl;
+    filenames_.clear();
+  }
+  std::sort(filenames_.begin(), filenames_.end());
+
+  // No more workers than files or slots could keep busy
+  const unsigned int threads = (number_threads == 0)
+                                   ? ThreadPool::HardwareThreads()
+                                   : number_threads;
+  const std::size_t number_workers =
+      std::min<std::size_t>({threads, filenames_.size(), slots_.size()});
+  for (std::size_t w = 0; w < number_workers; ++w) {
+    workers_.emplace_back(&ImageDirectoryLoader::Work, this);
+  }
+}
+
+ImageDirectoryLoader::~ImageDirectoryLoader() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  room_.notify_all();
+  for (auto& worker : workers_) {
+    worker.join();
+  }
+}
+
+void ImageDirectoryLoader::Work() {
+  const std::size_t capacity = slots_.size();
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    // Files are claimed in order, so every earlier file is already claimed
+    // and the consumer never waits on one that no worker holds
+    if (stopping_ || next_claim_ >= filenames_.size()) {
+      return;
+    }
+    const std::size_t idx = next_claim_++;
+    room_.wait(lock, [&] { return stopping_ || idx < next_taken_ + capacity; });
+    if (stopping_) {
+      return;
+    }
+    lock.unlock();
+
+    LoadedImage image;
+    image.index = idx;
+    image.filename = filenames_[idx];
+    if (color_) {
+      image.color = cv::imread(image.filename, cv::IMREAD_COLOR);
+      if (!image.color.empty()) {
+        cv::cvtColor(image.color, image.gray, cv::COLOR_BGR2GRAY);
+      }
+    } else {
+      image.gray = cv::imread(image.filename, cv::IMREAD_GRAYSCALE);
+    }
+
+    lock.lock();
+    slots_[idx % capacity] = std::move(image);
+    ready_[idx % capacity] = 1;
+    decoded_.notify_all();
+  }
+}
+
+bool ImageDirectoryLoader::Next(LoadedImage& image) {
+  const std::size_t capacity = slots_.size();
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (next_taken_ < filenames_.size()) {
+    const std::size_t slot = next_taken_ % capacity;
+    decoded_.wait(lock, [&] { return ready_[slot] != 0; });
+    image = std::move(slots_[slot]);
+    slots_[slot] = LoadedImage();
+    ready_[slot] = 0;
+    ++next_taken_;
+    room_.notify_all();
+    if (!image.gray.empty()) {
+      return true;
+    }
+    std::cerr << "Failed to load: " << image.filename << std::endl;
+  }
+  return false;
+}
+}
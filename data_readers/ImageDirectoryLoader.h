@@ -0,0 +1,104 @@
+/** Interface file for loading the images of a directory (e.g. our license
+ *  plate photographs) in parallel, decoding each file once, and handing
+ *  them to the consumer in order through a bounded queue.
+ *
+ *  The files are taken in name order.  Worker threads claim them in that
+ *  order and decode each one once, in color when the consumer wants color
+ *  (the gray image then derived from it with cv::cvtColor()) or straight
+ *  to gray otherwise.  A worker holds back from a file until the queue has
+ *  room for it, so at most capacity decoded images exist at a time however
+ *  large the directory, and processing of the first plates starts as soon
+ *  as they are decoded rather than after the whole directory.
+ *
+ *  \file statistics/data_readers/ImageDirectoryLoader.h
+ *  \date 17 Oct 2026
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <opencv2/opencv.hpp>
+
+namespace statistics {
+
+/** One decoded image of a directory
+ */
+struct LoadedImage {
+  /// Position of the file in name order among the directory's files
+  std::size_t index = 0;
+
+  /// Path of the file
+  std::string filename;
+
+  /// The image in BGR color (empty unless color was requested), and in gray
+  cv::Mat color;
+  cv::Mat gray;
+};
+
+class ImageDirectoryLoader {
+ public:
+  /** Start decoding the regular files of a directory
+   *
+   *  \param[in] directory       std::string containing the name of the
+   *                             directory
+   *  \param[in] color           whether to keep the color image as well as
+   *                             the gray one [default is false]
+   *  \param[in] number_threads  decoding threads (0 for one per hardware
+   *                             thread) [default is 0]
+   *  \param[in] capacity        most decoded images held at a time, waiting
+   *                             for or being handed to the consumer
+   *                             [default is 16]
+   *
+   *  A directory that cannot be read is reported and loads no images.
+   */
+  explicit ImageDirectoryLoader(const std::string directory,
+                                const bool color = false,
+                                const unsigned int number_threads = 0,
+                                const std::size_t capacity = 16);
+
+  /** Stop decoding (any images not yet taken are dropped) and join the
+   *  workers
+   */
+  ~ImageDirectoryLoader();
+
+  ImageDirectoryLoader(const ImageDirectoryLoader&) = delete;
+  ImageDirectoryLoader& operator=(const ImageDirectoryLoader&) = delete;
+
+  /// Number of files in the directory
+  std::size_t size() const { return filenames_.size(); }
+
+  /** Take the next image in name order, waiting for it to be decoded
+   *  (files that cannot be decoded are reported and skipped)
+   *
+   *  \param[out] image  the image
+   *  \return            false once every file has been taken
+   */
+  bool Next(LoadedImage& image);
+
+ private:
+  // Claim files in order and decode them into their slots
+  void Work();
+
+  std::vector<std::string> filenames_;
+  bool color_;
+
+  // Decoded images by index modulo the capacity, whether each slot holds
+  // its image (the file's decode succeeded or failed), the next file to
+  // claim and the next one to hand out
+  std::vector<LoadedImage> slots_;
+  std::vector<char> ready_;
+  std::size_t next_claim_ = 0;
+  std::size_t next_taken_ = 0;
+  bool stopping_ = false;
+  std::mutex mutex_;
+  std::condition_variable room_;
+  std::condition_variable decoded_;
+  std::vector<std::thread> workers_;
+};
+}
@@ -0,0 +1,156 @@
+/** Implementation file for packing a directory of labeled character
+ *  images into a data set, and for stratified training and test splits.
+ *
+ *  \file statistics/data_readers/LabeledCharacters.cpp
+ *  \date 17 Oct 2026
+ */
+
+#include "imgs/statistics/data_readers/LabeledCharacters.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cctype>
+#include <cmath>
+#include <filesystem>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include <opencv2/opencv.hpp>
+
+#include "imgs/statistics/parallel/ThreadPool.h"
+
+namespace fs = std::filesystem;
+
+namespace statistics {
+
+namespace {
+
+// File name prefix label_plates writes, followed by the character
+const std::string kLabelPrefix = "PlateLabel";
+
+}  // namespace
+
+int CharacterLabel(const char character) {
+  if (character >= '0' && character <= '9') {
+    return character - '0';
+  }
+  const char upper = static_cast<char>(std::toupper(character));
+  if (upper >= 'A' && upper <= 'Z') {
+    return upper - 'A' + 10;
+  }
+  return -1;
+}
+
+char LabelCharacter(const unsigned char label) {
+  return (label < 10) ? static_cast<char>('0' + label)
+                      : static_cast<char>('A' + label - 10);
+}
+
+PackedDataset ReadLabeledCharacters(const std::string directory,
+                                    const int number_rows,
+                                    const int number_cols,
+                                    const unsigned int number_threads) {
+  // The labeled character files, in name order so that the data set does
+  // not depend on the directory's order
+  std::vector<fs::path> filenames;
+  std::vector<unsigned char> labels;
+  std::error_code error;
+  for (const auto& entry : fs::directory_iterator(directory, error)) {
+    const std::string filename = entry.path().filename().string();
+    if (!entry.is_regular_file() || entry.path().extension() != ".png" ||
+        filename.compare(0, kLabelPrefix.size(), kLabelPrefix) != 0 ||
+        filename.size() <= kLabelPrefix.size() ||
+        CharacterLabel(filename[kLabelPrefix.size()]) < 0) {
+      continue;
+    }
+    filenames.push_back(entry.path());
+  }
+  if (error) {
+    std::cerr << "Unable to read the labeled character directory: "
+              << directory << std::endl;
+    return PackedDataset();
+  }
+  std::sort(filenames.begin(), filenames.end());
+
+  // Decode each image straight into its row of the packed buffer
+  PackedDataset dataset(filenames.size(), number_rows, number_cols);
+  std::vector<unsigned char> decoded(filenames.size(), 0);
+  ThreadPool pool(number_threads);
+  pool.ParallelFor(
+      0, filenames.size(), 16,
+      [&](std::size_t begin, std::size_t end, unsigned int) {
+        for (std::size_t i = begin; i < end; ++i) {
+          cv::Mat image = cv::imread(filenames[i].string(),
+                                     cv::IMREAD_GRAYSCALE);
+          if (image.empty()) {
+            continue;
+          }
+          cv::Mat packed(number_rows, number_cols, CV_8UC1, dataset.ptr(i));
+          cv::resize(image, packed, packed.size(), 0, 0, cv::INTER_AREA);
+          dataset.labels()[i] = static_cast<unsigned char>(CharacterLabel(
+              filenames[i].filename().string()[kLabelPrefix.size()]));
+          decoded[i] = 1;
+        }
+      });
+
+  // Drop the images that could not be decoded
+  std::vector<std::size_t> kept;
+  kept.reserve(filenames.size());
+  for (std::size_t i = 0; i < filenames.size(); ++i) {
+    if (decoded[i]) {
+      kept.push_back(i);
+    } else {
+      std::cerr << "Unable to decode labeled character: "
+                << filenames[i].string() << std::endl;
+    }
+  }
+  if (kept.size() != filenames.size()) {
+    return SelectImages(dataset, kept);
+  }
+  dataset.ComputeStatistics();
+  return dataset;
+}
+
+bool StratifiedSplit(const PackedDataset& dataset, const double test_fraction,
+                     PackedDataset& training, PackedDataset& test,
+                     const unsigned int seed) {
+  if (!dataset.has_labels()) {
+    std::cerr << "A stratified split requires labeled images!" << std::endl;
+    return false;
+  }
+  if (test_fraction < 0 || test_fraction > 1) {
+    std::cerr << "The test fraction must be between 0 and 1!" << std::endl;
+    return false;
+  }
+
+  std::array<std::vector<std::size_t>, 256> classes;
+  for (std::size_t idx = 0; idx < dataset.size(); ++idx) {
+    classes[dataset.label(idx)].push_back(idx);
+  }
+
+  std::vector<std::size_t> training_indices;
+  std::vector<std::size_t> test_indices;
+  std::mt19937 generator(seed);
+  for (auto& members : classes) {
+    if (seed != 0) {
+      std::shuffle(members.begin(), members.end(), generator);
+    }
+    const std::size_t number_test = static_cast<std::size_t>(
+        std::lround(test_fraction * members.size()));
+    const std::size_t number_training = members.size() - number_test;
+    training_indices.insert(training_indices.end(), members.begin(),
+                            members.begin() + number_training);
+    test_indices.insert(test_indices.end(),
+                        members.begin() + number_training, members.end());
+  }
+
+  // Keep the data set's order within each set
+  std::sort(training_indices.begin(), training_indices.end());
+  std::sort(test_indices.begin(), test_indices.end());
+  training = SelectImages(dataset, training_indices);
+  test = SelectImages(dataset, test_indices);
+  return true;
+}
+}
@@ -0,0 +1,83 @@
+/** Interface file for packing a directory of labeled character images (as
+ *  written by label_plates) into a data set, and for splitting a labeled
+ *  data set into stratified training and test sets.
+ *
+ *  label_plates saves every character it is shown as
+ *  PlateLabel<c>_<i><j>.png, where c is the key pressed for it.  The
+ *  characters are enumerated the way the confusion matrix prints them from
+ *  an ASCII offset of 48: '0' through '9' are 0 through 9 and 'A' through
+ *  'Z' are 10 through 35 (lower case keys count as upper case), so a data
+ *  set packed here can be written with WriteMnistDataset() and read by the
+ *  existing classification programs unchanged.
+ *
+ *  \file statistics/data_readers/LabeledCharacters.h
+ *  \date 17 Oct 2026
+ */
+
+#pragma once
+
+#include <string>
+
+#include "imgs/statistics/data_readers/PackedDataset.h"
+
+namespace statistics {
+
+/** Enumerated label of a labeled character
+ *
+ *  \param[in] character  the character ('0'-'9', 'A'-'Z' or 'a'-'z')
+ *  \return               its label, or -1 for any other character
+ */
+int CharacterLabel(const char character);
+
+/** Character of an enumerated label (the inverse of CharacterLabel())
+ *
+ *  \param[in] label  the label (0 through 35)
+ *  \return           its character ('0'-'9' or 'A'-'Z')
+ */
+char LabelCharacter(const unsigned char label);
+
+/** Decode every labeled character image of a directory into a packed data
+ *  set
+ *
+ *  The files are taken in name order and decoded in parallel, each
+ *  straight into its row of the data set, as grayscale and resized (by
+ *  pixel area) to the requested geometry.  Files that are not
+ *  PlateLabel<c>_*.png for a character c that CharacterLabel() accepts are
+ *  ignored, and images that fail to decode are skipped with a message.
+ *
+ *  \param[in] directory       std::string containing the name of the
+ *                             directory of labeled characters
+ *  \param[in] number_rows     number of rows of each packed image
+ *                             [default is 28]
+ *  \param[in] number_cols     number of columns of each packed image
+ *                             [default is 28]
+ *  \param[in] number_threads  decoding threads (0 for one per hardware
+ *                             thread) [default is 0]
+ *  \return                    the labeled characters, with their per-image
+ *                             statistics computed (empty, with a message,
+ *                             if the directory cannot be read)
+ */
+PackedDataset ReadLabeledCharacters(const std::string directory,
+                                    const int number_rows = 28,
+                                    const int number_cols = 28,
+                                    const unsigned int number_threads = 0);
+
+/** Split a labeled data set into training and test sets with the same
+ *  share of every class
+ *
+ *  \param[in]  dataset        labeled packed data set
+ *  \param[in]  test_fraction  fraction of each class's images (rounded to
+ *                             the nearest image) put in the test set
+ *  \param[out] training       the remaining images
+ *  \param[out] test           the test images
+ *  \param[in]  seed           seed of the shuffle of each class before it
+ *                             is split (0 splits each class in data set
+ *                             order, its last images going to the test
+ *                             set) [default is 0]
+ *  \return                    whether the data set is labeled and the
+ *                             fraction is between 0 and 1
+ */
+bool StratifiedSplit(const PackedDataset& dataset, const double test_fraction,
+                     PackedDataset& training, PackedDataset& test,
+                     const unsigned int seed = 0);
+}
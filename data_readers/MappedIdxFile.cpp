@@ -0,0 +1,129 @@
+/** Implementation file for a read-only memory mapping of an IDX
+ *  (MNIST-format) file.
+ *
+ *  \file statistics/data_readers/MappedIdxFile.cpp
+ *  \date 17 Oct 2026
+ */
+
+#include "imgs/statistics/data_readers/MappedIdxFile.h"
+
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace statistics {
+
+namespace {
+
+// IDX data type code of unsigned bytes (the third byte of the magic number)
+constexpr unsigned char kUnsignedByteType = 0x08;
+
+// One big-endian 32-bit header field
+std::uint32_t HeaderField(const unsigned char* field) {
+  std::uint32_t value = 0;
+  std::memcpy(&value, field, sizeof(value));
+  return __builtin_bswap32(value);
+}
+
+}  // namespace
+
+// The mapped bytes, unmapped with the last copy of the file
+struct MappedIdxFile::Mapping {
+  Mapping(void* address, const std::size_t length)
+      : address(address), length(length) {}
+  ~Mapping() { munmap(address, length); }
+
+  Mapping(const Mapping&) = delete;
+  Mapping& operator=(const Mapping&) = delete;
+
+  void* address;
+  std::size_t length;
+};
+
+MappedIdxFile::MappedIdxFile(const std::string filename,
+                             const int number_dimensions) {
+  if (number_dimensions < 1 || number_dimensions > 3) {
+    std::cerr << "IDX files are mapped with 1 to 3 dimensions!" << std::endl;
+    return;
+  }
+  const int descriptor = open(filename.c_str(), O_RDONLY);
+  if (descriptor < 0) {
+    std::cerr << "Unable to open IDX file: " << filename << std::endl;
+    return;
+  }
+  struct stat status;
+  if (fstat(descriptor, &status) != 0) {
+    std::cerr << "Unable to read the size of IDX file: " << filename
+              << std::endl;
+    close(descriptor);
+    return;
+  }
+  const std::size_t length = static_cast<std::size_t>(status.st_size);
+  const std::size_t header_bytes = 4 * (1 + number_dimensions);
+  if (length < header_bytes) {
+    std::cerr << "Truncated IDX file: " << filename << std::endl;
+    close(descriptor);
+    return;
+  }
+
+  // Map privately (copy on write), so that writes through an image header
+  // touch only this process's copy of a page, never the file; the mapping
+  // stays valid after its descriptor is closed
+  void* address = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE,
+                       descriptor, 0);
+  close(descriptor);
+  if (address == MAP_FAILED) {
+    std::cerr << "Unable to map IDX file: " << filename << std::endl;
+    return;
+  }
+  auto mapping = std::make_shared<Mapping>(address, length);
+  unsigned char* bytes = static_cast<unsigned char*>(address);
+
+  // Magic number: two zero bytes, the data type, and the dimensions
+  if (bytes[0] != 0 || bytes[1] != 0 || bytes[2] != kUnsignedByteType ||
+      bytes[3] != number_dimensions) {
+    std::cerr << "Not an IDX file of unsigned bytes in " << number_dimensions
+              << " dimension(s): " << filename << std::endl;
+    return;
+  }
+
+  // The dimensions must account for every byte after the header (stopping
+  // as soon as they exceed the file, before their product can overflow)
+  std::uint64_t number_bytes = 1;
+  std::uint32_t dimensions[3] = {0, 1, 1};
+  for (int d = 0; d < number_dimensions; ++d) {
+    dimensions[d] = HeaderField(bytes + 4 * (1 + d));
+    number_bytes *= dimensions[d];
+    if (number_bytes > length) {
+      break;
+    }
+  }
+  if (header_bytes + number_bytes != length ||
+      dimensions[1] > INT32_MAX || dimensions[2] > INT32_MAX) {
+    std::cerr << "IDX file size does not match its header: " << filename
+              << std::endl;
+    return;
+  }
+
+  mapping_ = std::move(mapping);
+  data_ = bytes + header_bytes;
+  number_items_ = dimensions[0];
+  number_rows_ = static_cast<int>(dimensions[1]);
+  number_cols_ = static_cast<int>(dimensions[2]);
+}
+
+cv::Mat MappedIdxFile::ImageHeader(const std::size_t idx) const {
+  return cv::Mat(number_rows_, number_cols_, CV_8UC1,
+                 data_ + idx * item_bytes());
+}
+
+cv::Mat MappedIdxFile::ImagesHeader() const {
+  return cv::Mat(static_cast<int>(number_items_ * number_rows_), number_cols_,
+                 CV_8UC1, data_);
+}
+}
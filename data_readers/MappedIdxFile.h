@@ -0,0 +1,90 @@
+/** Interface file for a memory mapping of an IDX (MNIST-format) file.
+ *
+ *  The file is mapped once and never copied: its header is checked (the
+ *  magic number must describe unsigned bytes of the expected number of
+ *  dimensions, and the dimensions must account for exactly the file's
+ *  length), and its images or labels are then read in place through
+ *  pointers or non-owning cv::Mat headers into the mapping.  The pages are
+ *  only read from disk as they are first touched, and stay in the page
+ *  cache for the next program that maps the same file.
+ *
+ *  The mapping is private (copy on write): pixels written through an image
+ *  header, e.g. by an in-place OpenCV operation, change a private copy of
+ *  their page and never the file.
+ *
+ *  Copies of a mapped file share the one mapping, which is unmapped when
+ *  the last of them is destroyed.
+ *
+ *  \file statistics/data_readers/MappedIdxFile.h
+ *  \date 17 Oct 2026
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+#include <opencv2/opencv.hpp>
+
+namespace statistics {
+
+class MappedIdxFile {
+ public:
+  /** Construct an empty mapping
+   */
+  MappedIdxFile() = default;
+
+  /** Map an IDX file of unsigned bytes
+   *
+   *  \param[in] filename           std::string containing the name of the
+   *                                IDX file to map
+   *  \param[in] number_dimensions  the dimensions the file must have (3
+   *                                for images, 1 for labels)
+   *
+   *  The mapping is left empty, with a message, if the file cannot be
+   *  mapped or its header does not match its length.
+   */
+  MappedIdxFile(const std::string filename, const int number_dimensions);
+
+  bool empty() const { return mapping_ == nullptr; }
+
+  /// Number of items (images or labels) in the file
+  std::size_t size() const { return number_items_; }
+
+  /// Geometry of each image (1 x 1 for a label file)
+  int rows() const { return number_rows_; }
+  int cols() const { return number_cols_; }
+
+  /// Number of bytes of each item (rows x cols)
+  std::size_t item_bytes() const {
+    return static_cast<std::size_t>(number_rows_) * number_cols_;
+  }
+
+  /// The items, one after another, right after the header
+  const unsigned char* data() const { return data_; }
+  const unsigned char* ptr(const std::size_t idx) const {
+    return data_ + idx * item_bytes();
+  }
+
+  /** A non-owning CV_8UC1 header onto one of the mapped images (valid only
+   *  as long as this mapping, or a copy of it, is alive; writing its pixels
+   *  changes them for every copy of this mapping, but not in the file)
+   */
+  cv::Mat ImageHeader(const std::size_t idx) const;
+
+  /** A non-owning CV_8UC1 header onto all of the mapped images stacked
+   *  vertically (size() x rows() rows of cols() pixels)
+   */
+  cv::Mat ImagesHeader() const;
+
+ private:
+  struct Mapping;
+
+  std::shared_ptr<Mapping> mapping_;
+  unsigned char* data_ = nullptr;
+  std::size_t number_items_ = 0;
+  int number_rows_ = 1;
+  int number_cols_ = 1;
+};
+}
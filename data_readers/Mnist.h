@@ -7,8 +7,12 @@
 
 #pragma once
 
+#include "imgs/statistics/data_readers/CompressedIdxFile.h"
+#include "imgs/statistics/data_readers/MappedIdxFile.h"
+#include "imgs/statistics/data_readers/ReadMnistDataset.h"
 #include "imgs/statistics/data_readers/ReadMnistImages.h"
 #include "imgs/statistics/data_readers/ReadMnistLabels.h"
+#include "imgs/statistics/data_readers/WriteMnistDataset.h"
 
 // MNIST data set files relative to the "build" directory
 const std::string MNIST_TRAIN_IMAGES_FILE =
@@ -0,0 +1,49 @@
+/** Implementation file for a 4-bit (nibble) packed image data set.
+ *
+ *  \file statistics/data_readers/NibbleDataset.cpp
+ *  \date 17 Oct 2026
+ */
+
+#include "imgs/statistics/data_readers/NibbleDataset.h"
+
+namespace statistics {
+
+NibbleDataset::NibbleDataset(const std::size_t number_images,
+                             const int number_rows, const int number_cols)
+    : number_images_(number_images),
+      number_rows_(number_rows),
+      number_cols_(number_cols) {
+  stride_ = ((dimension() + 1) / 2 + kNibbleAlignment - 1) /
+            kNibbleAlignment * kNibbleAlignment;
+  bytes_.assign(number_images_ * stride_, 0);
+  labels_.assign(number_images_, 0);
+}
+
+std::vector<unsigned char> NibbleDataset::LabelVector() const {
+  if (!has_labels_) {
+    return {};
+  }
+  return labels_;
+}
+
+NibbleDataset PackNibbles(const PackedDataset& images) {
+  NibbleDataset nibbles(images.size(), images.rows(), images.cols());
+  const std::size_t dimension = images.dimension();
+  for (std::size_t idx = 0; idx < images.size(); ++idx) {
+    const unsigned char* pixels = images.ptr(idx);
+    unsigned char* bytes = nibbles.ptr(idx);
+    for (std::size_t d = 0; d < dimension; ++d) {
+      const int level = pixels[d] / kNibbleFactor;
+      bytes[d / 2] |= static_cast<unsigned char>(level << (4 * (d % 2)));
+    }
+  }
+
+  if (images.has_labels()) {
+    for (std::size_t idx = 0; idx < images.size(); ++idx) {
+      nibbles.labels()[idx] = images.label(idx);
+    }
+    nibbles.set_has_labels(true);
+  }
+  return nibbles;
+}
+}
@@ -0,0 +1,97 @@
+/** Interface file for a 4-bit (nibble) packed image data set.  Each pixel
+ *  is reduced to one of 16 levels exactly as Quantize(src, dst, 4) does,
+ *  level = pixel / 17 (so level * 17 is the quantized pixel), and two
+ *  levels share every byte, low nibble first.  A training set takes half
+ *  the memory of the packed 8-bit rows, and distances are computed on the
+ *  levels directly (see NibbleKernel).
+ *
+ *  \file statistics/data_readers/NibbleDataset.h
+ *  \date 17 Oct 2026
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "imgs/statistics/data_readers/PackedDataset.h"
+
+namespace statistics {
+
+/// Number of 8-bit pixel values per 4-bit level (the Quantize() factor)
+constexpr int kNibbleFactor = 17;
+
+/// Byte alignment of every packed image (a multiple of the kernel width)
+constexpr std::size_t kNibbleAlignment = 32;
+
+class NibbleDataset {
+ public:
+  /** Construct an empty data set
+   */
+  NibbleDataset() = default;
+
+  /** Allocate a data set of all-zero images (and labels)
+   *
+   *  \param[in] number_images  number of images in the data set
+   *  \param[in] number_rows    number of rows in each image
+   *  \param[in] number_cols    number of columns in each image
+   */
+  NibbleDataset(const std::size_t number_images, const int number_rows,
+                const int number_cols);
+
+  std::size_t size() const { return number_images_; }
+  bool empty() const { return number_images_ == 0; }
+  int rows() const { return number_rows_; }
+  int cols() const { return number_cols_; }
+
+  /// Number of pixels (nibbles) in each image
+  std::size_t dimension() const {
+    return static_cast<std::size_t>(number_rows_) * number_cols_;
+  }
+
+  /// Number of bytes per image (zero padded to kNibbleAlignment)
+  std::size_t stride() const { return stride_; }
+
+  unsigned char* ptr(const std::size_t idx) {
+    return bytes_.data() + idx * stride_;
+  }
+  const unsigned char* ptr(const std::size_t idx) const {
+    return bytes_.data() + idx * stride_;
+  }
+
+  /// 4-bit level of one pixel of one image
+  int level(const std::size_t idx, const std::size_t pixel) const {
+    return (ptr(idx)[pixel / 2] >> (4 * (pixel % 2))) & 0x0f;
+  }
+
+  bool has_labels() const { return has_labels_; }
+  unsigned char* labels() { return labels_.data(); }
+  const unsigned char* labels() const { return labels_.data(); }
+  unsigned char label(const std::size_t idx) const { return labels_[idx]; }
+  void set_has_labels(const bool has_labels) { has_labels_ = has_labels; }
+
+  /** Copy the labels into a std::vector (e.g. for ConfusionMatrix)
+   */
+  std::vector<unsigned char> LabelVector() const;
+
+  /// Bytes held by the packed levels and labels
+  std::size_t MemoryBytes() const { return bytes_.size() + labels_.size(); }
+
+ private:
+  std::size_t number_images_ = 0;
+  int number_rows_ = 0;
+  int number_cols_ = 0;
+  std::size_t stride_ = 0;
+  std::vector<unsigned char> bytes_;
+  std::vector<unsigned char> labels_;
+  bool has_labels_ = false;
+};
+
+/** Quantize the images of a packed data set to 4 bits and pack two pixels
+ *  per byte, keeping their labels
+ *
+ *  \param[in] images  packed data set
+ *  \return            the nibble-packed data set
+ */
+NibbleDataset PackNibbles(const PackedDataset& images);
+}
@@ -0,0 +1,175 @@
+/** Implementation file for a packed image data set.
+ *
+ *  \file statistics/data_readers/PackedDataset.cpp
+ *  \date 17 Oct 2026
+ */
+
+#include "imgs/statistics/data_readers/PackedDataset.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <new>
+
+namespace statistics {
+
+PackedDataset::PackedDataset(const std::size_t number_images,
+                             const int number_rows, const int number_cols)
+    : number_images_(number_images),
+      number_rows_(number_rows),
+      number_cols_(number_cols) {
+  // Pad every image to the alignment so each row starts on a cache line
+  stride_ = (dimension() + kPackedAlignment - 1) / kPackedAlignment *
+            kPackedAlignment;
+
+  // One allocation holds the pixels followed by the labels
+  std::size_t pixel_bytes = number_images_ * stride_;
+  std::size_t total_bytes =
+      (pixel_bytes + number_images_ + kPackedAlignment - 1) /
+      kPackedAlignment * kPackedAlignment;
+  if (total_bytes == 0) {
+    total_bytes = kPackedAlignment;
+  }
+  void* buffer = std::aligned_alloc(kPackedAlignment, total_bytes);
+  if (buffer == nullptr) {
+    throw std::bad_alloc();
+  }
+  std::memset(buffer, 0, total_bytes);
+  storage_ = std::shared_ptr<void>(buffer, std::free);
+
+  pixels_ = static_cast<unsigned char*>(buffer);
+  labels_ = pixels_ + pixel_bytes;
+}
+
+PackedDataset::PackedDataset(const std::size_t number_images,
+                             const int number_rows, const int number_cols,
+                             unsigned char* pixels, const std::size_t stride,
+                             unsigned char* labels, std::shared_ptr<void> owner)
+    : number_images_(number_images),
+      number_rows_(number_rows),
+      number_cols_(number_cols),
+      stride_(stride),
+      pixels_(pixels),
+      labels_(labels),
+      storage_(std::move(owner)) {}
+
+cv::Mat PackedDataset::ImageHeader(const std::size_t idx) const {
+  return cv::Mat(number_rows_, number_cols_, CV_8UC1,
+                 const_cast<unsigned char*>(ptr(idx)));
+}
+
+std::vector<unsigned char> PackedDataset::LabelVector() const {
+  if (labels_ == nullptr) {
+    return {};
+  }
+  return std::vector<unsigned char>(labels_, labels_ + number_images_);
+}
+
+void PackedDataset::ComputeStatistics() {
+  // One block holds the squared norms, the pixel sums and the row sums
+  auto statistics = std::make_shared<std::vector<std::uint32_t>>(
+      number_images_ * (2 + number_rows_));
+  std::uint32_t* squared_norms = statistics->data();
+  std::uint32_t* pixel_sums = squared_norms + number_images_;
+  std::uint32_t* row_sums = pixel_sums + number_images_;
+
+  for (std::size_t idx = 0; idx < number_images_; ++idx) {
+    const unsigned char* image = ptr(idx);
+    std::uint32_t squared_norm = 0;
+    std::uint32_t pixel_sum = 0;
+    for (int r = 0; r < number_rows_; ++r) {
+      std::uint32_t row_sum = 0;
+      for (int c = 0; c < number_cols_; ++c) {
+        std::uint32_t pixel = image[r * number_cols_ + c];
+        squared_norm += pixel * pixel;
+        row_sum += pixel;
+      }
+      row_sums[idx * number_rows_ + r] = row_sum;
+      pixel_sum += row_sum;
+    }
+    squared_norms[idx] = squared_norm;
+    pixel_sums[idx] = pixel_sum;
+  }
+
+  SetStatistics(squared_norms, pixel_sums, row_sums, statistics);
+}
+
+void PackedDataset::SetStatistics(const std::uint32_t* squared_norms,
+                                  const std::uint32_t* pixel_sums,
+                                  const std::uint32_t* row_sums,
+                                  std::shared_ptr<void> owner) {
+  squared_norms_ = squared_norms;
+  pixel_sums_ = pixel_sums;
+  row_sums_ = row_sums;
+  statistics_storage_ = std::move(owner);
+}
+
+PackedDataset PackImages(const std::vector<cv::Mat>& images,
+                         const std::vector<unsigned char>& labels) {
+  if (images.empty()) {
+    return PackedDataset();
+  }
+  if (!labels.empty() && labels.size() != images.size()) {
+    std::cerr << "Images and labels size mismatch!" << std::endl;
+    return PackedDataset();
+  }
+
+  // Every image must be single channel 8-bit and share one geometry
+  const cv::Size image_size = images.front().size();
+  for (const auto& image : images) {
+    if (image.type() != CV_8UC1 || image.size() != image_size) {
+      std::cerr << "Packed images must all be CV_8UC1 and "
+                << image_size.height << "x" << image_size.width << std::endl;
+      return PackedDataset();
+    }
+  }
+
+  PackedDataset dataset(images.size(), image_size.height, image_size.width);
+  for (std::size_t idx = 0; idx < images.size(); ++idx) {
+    unsigned char* dst = dataset.ptr(idx);
+    for (int r = 0; r < image_size.height; ++r) {
+      std::memcpy(dst + r * image_size.width, images[idx].ptr<uchar>(r),
+                  image_size.width);
+    }
+    if (!labels.empty()) {
+      dataset.labels()[idx] = labels[idx];
+    }
+  }
+  dataset.ComputeStatistics();
+
+  return dataset;
+}
+
+PackedDataset SelectImages(const PackedDataset& dataset,
+                           const std::vector<std::size_t>& indices) {
+  PackedDataset subset(indices.size(), dataset.rows(), dataset.cols());
+  for (std::size_t idx = 0; idx < indices.size(); ++idx) {
+    std::memcpy(subset.ptr(idx), dataset.ptr(indices[idx]),
+                dataset.dimension());
+    if (dataset.has_labels()) {
+      subset.labels()[idx] = dataset.label(indices[idx]);
+    }
+  }
+  subset.ComputeStatistics();
+
+  return subset;
+}
+
+PackedDataset SliceImages(const PackedDataset& dataset,
+                          const std::size_t begin, const std::size_t count) {
+  // A copy shares the pixels, labels and statistics, and keeps them alive
+  auto source = std::make_shared<PackedDataset>(dataset);
+  PackedDataset slice(count, source->rows(), source->cols(),
+                      source->ptr(begin), source->stride(),
+                      source->has_labels() ? source->labels() + begin
+                                           : nullptr,
+                      source);
+  if (source->has_statistics()) {
+    slice.SetStatistics(source->squared_norms() + begin,
+                        source->pixel_sums() + begin,
+                        source->row_sums(begin), source);
+  }
+
+  return slice;
+}
+}
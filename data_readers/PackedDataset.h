@@ -0,0 +1,183 @@
+/** Interface file for a packed image data set.  All of the images in the data
+ *  set are stored row-major in a single aligned N x D buffer of 8-bit pixels
+ *  (one image per row) alongside an array of their enumerated labels, so
+ *  that classifiers can scan the whole set linearly instead of walking a
+ *  std::vector of individually allocated cv::Mat(s).
+ *
+ *  \file statistics/data_readers/PackedDataset.h
+ *  \date 17 Oct 2026
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <opencv2/opencv.hpp>
+
+namespace statistics {
+
+/// Byte alignment of the packed pixel buffer and of every image row in it
+constexpr std::size_t kPackedAlignment = 64;
+
+/// Largest image dimension whose squared norms (up to 255^2 per pixel, and
+/// the ||a||^2 + ||b||^2 - 2 a.b built from them) are exact in the 32-bit
+/// statistics
+constexpr std::size_t kMaximumNormDimension = UINT32_MAX / (255 * 255);
+
+class PackedDataset {
+ public:
+  /** Construct an empty data set
+   */
+  PackedDataset() = default;
+
+  /** Allocate a zero-filled data set
+   *
+   *  \param[in] number_images  number of images (rows) in the data set
+   *  \param[in] number_rows    number of rows in each image
+   *  \param[in] number_cols    number of columns in each image
+   *
+   *  Each image row is padded with zeros to a multiple of kPackedAlignment
+   *  bytes; the padding never changes a distance between two images since
+   *  it is zero in both.
+   */
+  PackedDataset(const std::size_t number_images, const int number_rows,
+                const int number_cols);
+
+  /** Wrap externally owned pixel and label memory without copying it (in
+   *  the same spirit as the user-data cv::Mat constructor)
+   *
+   *  \param[in] number_images  number of images in the data set
+   *  \param[in] number_rows    number of rows in each image
+   *  \param[in] number_cols    number of columns in each image
+   *  \param[in] pixels         first pixel of the first image
+   *  \param[in] stride         number of bytes between consecutive images
+   *  \param[in] labels         label array (may be nullptr)
+   *  \param[in] owner          optional handle that keeps the memory alive
+   *                            for as long as any copy of this data set
+   */
+  PackedDataset(const std::size_t number_images, const int number_rows,
+                const int number_cols, unsigned char* pixels,
+                const std::size_t stride, unsigned char* labels,
+                std::shared_ptr<void> owner = nullptr);
+
+  std::size_t size() const { return number_images_; }
+  bool empty() const { return number_images_ == 0; }
+  int rows() const { return number_rows_; }
+  int cols() const { return number_cols_; }
+
+  /// Number of pixels in each image (rows x cols)
+  std::size_t dimension() const {
+    return static_cast<std::size_t>(number_rows_) * number_cols_;
+  }
+
+  /// Number of bytes between the first pixels of consecutive images
+  std::size_t stride() const { return stride_; }
+
+  unsigned char* ptr(const std::size_t idx) { return pixels_ + idx * stride_; }
+  const unsigned char* ptr(const std::size_t idx) const {
+    return pixels_ + idx * stride_;
+  }
+
+  bool has_labels() const { return labels_ != nullptr; }
+  unsigned char* labels() { return labels_; }
+  const unsigned char* labels() const { return labels_; }
+  unsigned char label(const std::size_t idx) const { return labels_[idx]; }
+
+  /** A non-owning CV_8UC1 header onto one of the packed images (valid only
+   *  as long as this data set, or a copy of it, is alive)
+   */
+  cv::Mat ImageHeader(const std::size_t idx) const;
+
+  /** Copy the labels into a std::vector (e.g. for ConfusionMatrix)
+   */
+  std::vector<unsigned char> LabelVector() const;
+
+  /** Compute the per-image summary statistics listed below from the
+   *  current pixels.  The data set readers call this once when the data
+   *  set is loaded; call it again after modifying pixels through ptr().
+   */
+  void ComputeStatistics();
+
+  /** Attach externally stored statistics (e.g. precomputed in a model
+   *  file) instead of computing them
+   *
+   *  \param[in] squared_norms  number_images squared L2 norms
+   *  \param[in] pixel_sums     number_images pixel sums
+   *  \param[in] row_sums       number_images x number_rows row sums
+   *  \param[in] owner          optional handle that keeps them alive
+   */
+  void SetStatistics(const std::uint32_t* squared_norms,
+                     const std::uint32_t* pixel_sums,
+                     const std::uint32_t* row_sums,
+                     std::shared_ptr<void> owner = nullptr);
+
+  bool has_statistics() const { return squared_norms_ != nullptr; }
+
+  /// sum(pixel^2) of every image (nullptr until statistics are computed;
+  /// wrapped around beyond kMaximumNormDimension pixels)
+  const std::uint32_t* squared_norms() const { return squared_norms_; }
+
+  /// sum(pixel) of every image, i.e. its L1 norm
+  const std::uint32_t* pixel_sums() const { return pixel_sums_; }
+
+  /// sum(pixel) of every row of one image (rows() values per image)
+  const std::uint32_t* row_sums(const std::size_t idx) const {
+    return row_sums_ + idx * number_rows_;
+  }
+
+ private:
+  std::size_t number_images_ = 0;
+  int number_rows_ = 0;
+  int number_cols_ = 0;
+  std::size_t stride_ = 0;
+  unsigned char* pixels_ = nullptr;
+  unsigned char* labels_ = nullptr;
+  std::shared_ptr<void> storage_;
+
+  const std::uint32_t* squared_norms_ = nullptr;
+  const std::uint32_t* pixel_sums_ = nullptr;
+  const std::uint32_t* row_sums_ = nullptr;
+  std::shared_ptr<void> statistics_storage_;
+};
+
+/** Pack a vector of images (and optionally their labels) into a single
+ *  contiguous data set
+ *
+ *  \param[in] images  vector of CV_8UC1 images, all of the same size
+ *  \param[in] labels  vector containing the enumerated label of each image,
+ *                     or an empty vector for unlabeled data [default is
+ *                     empty]
+ *  \return            the packed data set with its statistics computed
+ *                     (empty if the images are not all CV_8UC1 of one
+ *                     size, or the label count does not match the image
+ *                     count)
+ */
+PackedDataset PackImages(const std::vector<cv::Mat>& images,
+                         const std::vector<unsigned char>& labels = {});
+
+/** Copy a subset of the images (and labels) of a data set into a new one
+ *
+ *  \param[in] dataset  packed data set
+ *  \param[in] indices  indices of the images to copy, in the order they are
+ *                      to appear in the new data set
+ *  \return             the packed subset with its statistics computed
+ */
+PackedDataset SelectImages(const PackedDataset& dataset,
+                           const std::vector<std::size_t>& indices);
+
+/** A contiguous range of the images of a data set, sharing (not copying)
+ *  its pixels, labels and statistics
+ *
+ *  \param[in] dataset  packed data set
+ *  \param[in] begin    index of the first image of the range
+ *  \param[in] count    number of images in the range (begin + count must
+ *                      not exceed dataset.size())
+ *  \return             the range as a data set of its own, keeping the
+ *                      memory of dataset alive
+ */
+PackedDataset SliceImages(const PackedDataset& dataset,
+                          const std::size_t begin, const std::size_t count);
+}
@@ -0,0 +1,95 @@
+/** Implementation file for reading MNIST-format (IDX) image and label data
+ *  directly into a packed data set.
+ *
+ *  \file statistics/data_readers/ReadMnistDataset.cpp
+ *  \date 17 Oct 2026
+ */
+
+#include "imgs/statistics/data_readers/ReadMnistDataset.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+#include "imgs/statistics/data_readers/CompressedIdxFile.h"
+#include "imgs/statistics/data_readers/MappedIdxFile.h"
+
+namespace statistics {
+
+PackedDataset ReadMnistDataset(const std::string images_filename,
+                               const std::string labels_filename) {
+  // Compressed images decode chunk by chunk, in parallel, straight into
+  // the rows of the packed buffer
+  PackedDataset dataset;
+  if (IsCompressedIdxFile(images_filename)) {
+    CompressedIdxFile images_file(images_filename, 3);
+    if (images_file.empty()) {
+      std::cerr << "Unable to open MNIST images file: " << images_filename
+                << std::endl;
+      exit(EXIT_FAILURE);
+    }
+    dataset = PackedDataset(images_file.size(), images_file.rows(),
+                            images_file.cols());
+    if (!images_file.Decode(dataset.ptr(0), dataset.stride())) {
+      exit(EXIT_FAILURE);
+    }
+  } else {
+    // Map images file
+    MappedIdxFile images_file(images_filename, 3);
+    if (images_file.empty()) {
+      // Report error and terminate if file does not exist or is not IDX
+      // images
+      std::cerr << "Unable to open MNIST images file: " << images_filename
+                << std::endl;
+      exit(EXIT_FAILURE);
+    }
+
+    // Copy each image straight from the mapping into its row of the packed
+    // buffer
+    dataset = PackedDataset(images_file.size(), images_file.rows(),
+                            images_file.cols());
+    for (std::size_t i = 0; i < dataset.size(); ++i) {
+      std::memcpy(dataset.ptr(i), images_file.ptr(i), dataset.dimension());
+    }
+  }
+  dataset.ComputeStatistics();
+
+  if (labels_filename.empty()) {
+    return dataset;
+  }
+
+  // Compressed or mapped labels file
+  if (IsCompressedIdxFile(labels_filename)) {
+    CompressedIdxFile labels_file(labels_filename, 1);
+    if (labels_file.empty()) {
+      std::cerr << "Unable to open MNIST labels file: " << labels_filename
+                << std::endl;
+      exit(EXIT_FAILURE);
+    }
+    if (labels_file.size() != dataset.size()) {
+      std::cerr << "MNIST images and labels size mismatch!" << std::endl;
+      exit(EXIT_FAILURE);
+    }
+    if (!labels_file.Decode(dataset.labels(), 1)) {
+      exit(EXIT_FAILURE);
+    }
+    return dataset;
+  }
+  MappedIdxFile labels_file(labels_filename, 1);
+  if (labels_file.empty()) {
+    std::cerr << "Unable to open MNIST labels file: " << labels_filename
+              << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  if (labels_file.size() != dataset.size()) {
+    std::cerr << "MNIST images and labels size mismatch!" << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  // Copy labels
+  std::memcpy(dataset.labels(), labels_file.data(), labels_file.size());
+
+  // Return the packed data set
+  return dataset;
+}
+}
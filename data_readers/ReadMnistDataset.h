@@ -0,0 +1,33 @@
+/** Interface file for reading MNIST-format (IDX) image and label data
+ *  directly into a packed data set.  Either the training or test data may
+ *  be read with this function, and either file may be IDX or a run-length
+ *  compressed container (see CompressedIdxFile.h), detected from its first
+ *  bytes.
+ *
+ *  \file statistics/data_readers/ReadMnistDataset.h
+ *  \date 17 Oct 2026
+ */
+
+#pragma once
+
+#include <string>
+
+#include "imgs/statistics/data_readers/PackedDataset.h"
+
+namespace statistics {
+
+/** Read the MNIST images and labels into one packed data set
+ *
+ *  \param[in] images_filename  std::string containing the name of the file
+ *                              containing the image data to be ingested
+ *  \param[in] labels_filename  std::string containing the name of the file
+ *                              containing the label data to be ingested
+ *                              (an empty string reads unlabeled images)
+ *                              [default is empty]
+ *  \return                     the packed data set holding every image (and
+ *                              label) in the ingested MNIST data set, with
+ *                              its per-image statistics already computed
+ */
+PackedDataset ReadMnistDataset(const std::string images_filename,
+                               const std::string labels_filename = "");
+}
@@ -8,59 +8,58 @@
 
 #include "imgs/statistics/data_readers/ReadMnistImages.h"
 
+#include <cstdlib>
 #include <iostream>
-#include <fstream>
+
+#include "imgs/statistics/data_readers/CompressedIdxFile.h"
+#include "imgs/statistics/data_readers/MappedIdxFile.h"
 
 namespace statistics {
 
 std::vector<cv::Mat> ReadMnistImages(const std::string filename) {
-  // Open images file
-  std::ifstream file(filename, std::ios::binary);
-
-  if (file.is_open()) {
-    // Read magic number
-    int magic_number = 0;
-    file.read(reinterpret_cast<char*>(&magic_number), sizeof(magic_number));
-    magic_number = __builtin_bswap32(magic_number);
-
-    // Read number of images
-    int number_images = 0;
-    file.read(reinterpret_cast<char*>(&number_images), sizeof(number_images));
-    number_images = __builtin_bswap32(number_images);
-
-    // Read number of rows in each image
-    int number_rows = 0;
-    file.read(reinterpret_cast<char*>(&number_rows), sizeof(number_rows));
-    number_rows = __builtin_bswap32(number_rows);
-
-    // Read number of columns in each image
-    int number_cols = 0;
-    file.read(reinterpret_cast<char*>(&number_cols), sizeof(number_cols));
-    number_cols = __builtin_bswap32(number_cols);
-
-    // Read images
+  // Compressed images decode into one matrix, shared as for a mapped file
+  if (IsCompressedIdxFile(filename)) {
+    CompressedIdxFile file(filename, 3);
+    cv::Mat pixels;
+    if (!file.empty()) {
+      pixels = cv::Mat(static_cast<int>(file.size() * file.rows()),
+                       file.cols(), CV_8UC1);
+    }
+    if (file.empty() || !file.Decode(pixels.data, file.item_bytes())) {
+      std::cerr << "Unable to open MNIST images file: " << filename
+                << std::endl;
+      exit(EXIT_FAILURE);
+    }
     std::vector<cv::Mat> images;
-    for (int i = 0; i < number_images; ++i) {
-      cv::Mat tp = cv::Mat::zeros(number_rows, number_cols, CV_8UC1);
-      for (int r = 0; r < number_rows; ++r) {
-        for (int c = 0; c < number_cols; ++c) {
-          unsigned char temp = 0;
-          file.read((char*)&temp, sizeof(temp));
-          tp.at<uchar>(r, c) = (int)temp;
-        }
-      }
-      images.push_back(tp);
+    images.reserve(file.size());
+    for (std::size_t i = 0; i < file.size(); ++i) {
+      images.push_back(
+          pixels.rowRange(static_cast<int>(i * file.rows()),
+                          static_cast<int>((i + 1) * file.rows())));
     }
-
-    // Close images file
-    file.close();
-
-    // Return the vector of images
     return (images);
-  } else {
-    // Report error and terminate if file does not exist or could not be opened
+  }
+
+  // Map images file
+  MappedIdxFile file(filename, 3);
+  if (file.empty()) {
+    // Report error and terminate if file does not exist or is not IDX images
     std::cerr << "Unable to open MNIST images file: " << filename << std::endl;
     exit(EXIT_FAILURE);
   }
+
+  // Copy all of the images at once into one matrix, and return each as a
+  // (continuous) band of its rows that shares it
+  cv::Mat pixels = file.ImagesHeader().clone();
+  std::vector<cv::Mat> images;
+  images.reserve(file.size());
+  for (std::size_t i = 0; i < file.size(); ++i) {
+    images.push_back(
+        pixels.rowRange(static_cast<int>(i * file.rows()),
+                        static_cast<int>((i + 1) * file.rows())));
+  }
+
+  // Return the vector of images
+  return (images);
 }
 }
@@ -8,39 +8,36 @@
 
 #include "imgs/statistics/data_readers/ReadMnistLabels.h"
 
+#include <cstdlib>
 #include <iostream>
-#include <fstream>
+
+#include "imgs/statistics/data_readers/CompressedIdxFile.h"
+#include "imgs/statistics/data_readers/MappedIdxFile.h"
 
 namespace statistics {
 
 std::vector<unsigned char> ReadMnistLabels(const std::string filename) {
-  // Open labels file
-  std::ifstream file(filename, std::ios::binary);
-
-  if (file.is_open()) {
-    // Read magic number
-    int magic_number = 0;
-    file.read(reinterpret_cast<char*>(&magic_number), sizeof(magic_number));
-    magic_number = __builtin_bswap32(magic_number);
-
-    // Read number of labels
-    int number_labels = 0;
-    file.read(reinterpret_cast<char*>(&number_labels), sizeof(number_labels));
-    number_labels = __builtin_bswap32(number_labels);
-
-    // Read labels
-    std::vector<unsigned char> labels(number_labels);
-    file.read(reinterpret_cast<char*>(labels.data()), number_labels);
-
-    // Close labels file
-    file.close();
-
-    // Return the vector of labels
+  // Compressed labels decode chunk by chunk
+  if (IsCompressedIdxFile(filename)) {
+    CompressedIdxFile file(filename, 1);
+    std::vector<unsigned char> labels(file.size());
+    if (file.empty() || !file.Decode(labels.data(), 1)) {
+      std::cerr << "Unable to open MNIST labels file: " << filename
+                << std::endl;
+      exit(EXIT_FAILURE);
+    }
     return (labels);
-  } else {
-    // Report error and terminate if file does not exist or could not be opened
+  }
+
+  // Map labels file
+  MappedIdxFile file(filename, 1);
+  if (file.empty()) {
+    // Report error and terminate if file does not exist or is not IDX labels
     std::cerr << "Unable to open MNIST labels file: " << filename << std::endl;
     exit(EXIT_FAILURE);
   }
+
+  // Return the vector of labels
+  return std::vector<unsigned char>(file.data(), file.data() + file.size());
 }
 }
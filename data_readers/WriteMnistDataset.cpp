@@ -0,0 +1,86 @@
+/** Implementation file for writing a packed data set as MNIST-format (IDX)
+ *  image and label files.
+ *
+ *  \file statistics/data_readers/WriteMnistDataset.cpp
+ *  \date 17 Oct 2026
+ */
+
+#include "imgs/statistics/data_readers/WriteMnistDataset.h"
+
+#include <fstream>
+#include <iostream>
+
+namespace statistics {
+
+namespace {
+
+// IDX magic numbers: unsigned byte data of three and of one dimension
+constexpr int kImagesMagic = 0x00000803;
+constexpr int kLabelsMagic = 0x00000801;
+
+// Write one big-endian 32-bit header field
+void WriteHeaderField(std::ofstream& file, const int value) {
+  const int swapped = __builtin_bswap32(value);
+  file.write(reinterpret_cast<const char*>(&swapped), sizeof(swapped));
+}
+
+}  // namespace
+
+bool WriteMnistDataset(const std::string images_filename,
+                       const std::string labels_filename,
+                       const PackedDataset& dataset) {
+  // Open images file
+  std::ofstream images_file(images_filename, std::ios::binary);
+  if (!images_file.is_open()) {
+    std::cerr << "Unable to open MNIST images file for writing: "
+              << images_filename << std::endl;
+    return false;
+  }
+
+  // Write magic number, number of images, and the image geometry, then
+  // each image without its row padding
+  const int number_images = static_cast<int>(dataset.size());
+  WriteHeaderField(images_file, kImagesMagic);
+  WriteHeaderField(images_file, number_images);
+  WriteHeaderField(images_file, dataset.rows());
+  WriteHeaderField(images_file, dataset.cols());
+  for (int i = 0; i < number_images; ++i) {
+    images_file.write(reinterpret_cast<const char*>(dataset.ptr(i)),
+                      dataset.dimension());
+  }
+  if (!images_file) {
+    std::cerr << "Error writing MNIST images file: " << images_filename
+              << std::endl;
+    return false;
+  }
+  images_file.close();
+
+  if (labels_filename.empty()) {
+    return true;
+  }
+  if (!dataset.has_labels()) {
+    std::cerr << "No labels to write to: " << labels_filename << std::endl;
+    return false;
+  }
+
+  // Open labels file
+  std::ofstream labels_file(labels_filename, std::ios::binary);
+  if (!labels_file.is_open()) {
+    std::cerr << "Unable to open MNIST labels file for writing: "
+              << labels_filename << std::endl;
+    return false;
+  }
+
+  // Write magic number, number of labels, and the labels
+  WriteHeaderField(labels_file, kLabelsMagic);
+  WriteHeaderField(labels_file, number_images);
+  labels_file.write(reinterpret_cast<const char*>(dataset.labels()),
+                    number_images);
+  if (!labels_file) {
+    std::cerr << "Error writing MNIST labels file: " << labels_filename
+              << std::endl;
+    return false;
+  }
+  return true;
+}
+}
@@ -0,0 +1,30 @@
+/** Interface file for writing a packed data set as MNIST-format (IDX)
+ *  image and label files, readable again with ReadMnistDataset() and
+ *  ReadMnistImages()/ReadMnistLabels().
+ *
+ *  \file statistics/data_readers/WriteMnistDataset.h
+ *  \date 17 Oct 2026
+ */
+
+#pragma once
+
+#include <string>
+
+#include "imgs/statistics/data_readers/PackedDataset.h"
+
+namespace statistics {
+
+/** Write the images and labels of a packed data set
+ *
+ *  \param[in] images_filename  std::string containing the name of the file
+ *                              to (over)write with the image data
+ *  \param[in] labels_filename  std::string containing the name of the file
+ *                              to (over)write with the label data (an empty
+ *                              string writes the images only)
+ *  \param[in] dataset          the packed data set to write
+ *  \return                     whether every file was written completely
+ */
+bool WriteMnistDataset(const std::string images_filename,
+                       const std::string labels_filename,
+                       const PackedDataset& dataset);
+}
@@ -16,22 +16,23 @@
 
 namespace statistics {
 
-void ConfusionMatrix(const std::vector<unsigned char>& truth_labels,
-                     const std::vector<unsigned char>& predicted_labels,
-                     const unsigned char ascii_offset_for_labels) {
+cv::Mat ConfusionCounts(const std::vector<unsigned char>& truth_labels,
+                        const std::vector<unsigned char>& predicted_labels,
+                        const std::size_t minimum_number_of_labels) {
   // Determine the number of labels in the data set, set it to the maximum label
   // enumeration in either the truth or predicted label vector
-  auto it_truth_labels =
-      std::max_element(truth_labels.begin(), truth_labels.end());
-  auto number_of_truth_labels = *it_truth_labels + 1;
-  auto it_predicted_labels =
-      std::max_element(predicted_labels.begin(), predicted_labels.end());
-  auto number_of_predicted_labels = *it_predicted_labels + 1;
-
-  std::size_t number_of_labels =
-      (number_of_truth_labels > number_of_predicted_labels)
-          ? number_of_truth_labels
-          : number_of_predicted_labels;
+  std::size_t number_of_labels = minimum_number_of_labels;
+  if (!truth_labels.empty()) {
+    number_of_labels = std::max<std::size_t>(
+        number_of_labels,
+        *std::max_element(truth_labels.begin(), truth_labels.end()) + 1);
+  }
+  if (!predicted_labels.empty()) {
+    number_of_labels = std::max<std::size_t>(
+        number_of_labels,
+        *std::max_element(predicted_labels.begin(), predicted_labels.end()) +
+            1);
+  }
 
   // Compute the confusion matrix
   cv::Mat confusion_matrix =
@@ -39,6 +40,19 @@ void ConfusionMatrix(const std::vector<unsigned char>& truth_labels,
   for (std::size_t idx = 0; idx < predicted_labels.size(); idx++) {
     confusion_matrix.at<double>(truth_labels[idx], predicted_labels[idx])++;
   }
+  return confusion_matrix;
+}
+
+void ConfusionMatrix(const std::vector<unsigned char>& truth_labels,
+                     const std::vector<unsigned char>& predicted_labels,
+                     const unsigned char ascii_offset_for_labels) {
+  PrintConfusionMatrix(ConfusionCounts(truth_labels, predicted_labels),
+                       ascii_offset_for_labels);
+}
+
+void PrintConfusionMatrix(const cv::Mat& confusion_matrix,
+                          const unsigned char ascii_offset_for_labels) {
+  std::size_t number_of_labels = confusion_matrix.rows;
 
   // Print the confusion matrix to the standard output
 
@@ -8,8 +8,11 @@
 
 #pragma once
 
+#include <cstddef>
 #include <vector>
 
+#include <opencv2/opencv.hpp>
+
 namespace statistics {
 
 /** Perform k-NN classification
@@ -28,4 +31,34 @@ namespace statistics {
 void ConfusionMatrix(const std::vector<unsigned char>& truth_labels,
                      const std::vector<unsigned char>& predicted_labels,
                      const unsigned char ascii_offset_for_labels = 0);
+
+/** Count a set of truth and predicted class labels into a confusion matrix
+ *  (e.g. to sum those of several cross-validation folds before printing)
+ *
+ *  \param[in] truth_labels              vector containing the enumerated
+ *                                        truth labels
+ *  \param[in] predicted_labels          vector containing the enumerated
+ *                                        predicted labels
+ *  \param[in] minimum_number_of_labels  least number of rows and columns,
+ *                                        so that matrices of several label
+ *                                        sets have the same size [default
+ *                                        is 0]
+ *  \return                              CV_64F matrix of counts, truth
+ *                                        labels down and predicted labels
+ *                                        across
+ */
+cv::Mat ConfusionCounts(const std::vector<unsigned char>& truth_labels,
+                        const std::vector<unsigned char>& predicted_labels,
+                        const std::size_t minimum_number_of_labels = 0);
+
+/** Display a confusion matrix of counts and its classification accuracy
+ *
+ *  \param[in] confusion_matrix         CV_64F matrix of counts (as from
+ *                                      ConfusionCounts())
+ *  \param[in] ascii_offset_for_labels  additive offset for the label
+ *                                      enumerations, as for
+ *                                      ConfusionMatrix() [default is 0]
+ */
+void PrintConfusionMatrix(const cv::Mat& confusion_matrix,
+                          const unsigned char ascii_offset_for_labels = 0);
 }
@@ -0,0 +1,170 @@
+/** Implementation file for stratified k-fold cross-validation of the k-NN
+ *  classifier.
+ *
+ *  \file statistics/evaluators/CrossValidation.cpp
+ *  \date 17 Oct 2026
+ */
+
+#include "imgs/statistics/evaluators/CrossValidation.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <iostream>
+#include <random>
+
+#include "imgs/statistics/classifiers/KnnClassifier.h"
+#include "imgs/statistics/classifiers/PrunedSearch.h"
+#include "imgs/statistics/evaluators/ConfusionMatrix.h"
+#include "imgs/statistics/parallel/ThreadPool.h"
+
+namespace statistics {
+
+std::vector<int> StratifiedFolds(const PackedDataset& dataset,
+                                 const int number_folds,
+                                 const unsigned int seed) {
+  std::array<std::vector<std::size_t>, 256> classes;
+  for (std::size_t idx = 0; idx < dataset.size(); ++idx) {
+    classes[dataset.label(idx)].push_back(idx);
+  }
+
+  // Deal each class in turn, continuing from the fold where the previous
+  // class stopped so that the fold sizes also stay within one image
+  std::vector<int> folds(dataset.size(), 0);
+  std::mt19937 generator(seed);
+  int fold = 0;
+  for (auto& members : classes) {
+    if (seed != 0) {
+      std::shuffle(members.begin(), members.end(), generator);
+    }
+    for (const std::size_t idx : members) {
+      folds[idx] = fold;
+      fold = (fold + 1) % number_folds;
+    }
+  }
+  return folds;
+}
+
+CrossValidationResult CrossValidateKnn(const PackedDataset& dataset,
+                                       const int number_folds, const int k,
+                                       const double p,
+                                       const KnnOptions& options,
+                                       const unsigned int seed) {
+  if (!dataset.has_labels()) {
+    std::cerr << "Cross-validation requires labeled images!" << std::endl;
+    return {};
+  }
+  if (number_folds < 2 ||
+      static_cast<std::size_t>(number_folds) > dataset.size()) {
+    std::cerr << "The number of folds must be between 2 and the number of "
+              << "images!" << std::endl;
+    return {};
+  }
+
+  using Clock = std::chrono::steady_clock;
+  auto start = Clock::now();
+
+  // Pack the images fold after fold, then all but the last fold again:
+  // the training images of fold f (folds f + 1, ..., and around to f - 1)
+  // start where fold f + 1 does and are contiguous
+  const std::vector<int> folds = StratifiedFolds(dataset, number_folds, seed);
+  std::vector<std::size_t> fold_sizes(number_folds, 0);
+  std::vector<std::vector<std::size_t>> members(number_folds);
+  for (std::size_t idx = 0; idx < dataset.size(); ++idx) {
+    members[folds[idx]].push_back(idx);
+    ++fold_sizes[folds[idx]];
+  }
+  std::vector<std::size_t> order;
+  order.reserve(2 * dataset.size());
+  std::vector<std::size_t> fold_begins(number_folds + 1, 0);
+  for (int f = 0; f < number_folds; ++f) {
+    fold_begins[f] = order.size();
+    order.insert(order.end(), members[f].begin(), members[f].end());
+  }
+  fold_begins[number_folds] = order.size();
+  for (int f = 0; f + 1 < number_folds; ++f) {
+    order.insert(order.end(), members[f].begin(), members[f].end());
+  }
+  const PackedDataset packed = SelectImages(dataset, order);
+
+  CrossValidationResult result;
+  result.pack_seconds =
+      std::chrono::duration<double>(Clock::now() - start).count();
+  start = Clock::now();
+
+  // The folds in parallel, sharing the threads out among them
+  const unsigned int number_threads = (options.number_threads == 0)
+                                          ? ThreadPool::HardwareThreads()
+                                          : options.number_threads;
+  const unsigned int fold_workers =
+      std::min<unsigned int>(number_threads, number_folds);
+  KnnOptions fold_options = options;
+  fold_options.number_threads = std::max(1u, number_threads / fold_workers);
+
+  const std::size_t number_labels =
+      *std::max_element(dataset.labels(), dataset.labels() + dataset.size()) +
+      1;
+  result.fold_accuracies.resize(number_folds);
+  result.fold_confusions.resize(number_folds);
+  std::vector<KnnStatistics> fold_statistics(number_folds);
+
+  ThreadPool pool(fold_workers);
+  pool.ParallelFor(0, number_folds, 1,
+                   [&](std::size_t begin, std::size_t end, unsigned int) {
+                     for (std::size_t f = begin; f < end; ++f) {
+                       const PackedDataset test_images = SliceImages(
+                           packed, fold_begins[f], fold_sizes[f]);
+                       const PackedDataset training_images = SliceImages(
+                           packed, fold_begins[f + 1],
+                           dataset.size() - fold_sizes[f]);
+
+                       KnnOptions search_options = fold_options;
+                       search_options.statistics =
+                           (options.statistics != nullptr)
+                               ? &fold_statistics[f]
+                               : nullptr;
+                       KnnClassifier classifier(k, p, search_options);
+                       if (!classifier.Fit(training_images)) {
+                         continue;
+                       }
+                       const std::vector<unsigned char> labels =
+                           classifier.PredictBatch(test_images);
+                       result.fold_confusions[f] = ConfusionCounts(
+                           test_images.LabelVector(), labels, number_labels);
+                       result.fold_accuracies[f] =
+                           cv::trace(result.fold_confusions[f])[0] /
+                           test_images.size();
+                     }
+                   });
+
+  result.classify_seconds =
+      std::chrono::duration<double>(Clock::now() - start).count();
+
+  // A fold whose classifier could not be fitted (k larger than its training
+  // set) invalidates the whole cross-validation
+  for (const auto& confusion : result.fold_confusions) {
+    if (confusion.empty()) {
+      return {};
+    }
+  }
+
+  // Merge the folds
+  result.confusion = cv::Mat::zeros(static_cast<int>(number_labels),
+                                    static_cast<int>(number_labels), CV_64F);
+  for (int f = 0; f < number_folds; ++f) {
+    result.confusion += result.fold_confusions[f];
+    result.mean_accuracy += result.fold_accuracies[f];
+    if (options.statistics != nullptr) {
+      options.statistics->Add(fold_statistics[f]);
+    }
+  }
+  result.mean_accuracy /= number_folds;
+  for (const double accuracy : result.fold_accuracies) {
+    result.accuracy_variance += (accuracy - result.mean_accuracy) *
+                                (accuracy - result.mean_accuracy);
+  }
+  result.accuracy_variance /= (number_folds - 1);
+
+  return result;
+}
+}
@@ -0,0 +1,88 @@
+/** Interface file for stratified k-fold cross-validation of the k-NN
+ *  classifier over a labeled data set.
+ *
+ *  The images of each class are dealt to the folds in turn, so that every
+ *  fold holds (to within one image) the same share of every class.  The
+ *  data set is then packed once in fold order, followed by a second copy of
+ *  all but its last fold, so that the training images of any fold (all of
+ *  the other folds) are one contiguous range of that buffer.  Every fold's
+ *  test and training sets are therefore views onto the same packed pixels
+ *  and precomputed statistics, and no fold copies any images.
+ *
+ *  The folds are classified in parallel, each by its own KnnClassifier, and
+ *  their confusion matrices are summed into one for the whole data set.
+ *
+ *  \file statistics/evaluators/CrossValidation.h
+ *  \date 17 Oct 2026
+ */
+
+#pragma once
+
+#include <vector>
+
+#include <opencv2/opencv.hpp>
+
+#include "imgs/statistics/classifiers/Knn.h"
+#include "imgs/statistics/data_readers/PackedDataset.h"
+
+namespace statistics {
+
+/** Outcome of a cross-validation
+ */
+struct CrossValidationResult {
+  /// Fraction of each fold's images classified correctly
+  std::vector<double> fold_accuracies;
+
+  /// Confusion matrix (CV_64F counts) of each fold, and their sum
+  std::vector<cv::Mat> fold_confusions;
+  cv::Mat confusion;
+
+  /// Mean of the fold accuracies, and their (unbiased) sample variance
+  double mean_accuracy = 0;
+  double accuracy_variance = 0;
+
+  /// Wall time of packing the folds and of classifying them
+  double pack_seconds = 0;
+  double classify_seconds = 0;
+
+  bool empty() const { return fold_accuracies.empty(); }
+};
+
+/** Assign the images of a labeled data set to stratified folds
+ *
+ *  \param[in] dataset       labeled packed data set
+ *  \param[in] number_folds  number of folds (at least 2)
+ *  \param[in] seed          seed of the shuffle of each class's images
+ *                           before they are dealt (0 deals them in data
+ *                           set order) [default is 0]
+ *  \return                  the fold of each image
+ */
+std::vector<int> StratifiedFolds(const PackedDataset& dataset,
+                                 const int number_folds,
+                                 const unsigned int seed = 0);
+
+/** Cross-validate the k-NN classifier
+ *
+ *  \param[in] dataset       labeled packed data set (e.g. any IDX image
+ *                           and label file pair)
+ *  \param[in] number_folds  number of folds (between 2 and the number of
+ *                           images) [default is 10]
+ *  \param[in] k             the number of neighbors to be considered in
+ *                           the majority vote [default is 1]
+ *  \param[in] p             the order of the Minkowski distance [default
+ *                           is 2]
+ *  \param[in] options       search options of each fold's classifier; the
+ *                           threads (0 for one per hardware thread) are
+ *                           shared out among the folds, which run in
+ *                           parallel [default is serial]
+ *  \param[in] seed          seed of the fold assignment, as for
+ *                           StratifiedFolds() [default is 0]
+ *  \return                  per-fold and merged results (empty, with a
+ *                           message, if the data set or parameters are
+ *                           invalid)
+ */
+CrossValidationResult CrossValidateKnn(
+    const PackedDataset& dataset, const int number_folds = 10, const int k = 1,
+    const double p = 2, const KnnOptions& options = KnnOptions(),
+    const unsigned int seed = 0);
+}
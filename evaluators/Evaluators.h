@@ -8,3 +8,4 @@
 #pragma once
 
 #include "imgs/statistics/evaluators/ConfusionMatrix.h"
+#include "imgs/statistics/evaluators/CrossValidation.h"
@@ -9,6 +9,7 @@
  */
 
 #include "knn_functions.h"
+#include <cstdint> // UINT64_MAX
 
 using namespace std;
 namespace acc = boost::accumulators;
@@ -390,9 +391,28 @@ double MinkowskiDistance(const cv::Mat& test_image, const cv::Mat& training_imag
         const uchar* test_ptr = test_image.ptr<uchar>();
         const uchar* training_ptr = training_image.ptr<uchar>();
         int total_pixels = test_image.total();
+
+        // Largest possible |d|^p, to check the integer sum cannot overflow
+        uint64_t largest_term = 1;
+        for (int e = 0; e < p && e < 6; ++e) largest_term *= 255;
+
+        if (p <= 6 && static_cast<uint64_t>(total_pixels) <= UINT64_MAX / largest_term) {
+            // |d|^p as an exact integer, no std::pow per pixel
+            // (255^6 * 28*28 still fits in 64 bits; larger images whose sum
+            // could overflow take the double sum below)
+            uint64_t sum = 0;
+            for (int i = 0; i < total_pixels; ++i) {
+                uint64_t diff = std::abs(test_ptr[i] - training_ptr[i]);
+                uint64_t term = diff;
+                for (int e = 1; e < p; ++e) term *= diff;
+                sum += term;
+            }
+            distance = static_cast<double>(sum);
+        } else {
             for (int i = 0; i < total_pixels; ++i) {
                 distance += std::pow(std::abs(test_ptr[i] - training_ptr[i]), p);
             }
+        }
         return std::pow(distance, 1.0 / p);
     }
     
@@ -9,6 +9,7 @@
  */
 
 #include "../knn_functions.h"
+#include "imgs/statistics/data_readers/ImageDirectoryLoader.h"
 
 using namespace std;
 namespace fs = std::filesystem;
@@ -33,31 +34,15 @@ int main(int argc, char* argv[]) {
         }
     } 
 
-    // #######################################
-    // %% Read in RGB Images from Directory %%
-    // #######################################
+    // ########################################
+    // %% Stream Plate Images from Directory %%
+    // ########################################
 
+    // Each file is decoded once, straight to gray, in parallel and ahead of
+    // the labeling
     string plate_directory = "../imgs/statistics/labeling/license_plates";
-    std::vector<cv::Mat> license_plates;
-    std::vector<std::string> image_filenames;
-
-    // Iterate through all files in the folder
-    for (const auto& entry : fs::directory_iterator(plate_directory)) {
-        if (entry.is_regular_file()) {
-            std::string file_path = entry.path().string();
-
-            // Attempt to load the image
-            cv::Mat img = cv::imread(file_path, cv::IMREAD_GRAYSCALE);
-
-            if (!img.empty()) {
-                license_plates.push_back(img);
-                image_filenames.push_back(file_path);
-                std::cout << "Loaded: " << file_path << std::endl;
-            } else {
-                std::cerr << "Failed to load: " << file_path << std::endl;
-            }
-        }
-    }
+    statistics::ImageDirectoryLoader loader(plate_directory);
+    statistics::LoadedImage loaded;
 
 
     // #######################################
@@ -65,11 +50,13 @@ int main(int argc, char* argv[]) {
     // #######################################
 
     int input_key;
-    for (size_t i = 0; i < license_plates.size(); ++i) {
+    while (loader.Next(loaded)) {
+        const size_t i = loaded.index;
+        std::cout << "Loaded: " << loaded.filename << std::endl;
         cout << "Current plate #: " << i << endl;
 
         // Segment out characters to labeled
-        cv::Mat plate = license_plates[i];
+        cv::Mat plate = loaded.gray;
         vector<cv::Mat> segmented_characters = AutoExtractCharacters(plate);
 
         // Display the character image
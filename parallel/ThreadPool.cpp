@@ -0,0 +1,145 @@
+/** Implementation file for a fixed-size work-stealing thread pool.
+ *
+ *  \file statistics/parallel/ThreadPool.cpp
+ *  \date 17 Oct 2026
+ */
+
+#include "imgs/statistics/parallel/ThreadPool.h"
+
+#include <algorithm>
+
+namespace statistics {
+
+ThreadPool::ThreadPool(unsigned int number_threads) {
+  if (number_threads == 0) {
+    number_threads = HardwareThreads();
+  }
+  number_threads_ = number_threads;
+
+  // One queue per worker; the last one belongs to the calling thread
+  for (unsigned int worker = 0; worker < number_threads_; ++worker) {
+    queues_.push_back(std::make_unique<WorkQueue>());
+  }
+  for (unsigned int worker = 0; worker + 1 < number_threads_; ++worker) {
+    threads_.emplace_back(&ThreadPool::WorkerLoop, this, worker);
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(wake_mutex_);
+    stopping_ = true;
+  }
+  wake_.notify_all();
+  for (auto& thread : threads_) {
+    thread.join();
+  }
+}
+
+unsigned int ThreadPool::HardwareThreads() {
+  unsigned int number_threads = std::thread::hardware_concurrency();
+  return (number_threads > 0) ? number_threads : 1;
+}
+
+void ThreadPool::ParallelFor(
+    const std::size_t begin, const std::size_t end, std::size_t grain,
+    const std::function<void(std::size_t, std::size_t, unsigned int)>&
+        body) {
+  if (begin >= end) {
+    return;
+  }
+  grain = std::max<std::size_t>(grain, 1);
+  const std::size_t number_chunks = (end - begin + grain - 1) / grain;
+  const unsigned int caller = number_threads_ - 1;
+
+  // Nothing to share, run on the calling thread
+  if (number_threads_ == 1 || number_chunks == 1) {
+    for (std::size_t chunk_begin = begin; chunk_begin < end;
+         chunk_begin += grain) {
+      body(chunk_begin, std::min(chunk_begin + grain, end), caller);
+    }
+    return;
+  }
+
+  // Completion is counted under done_mutex so that the last task has
+  // released it before this function can return
+  std::size_t remaining = number_chunks;
+  std::mutex done_mutex;
+  std::condition_variable done;
+
+  // Deal the chunks round-robin onto every worker's queue
+  std::size_t chunk = 0;
+  for (std::size_t chunk_begin = begin; chunk_begin < end;
+       chunk_begin += grain, ++chunk) {
+    std::size_t chunk_end = std::min(chunk_begin + grain, end);
+    WorkQueue& queue = *queues_[chunk % number_threads_];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    queue.tasks.emplace_back([&, chunk_begin, chunk_end](unsigned int worker) {
+      body(chunk_begin, chunk_end, worker);
+      std::lock_guard<std::mutex> done_lock(done_mutex);
+      if (--remaining == 0) {
+        done.notify_all();
+      }
+    });
+  }
+  {
+    std::lock_guard<std::mutex> lock(wake_mutex_);
+    queued_tasks_ += number_chunks;
+  }
+  wake_.notify_all();
+
+  // Work alongside the pool until every queue is empty, then wait for the
+  // chunks still running on other workers
+  Task task;
+  while (PopTask(caller, task)) {
+    task(caller);
+  }
+  std::unique_lock<std::mutex> done_lock(done_mutex);
+  done.wait(done_lock, [&] { return remaining == 0; });
+}
+
+bool ThreadPool::PopTask(const unsigned int worker, Task& task) {
+  // Newest task from the worker's own queue first (it is the most likely
+  // to still be cache resident)
+  {
+    WorkQueue& queue = *queues_[worker];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (!queue.tasks.empty()) {
+      task = std::move(queue.tasks.back());
+      queue.tasks.pop_back();
+      --queued_tasks_;
+      return true;
+    }
+  }
+
+  // Otherwise steal the oldest task of another worker
+  for (unsigned int offset = 1; offset < number_threads_; ++offset) {
+    WorkQueue& queue = *queues_[(worker + offset) % number_threads_];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (!queue.tasks.empty()) {
+      task = std::move(queue.tasks.front());
+      queue.tasks.pop_front();
+      --queued_tasks_;
+      return true;
+    }
+  }
+
+  return false;
+}
+
+void ThreadPool::WorkerLoop(const unsigned int worker) {
+  Task task;
+  while (true) {
+    if (PopTask(worker, task)) {
+      task(worker);
+      continue;
+    }
+
+    std::unique_lock<std::mutex> lock(wake_mutex_);
+    wake_.wait(lock, [&] { return stopping_ || queued_tasks_ > 0; });
+    if (stopping_ && queued_tasks_ == 0) {
+      return;
+    }
+  }
+}
+}
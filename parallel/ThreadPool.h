@@ -0,0 +1,89 @@
+/** Interface file for a fixed-size work-stealing thread pool.  Each worker
+ *  owns a double-ended task queue; it pops work from the back of its own
+ *  queue and, when that runs dry, steals from the front of the others, so
+ *  unevenly sized chunks still keep every core busy.
+ *
+ *  \file statistics/parallel/ThreadPool.h
+ *  \date 17 Oct 2026
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace statistics {
+
+class ThreadPool {
+ public:
+  /// A unit of work; the argument is the index of the worker running it
+  using Task = std::function<void(unsigned int)>;
+
+  /** Start the pool
+   *
+   *  \param[in] number_threads  total number of threads that execute work,
+   *                             including the thread that calls
+   *                             ParallelFor() (0 selects one per hardware
+   *                             thread) [default is 0]
+   */
+  explicit ThreadPool(unsigned int number_threads = 0);
+
+  /** Join all of the worker threads
+   */
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  /** The number of threads that execute work (worker indices passed to a
+   *  task are in the range [0, size()))
+   */
+  unsigned int size() const { return number_threads_; }
+
+  /** Split [begin, end) into chunks of at most grain indices and run body
+   *  on every chunk, returning once all of them have completed.  The
+   *  calling thread takes part in the work as worker size() - 1.  Must not
+   *  be called concurrently from more than one thread.
+   *
+   *  \param[in] begin  first index of the range
+   *  \param[in] end    one past the last index of the range
+   *  \param[in] grain  maximum number of indices per chunk
+   *  \param[in] body   called as body(chunk_begin, chunk_end, worker)
+   */
+  void ParallelFor(
+      const std::size_t begin, const std::size_t end, std::size_t grain,
+      const std::function<void(std::size_t, std::size_t, unsigned int)>&
+          body);
+
+  /** The hardware concurrency, or 1 when it cannot be determined
+   */
+  static unsigned int HardwareThreads();
+
+ private:
+  struct WorkQueue {
+    std::mutex mutex;
+    std::deque<Task> tasks;
+  };
+
+  // Take one task, preferring the back of the worker's own queue
+  bool PopTask(const unsigned int worker, Task& task);
+
+  void WorkerLoop(const unsigned int worker);
+
+  unsigned int number_threads_;
+  std::vector<std::unique_ptr<WorkQueue>> queues_;
+  std::vector<std::thread> threads_;
+
+  std::mutex wake_mutex_;
+  std::condition_variable wake_;
+  std::atomic<std::size_t> queued_tasks_{0};
+  bool stopping_ = false;
+};
+}